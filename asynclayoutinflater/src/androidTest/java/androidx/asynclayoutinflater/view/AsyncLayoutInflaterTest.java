@@ -0,0 +1,256 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.asynclayoutinflater.view;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNotNull;
+import static org.junit.Assert.assertSame;
+import static org.junit.Assert.assertTrue;
+
+import android.os.Looper;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.MediumTest;
+import android.support.test.runner.AndroidJUnit4;
+import android.view.View;
+import android.view.ViewGroup;
+
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
+import androidx.asynclayoutinflater.test.R;
+import androidx.asynclayoutinflater.view.AsyncLayoutInflater.OnInflateFinishedListener;
+import androidx.asynclayoutinflater.view.AsyncLayoutInflater.OnInflateMetricsListener;
+
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+
+@RunWith(AndroidJUnit4.class)
+@MediumTest
+public class AsyncLayoutInflaterTest {
+    private static final long TIMEOUT_MS = 5000;
+
+    private AsyncLayoutInflater mInflater;
+    // Names of the requests whose callback was invoked, in order.
+    private final List<String> mFinished = Collections.synchronizedList(new ArrayList<String>());
+    private final List<Thread> mCallbackThreads =
+            Collections.synchronizedList(new ArrayList<Thread>());
+
+    @Before
+    public void setUp() {
+        runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mInflater = new AsyncLayoutInflater(InstrumentationRegistry.getContext());
+            }
+        });
+    }
+
+    @After
+    public void tearDown() {
+        BlockingView.release();
+    }
+
+    @Test
+    public void testCallbackOnUiThread() throws InterruptedException {
+        final CountDownLatch finished = new CountDownLatch(1);
+        final View[] inflated = new View[1];
+        final int[] inflatedResid = new int[1];
+        runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mInflater.inflate(R.layout.simple_view, null, new OnInflateFinishedListener() {
+                    @Override
+                    public void onInflateFinished(@NonNull View view, int resid,
+                            @Nullable ViewGroup parent) {
+                        inflated[0] = view;
+                        inflatedResid[0] = resid;
+                        mCallbackThreads.add(Thread.currentThread());
+                        finished.countDown();
+                    }
+                });
+            }
+        });
+
+        assertTrue(finished.await(TIMEOUT_MS, TimeUnit.MILLISECONDS));
+        assertNotNull(inflated[0]);
+        assertEquals(R.layout.simple_view, inflatedResid[0]);
+        assertSame(Looper.getMainLooper().getThread(), mCallbackThreads.get(0));
+    }
+
+    @Test
+    public void testInflatesInPriorityOrder() throws InterruptedException {
+        blockInflateThread(record("blocking", null));
+        final CountDownLatch finished = new CountDownLatch(1);
+        runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mInflater.inflate(R.layout.simple_view, null, 0, record("low", null));
+                mInflater.inflate(R.layout.simple_view, null, 1, record("high", null));
+                mInflater.inflate(R.layout.simple_view, null, -1, record("lowest", finished));
+                mInflater.inflate(R.layout.simple_view, null, 1, record("high2", null));
+            }
+        });
+        BlockingView.release();
+
+        assertTrue(finished.await(TIMEOUT_MS, TimeUnit.MILLISECONDS));
+        assertEquals(Arrays.asList("blocking", "high", "high2", "low", "lowest"), mFinished);
+        for (Thread thread : mCallbackThreads) {
+            assertSame(Looper.getMainLooper().getThread(), thread);
+        }
+    }
+
+    @Test
+    public void testCancelBeforeInflation() throws InterruptedException {
+        blockInflateThread(record("blocking", null));
+        final OnInflateFinishedListener cancelled = record("cancelled", null);
+        runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mInflater.inflate(R.layout.simple_view, null, cancelled);
+                mInflater.cancel(cancelled);
+            }
+        });
+        BlockingView.release();
+
+        awaitIdle();
+        assertEquals(Arrays.asList("blocking", "idle"), mFinished);
+    }
+
+    @Test
+    public void testCancelDuringInflation() throws InterruptedException {
+        final OnInflateFinishedListener cancelled = record("cancelled", null);
+        blockInflateThread(cancelled);
+        runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mInflater.cancel(cancelled);
+            }
+        });
+        BlockingView.release();
+
+        awaitIdle();
+        assertEquals(Collections.singletonList("idle"), mFinished);
+    }
+
+    @Test
+    public void testCancelAll() throws InterruptedException {
+        blockInflateThread(record("blocking", null));
+        runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mInflater.inflate(R.layout.simple_view, null, record("pending", null));
+                mInflater.inflate(R.layout.simple_view, null, 1, record("pending2", null));
+                mInflater.cancelAll();
+            }
+        });
+        BlockingView.release();
+
+        awaitIdle();
+        assertEquals(Collections.singletonList("idle"), mFinished);
+    }
+
+    @Test
+    public void testMetricsReportedBeforeCallback() throws InterruptedException {
+        blockInflateThread(record("blocking", null));
+        final CountDownLatch finished = new CountDownLatch(1);
+        final long[] queueTime = new long[1];
+        final boolean[] inflatedOnUiThread = new boolean[1];
+        runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mInflater.setOnInflateMetricsListener(new OnInflateMetricsListener() {
+                    @Override
+                    public void onInflateMetrics(int resid, long queueTimeMs, long inflateTimeMs,
+                            boolean onUiThread) {
+                        if (resid == R.layout.simple_view) {
+                            mFinished.add("metrics");
+                            queueTime[0] = queueTimeMs;
+                            inflatedOnUiThread[0] = onUiThread;
+                        }
+                    }
+                });
+                mInflater.inflate(R.layout.simple_view, null, record("simple", finished));
+            }
+        });
+        // The request waits for the blocked inflate thread.
+        Thread.sleep(100);
+        BlockingView.release();
+
+        assertTrue(finished.await(TIMEOUT_MS, TimeUnit.MILLISECONDS));
+        assertEquals(Arrays.asList("blocking", "metrics", "simple"), mFinished);
+        assertTrue(queueTime[0] >= 100);
+        assertFalse(inflatedOnUiThread[0]);
+    }
+
+    /**
+     * Makes a request that holds the inflate thread until {@link BlockingView#release()}, and
+     * waits for the thread to pick it up.
+     */
+    private void blockInflateThread(final OnInflateFinishedListener callback)
+            throws InterruptedException {
+        BlockingView.block();
+        runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mInflater.inflate(R.layout.blocking_view, null, callback);
+            }
+        });
+        assertTrue(BlockingView.awaitStarted(TIMEOUT_MS));
+    }
+
+    /**
+     * Waits until all requests made so far were delivered or dropped.
+     */
+    private void awaitIdle() throws InterruptedException {
+        final CountDownLatch finished = new CountDownLatch(1);
+        runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mInflater.inflate(R.layout.simple_view, null, record("idle", finished));
+            }
+        });
+        assertTrue(finished.await(TIMEOUT_MS, TimeUnit.MILLISECONDS));
+    }
+
+    private OnInflateFinishedListener record(final String name,
+            @Nullable final CountDownLatch finished) {
+        return new OnInflateFinishedListener() {
+            @Override
+            public void onInflateFinished(@NonNull View view, int resid,
+                    @Nullable ViewGroup parent) {
+                mFinished.add(name);
+                mCallbackThreads.add(Thread.currentThread());
+                if (finished != null) {
+                    finished.countDown();
+                }
+            }
+        };
+    }
+
+    private static void runOnMainSync(Runnable runnable) {
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(runnable);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.asynclayoutinflater.view;
+
+import android.content.Context;
+import android.util.AttributeSet;
+import android.view.View;
+
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * View whose construction blocks after {@link #block()} until {@link #release()}, to hold the
+ * inflate thread while a test queues or cancels requests.
+ */
+public class BlockingView extends View {
+    private static final long MAX_BLOCK_MS = 10000;
+
+    private static CountDownLatch sStarted = new CountDownLatch(0);
+    private static CountDownLatch sRelease = new CountDownLatch(0);
+
+    public BlockingView(Context context, AttributeSet attrs) {
+        super(context, attrs);
+        CountDownLatch release;
+        synchronized (BlockingView.class) {
+            sStarted.countDown();
+            release = sRelease;
+        }
+        try {
+            release.await(MAX_BLOCK_MS, TimeUnit.MILLISECONDS);
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+        }
+    }
+
+    static synchronized void block() {
+        sStarted = new CountDownLatch(1);
+        sRelease = new CountDownLatch(1);
+    }
+
+    static boolean awaitStarted(long timeoutMs) throws InterruptedException {
+        CountDownLatch started;
+        synchronized (BlockingView.class) {
+            started = sStarted;
+        }
+        return started.await(timeoutMs, TimeUnit.MILLISECONDS);
+    }
+
+    static synchronized void release() {
+        sRelease.countDown();
+    }
+}
@@ -21,6 +21,7 @@ import android.os.Handler;
 import android.os.Handler.Callback;
 import android.os.Looper;
 import android.os.Message;
+import android.os.SystemClock;
 import android.util.AttributeSet;
 import android.util.Log;
 import android.view.LayoutInflater;
@@ -33,7 +34,9 @@ import androidx.annotation.Nullable;
 import androidx.annotation.UiThread;
 import androidx.core.util.Pools.SynchronizedPool;
 
-import java.util.concurrent.ArrayBlockingQueue;
+import java.util.ArrayList;
+import java.util.concurrent.PriorityBlockingQueue;
+import java.util.concurrent.atomic.AtomicLong;
 
 /**
  * <p>Helper class for inflating layouts asynchronously. To use, construct
@@ -61,6 +64,10 @@ import java.util.concurrent.ArrayBlockingQueue;
  * {@link ViewGroup#addView(View)} in the {@link OnInflateFinishedListener}
  * callback at a minimum.
  *
+ * <p>Requests are inflated by a background thread, using its own clone of the
+ * inflater, in order of their priority. Requests that are no longer needed can be
+ * cancelled with {@link #cancel(OnInflateFinishedListener)}.
+ *
  * <p>This inflater does not support setting a {@link LayoutInflater.Factory}
  * nor {@link LayoutInflater.Factory2}. Similarly it does not support inflating
  * layouts that contain fragments.
@@ -71,6 +78,12 @@ public final class AsyncLayoutInflater {
     LayoutInflater mInflater;
     Handler mHandler;
     InflateThread mInflateThread;
+    // Clone of mInflater used by the inflate thread, so that inflating on the UI thread doesn't
+    // wait for the background inflation. Only accessed by the inflate thread.
+    LayoutInflater mBackgroundInflater;
+    // Requests that were enqueued and not delivered yet, only accessed on the UI thread.
+    final ArrayList<InflateRequest> mPendingRequests = new ArrayList<>();
+    OnInflateMetricsListener mMetricsListener;
 
     public AsyncLayoutInflater(@NonNull Context context) {
         mInflater = new BasicInflater(context);
@@ -81,6 +94,18 @@ public final class AsyncLayoutInflater {
     @UiThread
     public void inflate(@LayoutRes int resid, @Nullable ViewGroup parent,
             @NonNull OnInflateFinishedListener callback) {
+        inflate(resid, parent, 0, callback);
+    }
+
+    /**
+     * Inflates a layout on a background thread. Requests with a higher priority are inflated
+     * before requests with a lower one, and requests of the same priority in the order they were
+     * made. {@link #inflate(int, ViewGroup, OnInflateFinishedListener)} uses a priority of 0.
+     * This method never blocks.
+     */
+    @UiThread
+    public void inflate(@LayoutRes int resid, @Nullable ViewGroup parent, int priority,
+            @NonNull OnInflateFinishedListener callback) {
         if (callback == null) {
             throw new NullPointerException("callback argument may not be null!");
         }
@@ -89,16 +114,80 @@ public final class AsyncLayoutInflater {
         request.resid = resid;
         request.parent = parent;
         request.callback = callback;
+        request.priority = priority;
+        mPendingRequests.add(request);
         mInflateThread.enqueue(request);
     }
 
+    /**
+     * Cancels the pending requests of this inflater that were made with the given callback. The
+     * callback is not invoked for these requests, even if their inflation already started.
+     */
+    @UiThread
+    public void cancel(@NonNull OnInflateFinishedListener callback) {
+        for (int i = mPendingRequests.size() - 1; i >= 0; i--) {
+            InflateRequest request = mPendingRequests.get(i);
+            if (request.callback == callback) {
+                mPendingRequests.remove(i);
+                cancelRequest(request);
+            }
+        }
+    }
+
+    /**
+     * Cancels all the pending requests of this inflater.
+     */
+    @UiThread
+    public void cancelAll() {
+        for (int i = mPendingRequests.size() - 1; i >= 0; i--) {
+            cancelRequest(mPendingRequests.get(i));
+        }
+        mPendingRequests.clear();
+    }
+
+    private void cancelRequest(InflateRequest request) {
+        request.cancelled = true;
+        if (mInflateThread.remove(request)) {
+            mInflateThread.releaseRequest(request);
+        }
+        // Otherwise the inflate thread holds the request and the handler releases it.
+    }
+
+    /**
+     * Sets a listener notified of the time spent by each request waiting for and during
+     * inflation, or null to remove it.
+     */
+    @UiThread
+    public void setOnInflateMetricsListener(@Nullable OnInflateMetricsListener listener) {
+        mMetricsListener = listener;
+    }
+
+    LayoutInflater getBackgroundInflater() {
+        if (mBackgroundInflater == null) {
+            mBackgroundInflater = mInflater.cloneInContext(mInflater.getContext());
+        }
+        return mBackgroundInflater;
+    }
+
     private Callback mHandlerCallback = new Callback() {
         @Override
         public boolean handleMessage(Message msg) {
             InflateRequest request = (InflateRequest) msg.obj;
-            if (request.view == null) {
+            if (request.cancelled) {
+                mInflateThread.releaseRequest(request);
+                return true;
+            }
+            mPendingRequests.remove(request);
+            final boolean inflatedOnUiThread = request.view == null;
+            if (inflatedOnUiThread) {
+                long startTime = SystemClock.uptimeMillis();
                 request.view = mInflater.inflate(
                         request.resid, request.parent, false);
+                request.inflateTime = SystemClock.uptimeMillis() - startTime;
+            }
+            if (mMetricsListener != null) {
+                mMetricsListener.onInflateMetrics(request.resid, request.queueTime,
+                        request.inflateTime, inflatedOnUiThread);
             }
             request.callback.onInflateFinished(
                     request.view, request.resid, request.parent);
@@ -112,15 +201,45 @@ public final class AsyncLayoutInflater {
                 @Nullable ViewGroup parent);
     }
 
-    private static class InflateRequest {
+    /**
+     * Receives timings of inflate requests, on the UI thread, before their
+     * {@link OnInflateFinishedListener} is invoked.
+     */
+    public interface OnInflateMetricsListener {
+        /**
+         * @param resid The inflated layout.
+         * @param queueTimeMs Time the request waited for the inflate thread, in milliseconds.
+         * @param inflateTimeMs Time spent inflating the layout, in milliseconds.
+         * @param inflatedOnUiThread Whether inflating in the background failed and the layout
+         *                           was inflated again on the UI thread.
+         */
+        void onInflateMetrics(@LayoutRes int resid, long queueTimeMs, long inflateTimeMs,
+                boolean inflatedOnUiThread);
+    }
+
+    private static class InflateRequest implements Comparable<InflateRequest> {
         AsyncLayoutInflater inflater;
         ViewGroup parent;
         int resid;
         View view;
         OnInflateFinishedListener callback;
+        int priority;
+        long sequence;
+        long enqueueTime;
+        long queueTime;
+        long inflateTime;
+        volatile boolean cancelled;
 
         InflateRequest() {
         }
+
+        @Override
+        public int compareTo(@NonNull InflateRequest other) {
+            if (priority != other.priority) {
+                return priority > other.priority ? -1 : 1;
+            }
+            return sequence < other.sequence ? -1 : (sequence == other.sequence ? 0 : 1);
+        }
     }
 
     private static class BasicInflater extends LayoutInflater {
@@ -168,8 +287,17 @@ public final class AsyncLayoutInflater {
             return sInstance;
         }
 
-        private ArrayBlockingQueue<InflateRequest> mQueue = new ArrayBlockingQueue<>(10);
-        private SynchronizedPool<InflateRequest> mRequestPool = new SynchronizedPool<>(10);
+        // LayoutInflater caches view constructors in a static map that it doesn't synchronize,
+        // so requests of all inflaters are inflated by this single thread, in priority order.
+        private final PriorityBlockingQueue<InflateRequest> mQueue =
+                new PriorityBlockingQueue<>();
+        private final SynchronizedPool<InflateRequest> mRequestPool =
+                new SynchronizedPool<>(10);
+        private final AtomicLong mNextSequence = new AtomicLong();
+
+        InflateThread() {
+            super(TAG);
+        }
 
         // Extracted to its own method to ensure locals have a constrained liveness
         // scope by the GC. This is needed to avoid keeping previous request references
@@ -184,13 +312,18 @@ public final class AsyncLayoutInflater {
                 return;
             }
 
-            try {
-                request.view = request.inflater.mInflater.inflate(
-                        request.resid, request.parent, false);
-            } catch (RuntimeException ex) {
-                // Probably a Looper failure, retry on the UI thread
-                Log.w(TAG, "Failed to inflate resource in the background! Retrying on the UI"
-                        + " thread", ex);
+            long startTime = SystemClock.uptimeMillis();
+            request.queueTime = startTime - request.enqueueTime;
+            if (!request.cancelled) {
+                try {
+                    request.view = request.inflater.getBackgroundInflater().inflate(
+                            request.resid, request.parent, false);
+                } catch (RuntimeException ex) {
+                    // Probably a Looper failure, retry on the UI thread
+                    Log.w(TAG, "Failed to inflate resource in the background! Retrying on the UI"
+                            + " thread", ex);
+                }
+                request.inflateTime = SystemClock.uptimeMillis() - startTime;
             }
             Message.obtain(request.inflater.mHandler, 0, request)
                     .sendToTarget();
@@ -217,16 +350,27 @@ public final class AsyncLayoutInflater {
             obj.parent = null;
             obj.resid = 0;
             obj.view = null;
+            obj.priority = 0;
+            obj.queueTime = 0;
+            obj.inflateTime = 0;
+            obj.cancelled = false;
             mRequestPool.release(obj);
         }
 
         public void enqueue(InflateRequest request) {
-            try {
-                mQueue.put(request);
-            } catch (InterruptedException e) {
-                throw new RuntimeException(
-                        "Failed to enqueue async inflate request", e);
-            }
+            request.sequence = mNextSequence.getAndIncrement();
+            request.enqueueTime = SystemClock.uptimeMillis();
+            // The queue is unbounded, so this never blocks.
+            mQueue.offer(request);
+        }
+
+        /**
+         * Removes a request that was not taken by the inflate thread yet.
+         *
+         * @return true if the request was removed
+         */
+        public boolean remove(InflateRequest request) {
+            return mQueue.remove(request);
         }
     }
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.core.text;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNotSame;
+
+import android.graphics.Typeface;
+import android.support.test.filters.SmallTest;
+import android.support.test.runner.AndroidJUnit4;
+import android.text.Spannable;
+import android.text.Spanned;
+import android.text.style.StyleSpan;
+import android.text.style.URLSpan;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+@RunWith(AndroidJUnit4.class)
+@SmallTest
+public class PrecomputedHtmlTest {
+
+    private static final String HTML = "<b>bold</b> and <a href=\"https://example.com\">link</a>";
+
+    @Test
+    public void testMatchesFromHtml() {
+        final Spanned expected = HtmlCompat.fromHtml(HTML, HtmlCompat.FROM_HTML_MODE_COMPACT);
+        final PrecomputedHtml precomputed =
+                PrecomputedHtml.create(HTML, HtmlCompat.FROM_HTML_MODE_COMPACT);
+        final Spannable actual = precomputed.toSpannable();
+
+        assertEquals(expected.toString(), precomputed.getText());
+        assertEquals(expected.toString(), actual.toString());
+
+        final Object[] expectedSpans = expected.getSpans(0, expected.length(), Object.class);
+        final Object[] actualSpans = actual.getSpans(0, actual.length(), Object.class);
+        assertEquals(expectedSpans.length, precomputed.getSpanCount());
+        assertEquals(expectedSpans.length, actualSpans.length);
+        for (int i = 0; i < expectedSpans.length; i++) {
+            assertEquals(expectedSpans[i].getClass(), actualSpans[i].getClass());
+            assertEquals(expected.getSpanStart(expectedSpans[i]),
+                    actual.getSpanStart(actualSpans[i]));
+            assertEquals(expected.getSpanEnd(expectedSpans[i]),
+                    actual.getSpanEnd(actualSpans[i]));
+            assertEquals(expected.getSpanFlags(expectedSpans[i]),
+                    actual.getSpanFlags(actualSpans[i]));
+        }
+    }
+
+    @Test
+    public void testToSpannable_returnsIndependentCopies() {
+        final PrecomputedHtml precomputed =
+                PrecomputedHtml.create(HTML, HtmlCompat.FROM_HTML_MODE_LEGACY);
+        final Spannable first = precomputed.toSpannable();
+        final Spannable second = precomputed.toSpannable();
+        assertNotSame(first, second);
+
+        final StyleSpan[] styles = first.getSpans(0, first.length(), StyleSpan.class);
+        assertEquals(1, styles.length);
+        assertEquals(Typeface.BOLD, styles[0].getStyle());
+        first.removeSpan(styles[0]);
+
+        assertEquals(0, first.getSpans(0, first.length(), StyleSpan.class).length);
+        assertEquals(1, second.getSpans(0, second.length(), StyleSpan.class).length);
+        assertEquals(1, second.getSpans(0, second.length(), URLSpan.class).length);
+    }
+}
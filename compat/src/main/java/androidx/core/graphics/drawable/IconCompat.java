@@ -19,7 +19,6 @@ package androidx.core.graphics.drawable;
 import static android.graphics.drawable.Icon.TYPE_ADAPTIVE_BITMAP;
 import static android.graphics.drawable.Icon.TYPE_BITMAP;
 import static android.graphics.drawable.Icon.TYPE_DATA;
-import static android.graphics.drawable.Icon.TYPE_RESOURCE;
 import static android.graphics.drawable.Icon.TYPE_URI;
 
 import static androidx.annotation.RestrictTo.Scope.LIBRARY;
@@ -86,6 +85,14 @@ public class IconCompat {
      */
     public static final int TYPE_UNKOWN = -1;
 
+    /**
+     * Type of icons created from a drawable resource, same as {@link Icon#TYPE_RESOURCE}, which
+     * is only available from API 23.
+     * @hide
+     */
+    @RestrictTo(LIBRARY_GROUP)
+    public static final int TYPE_RESOURCE = 2;
+
     /**
      * @hide
      */
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.core.text;
+
+import android.text.Html.ImageGetter;
+import android.text.Html.TagHandler;
+import android.text.Spannable;
+import android.text.SpannableString;
+import android.text.Spanned;
+
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
+
+/**
+ * An immutable, parsed representation of an HTML string that can be cached and turned into a
+ * {@link Spannable} cheaply.
+ * <p>
+ * Parsing HTML through {@link HtmlCompat#fromHtml(String, int)} builds a new span tree on every
+ * call. A {@code PrecomputedHtml} performs that parse once, typically on a background thread,
+ * and keeps only the plain text together with flat arrays of span objects and their ranges.
+ * Each call to {@link #toSpannable()} then creates a new {@link Spannable} by attaching the
+ * recorded spans, without touching the HTML parser again.
+ * <p>
+ * Instances are safe to share between threads and to keep in a cache such as
+ * {@link androidx.collection.LruCache}. Span objects are shared between all materialized
+ * {@link Spannable}s, so this class should only be used with spans which are not mutated after
+ * parsing, which is the case for all spans produced by the framework HTML parser.
+ */
+public final class PrecomputedHtml {
+    private static final int SPAN_START = 0;
+    private static final int SPAN_END = 1;
+    private static final int SPAN_FLAGS = 2;
+    private static final int SPAN_COLUMNS = 3;
+
+    private final String mText;
+    private final Object[] mSpans;
+    // Holds (start, end, flags) triples for each entry of mSpans.
+    private final int[] mSpanData;
+
+    /**
+     * Parses {@code source} with {@link HtmlCompat#fromHtml(String, int)} and records the result.
+     * <p>
+     * This method may be called on any thread, and should be kept off the main thread for
+     * large inputs.
+     */
+    @NonNull
+    public static PrecomputedHtml create(@NonNull String source,
+            @HtmlCompat.FromHtmlFlags int flags) {
+        return create(HtmlCompat.fromHtml(source, flags));
+    }
+
+    /**
+     * Parses {@code source} with
+     * {@link HtmlCompat#fromHtml(String, int, ImageGetter, TagHandler)} and records the result.
+     * <p>
+     * This method may be called on any thread, provided that {@code imageGetter} and
+     * {@code tagHandler} are safe to call from it.
+     */
+    @NonNull
+    public static PrecomputedHtml create(@NonNull String source,
+            @HtmlCompat.FromHtmlFlags int flags, @Nullable ImageGetter imageGetter,
+            @Nullable TagHandler tagHandler) {
+        return create(HtmlCompat.fromHtml(source, flags, imageGetter, tagHandler));
+    }
+
+    /**
+     * Records the text and spans of an already parsed {@link Spanned}.
+     */
+    @NonNull
+    public static PrecomputedHtml create(@NonNull Spanned spanned) {
+        final Object[] spans = spanned.getSpans(0, spanned.length(), Object.class);
+        final int[] spanData = new int[spans.length * SPAN_COLUMNS];
+        for (int i = 0; i < spans.length; i++) {
+            final Object span = spans[i];
+            final int offset = i * SPAN_COLUMNS;
+            spanData[offset + SPAN_START] = spanned.getSpanStart(span);
+            spanData[offset + SPAN_END] = spanned.getSpanEnd(span);
+            spanData[offset + SPAN_FLAGS] = spanned.getSpanFlags(span);
+        }
+        return new PrecomputedHtml(spanned.toString(), spans, spanData);
+    }
+
+    private PrecomputedHtml(@NonNull String text, @NonNull Object[] spans,
+            @NonNull int[] spanData) {
+        mText = text;
+        mSpans = spans;
+        mSpanData = spanData;
+    }
+
+    /**
+     * Returns the plain text of the parsed HTML, without any markup.
+     */
+    @NonNull
+    public String getText() {
+        return mText;
+    }
+
+    /**
+     * Returns the number of spans recorded for the parsed HTML.
+     */
+    public int getSpanCount() {
+        return mSpans.length;
+    }
+
+    /**
+     * Creates a new {@link Spannable} holding the parsed text and spans.
+     * <p>
+     * The returned object is independent from this instance and from other results of this
+     * method, so callers are free to add or remove spans on it.
+     */
+    @NonNull
+    public Spannable toSpannable() {
+        final SpannableString result = new SpannableString(mText);
+        for (int i = 0; i < mSpans.length; i++) {
+            final int offset = i * SPAN_COLUMNS;
+            result.setSpan(mSpans[i], mSpanData[offset + SPAN_START],
+                    mSpanData[offset + SPAN_END], mSpanData[offset + SPAN_FLAGS]);
+        }
+        return result;
+    }
+
+    @Override
+    public String toString() {
+        return mText;
+    }
+}
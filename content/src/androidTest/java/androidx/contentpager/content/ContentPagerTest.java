@@ -49,6 +49,7 @@ import java.util.Arrays;
 import java.util.HashMap;
 import java.util.List;
 import java.util.Map;
+import java.util.concurrent.Executor;
 import java.util.concurrent.TimeUnit;
 
 @MediumTest
@@ -385,6 +386,86 @@ public class ContentPagerTest {
         assertTrue(observer.mNotifiedLatch.await(1000, TimeUnit.MILLISECONDS));
     }
 
+    @Test
+    public void testAssemblesPagesFromWindows() throws Throwable {
+        mPager.setWindowedPaging(50, 1, 1024 * 1024, new DirectExecutor());
+
+        Query query = mPager.query(UNPAGED_URI, null, createArgs(0, 10), null, mCallback);
+        Cursor cursor = mCallback.getCursor(query);
+        Bundle extras = cursor.getExtras();
+        assertEquals(10, cursor.getCount());
+        assertExpectedRecords(cursor, query.getOffset());
+        assertEquals(
+                ContentPager.CURSOR_DISPOSITION_WINDOWED,
+                extras.getInt(ContentPager.CURSOR_DISPOSITION));
+        assertEquals(
+                TestContentProvider.DEFAULT_RECORD_COUNT,
+                extras.getInt(ContentResolver.EXTRA_TOTAL_COUNT));
+        assertEquals(1, extras.getInt(ContentPager.EXTRA_IPC_COUNT));
+        assertTrue(extras.getLong(ContentPager.EXTRA_IPC_BYTES) > 0);
+
+        // Both the first window and the prefetched second window are served from cache.
+        query = mPager.query(UNPAGED_URI, null, createArgs(55, 10), null, mCallback);
+        cursor = mCallback.getCursor(query);
+        assertExpectedRecords(cursor, query.getOffset());
+        assertEquals(1, cursor.getExtras().getInt(ContentPager.Stats.EXTRA_RESOLVED_QUERIES));
+
+        // A page spanning a cached and an uncached window queries the provider again.
+        query = mPager.query(UNPAGED_URI, null, createArgs(95, 10), null, mCallback);
+        cursor = mCallback.getCursor(query);
+        assertEquals(10, cursor.getCount());
+        assertExpectedRecords(cursor, query.getOffset());
+        extras = cursor.getExtras();
+        assertEquals(2, extras.getInt(ContentPager.Stats.EXTRA_RESOLVED_QUERIES));
+        assertEquals(3, extras.getInt(ContentPager.Stats.EXTRA_WINDOW_PAGED));
+        assertEquals(3, extras.getInt(ContentPager.Stats.EXTRA_TOTAL_QUERIES));
+    }
+
+    @Test
+    public void testWindowedPaging_EndOfResults() throws Throwable {
+        mPager.setWindowedPaging(50, 1, 1024 * 1024, new DirectExecutor());
+
+        int limit = 100;
+        int leftOvers = TestContentProvider.DEFAULT_RECORD_COUNT % limit;
+        int offset = TestContentProvider.DEFAULT_RECORD_COUNT - leftOvers;
+
+        Query query = mPager.query(UNPAGED_URI, null, createArgs(offset, limit), null, mCallback);
+        Cursor cursor = mCallback.getCursor(query);
+        assertEquals(leftOvers, cursor.getCount());
+        assertExpectedRecords(cursor, query.getOffset());
+    }
+
+    @Test
+    public void testWindowCacheIsBoundedByMemory() throws Throwable {
+        // Too small to hold a single window.
+        mPager.setWindowedPaging(50, 1, 64, new DirectExecutor());
+
+        mPager.query(UNPAGED_URI, null, createArgs(0, 10), null, mCallback);
+        Query query = mPager.query(UNPAGED_URI, null, createArgs(0, 10), null, mCallback);
+
+        Cursor cursor = mCallback.getCursor(query);
+        assertExpectedRecords(cursor, query.getOffset());
+        assertEquals(2, cursor.getExtras().getInt(ContentPager.Stats.EXTRA_RESOLVED_QUERIES));
+    }
+
+    @Test
+    public void testRelaysContentChangeNotificationsOnWindowedCursors() throws Throwable {
+        mPager.setWindowedPaging(50, 0, 1024 * 1024, new DirectExecutor());
+
+        TestContentObserver observer = new TestContentObserver(
+                new Handler(Looper.getMainLooper()));
+        observer.expectNotifications(1);
+
+        Query query = mPager.query(UNPAGED_URI, null, createArgs(10, 99), null, mCallback);
+
+        Cursor cursor = mCallback.getCursor(query);
+        cursor.registerContentObserver(observer);
+
+        mResolver.notifyChange(UNPAGED_URI, null);
+
+        assertTrue(observer.mNotifiedLatch.await(1000, TimeUnit.MILLISECONDS));
+    }
+
     private void assertExpectedRecords(Cursor cursor, int offset) {
         for (int row = 0; row < cursor.getCount(); row++) {
             assertTrue(cursor.moveToPosition(row));
@@ -404,6 +485,13 @@ public class ContentPagerTest {
         }
     }
 
+    private static final class DirectExecutor implements Executor {
+        @Override
+        public void execute(Runnable command) {
+            command.run();
+        }
+    }
+
     private static final class TestContentCallback implements ContentCallback {
 
         private int mPagesLoaded;
@@ -40,11 +40,13 @@ import androidx.annotation.RequiresPermission;
 import androidx.annotation.VisibleForTesting;
 import androidx.annotation.WorkerThread;
 import androidx.collection.LruCache;
+import androidx.core.util.Pair;
 
 import java.lang.annotation.Retention;
 import java.lang.annotation.RetentionPolicy;
 import java.util.HashSet;
 import java.util.Set;
+import java.util.concurrent.Executor;
 
 /**
  * {@link ContentPager} provides support for loading "paged" data on a background thread
@@ -82,6 +84,13 @@ import java.util.Set;
  * by the ContentPager, and data will be copied into a new cursor in a background thread.
  * The new cursor will be returned to a {@link ContentCallback} supplied by your application.
  *
+ * <li>If windowed paging was enabled with
+ * {@link #setWindowedPaging(int, int, int, Executor)} and the provider does not support
+ * paging, rows of the unpaged Cursor are copied in fixed size windows, and the unpaged Cursor
+ * is closed once the windows covering the page, and a number of windows following it, have
+ * been copied. Pages are assembled from cached windows without querying the provider again
+ * for as long as those windows remain in the cache.
+ *
  * <p>In either cases, when an application employs this library it can generally assume
  * that there will be no CursorWindow swap. But picking the right limit for records can
  * help reduce or even eliminate some heavy lifting done to guard against swaps.
@@ -152,7 +161,8 @@ public class ContentPager {
             ContentPager.CURSOR_DISPOSITION_COPIED,
             ContentPager.CURSOR_DISPOSITION_PAGED,
             ContentPager.CURSOR_DISPOSITION_REPAGED,
-            ContentPager.CURSOR_DISPOSITION_WRAPPED
+            ContentPager.CURSOR_DISPOSITION_WRAPPED,
+            ContentPager.CURSOR_DISPOSITION_WINDOWED
     })
     @Retention(RetentionPolicy.SOURCE)
     public @interface CursorDisposition {}
@@ -174,6 +184,12 @@ public class ContentPager {
      */
     public static final int CURSOR_DISPOSITION_WRAPPED = 4;
 
+    /**
+     * The cursor was not pre-paged. Page data was assembled from windows copied from
+     * the unpaged cursor.
+     */
+    public static final int CURSOR_DISPOSITION_WINDOWED = 5;
+
     /** @see ContentResolver#EXTRA_HONORED_ARGS */
     public static final String EXTRA_HONORED_ARGS = ContentResolver.EXTRA_HONORED_ARGS;
 
@@ -192,6 +208,15 @@ public class ContentPager {
     /** Specifies a limit likely to fit in CursorWindow limit. */
     public static final String EXTRA_SUGGESTED_LIMIT = "android-support:extra-suggested-limit";
 
+    /**
+     * Number of calls into content providers made by this ContentPager: queries, plus
+     * {@link CursorWindow} fills observed while copying rows out of unpaged cursors.
+     */
+    public static final String EXTRA_IPC_COUNT = "android-support:extra-ipc-count";
+
+    /** Estimated number of bytes copied out of unpaged cursors by this ContentPager. */
+    public static final String EXTRA_IPC_BYTES = "android-support:extra-ipc-bytes";
+
     private static final boolean DEBUG = false;
     private static final String TAG = "ContentPager";
     private static final int DEFAULT_CURSOR_CACHE_SIZE = 1;
@@ -203,6 +228,16 @@ public class ContentPager {
     private final @GuardedBy("mContentLock") Set<Query> mActiveQueries = new HashSet<>();
     private final @GuardedBy("mContentLock") CursorCache mCursorCache;
 
+    // Windowed paging state. mWindowCache is null while windowed paging is disabled.
+    private @GuardedBy("mContentLock") WindowCache mWindowCache;
+    private @GuardedBy("mContentLock") int mWindowSize;
+    private @GuardedBy("mContentLock") int mPrefetchWindowCount;
+    // Incremented whenever cached windows are dropped, so that windows copied for an
+    // earlier generation are not added to the cache.
+    private @GuardedBy("mContentLock") int mWindowGeneration;
+
+    private @GuardedBy("mContentLock") Executor mPrefetchExecutor;
+
     private final Stats mStats = new Stats();
 
     /**
@@ -296,6 +331,51 @@ public class ContentPager {
         return query;
     }
 
+    /**
+     * Enables or disables windowed paging of providers that do not support paging.
+     *
+     * <p>By default the unpaged Cursor returned by such a provider is held open in a cache,
+     * and each page is copied out of it. With windowed paging, rows are copied in windows of
+     * {@code windowSize} rows instead. Once the windows covering a page have been copied the
+     * page is returned, the following {@code prefetchWindowCount} windows are copied on
+     * {@code prefetchExecutor} and the unpaged Cursor is closed. Windows are cached, and the
+     * cache is bounded by the estimated memory used by the windows rather than by their number.
+     *
+     * <p>Changing these settings clears any cached data.
+     *
+     * @param windowSize Number of rows in a window, or 0 to disable windowed paging. A multiple
+     *     of the page size keeps pages from spanning several windows.
+     * @param prefetchWindowCount Number of windows following a page that are copied ahead of
+     *     time. Larger values reduce the number of queries needed to page forward through
+     *     results, at the cost of memory.
+     * @param maxCacheSizeBytes Upper bound of the estimated memory used by cached windows.
+     * @param prefetchExecutor The executor windows are prefetched on, typically a background
+     *     thread shared by the app. May be null if {@code prefetchWindowCount} is 0.
+     */
+    @MainThread
+    public void setWindowedPaging(int windowSize, int prefetchWindowCount, int maxCacheSizeBytes,
+            @Nullable Executor prefetchExecutor) {
+        checkArgument(windowSize >= 0, "'windowSize' argument cannot be negative.");
+        checkArgument(prefetchWindowCount >= 0,
+                "'prefetchWindowCount' argument cannot be negative.");
+        checkArgument(prefetchWindowCount == 0 || prefetchExecutor != null,
+                "'prefetchExecutor' argument cannot be null when prefetching windows.");
+        checkArgument(windowSize == 0 || maxCacheSizeBytes > 0,
+                "'maxCacheSizeBytes' argument must be greater than 0.");
+
+        synchronized (mContentLock) {
+            mCursorCache.evictAll();
+            if (mWindowCache != null) {
+                mWindowCache.evictAll();
+            }
+            mWindowGeneration++;
+            mWindowCache = windowSize > 0 ? new WindowCache(maxCacheSizeBytes) : null;
+            mWindowSize = windowSize;
+            mPrefetchWindowCount = prefetchWindowCount;
+            mPrefetchExecutor = prefetchExecutor;
+        }
+    }
+
     /**
      * Clears any cached data. This method must be called in order to cleanup runtime state
      * (like cursors).
@@ -305,6 +385,10 @@ public class ContentPager {
         synchronized (mContentLock) {
             if (DEBUG) Log.d(TAG, "Clearing un-paged cursor cache.");
             mCursorCache.evictAll();
+            if (mWindowCache != null) {
+                mWindowCache.evictAll();
+            }
+            mWindowGeneration++;
 
             for (Query query : mActiveQueries) {
                 if (DEBUG) Log.d(TAG, "Canceling running query: " + query);
@@ -322,6 +406,16 @@ public class ContentPager {
         mStats.increment(Stats.EXTRA_TOTAL_QUERIES);
 
         synchronized (mContentLock) {
+            // With windowed paging, the page may be assembled from windows we have
+            // already copied.
+            if (mWindowCache != null) {
+                Cursor cursor = createCachedWindowedCursor(query);
+                if (cursor != null) {
+                    if (DEBUG) Log.d(TAG, "Found cached windows for: " + query);
+                    return cursor;
+                }
+            }
+
             // We have a existing unpaged-cursor for this query. Instead of running a new query
             // via ContentResolver, we'll just copy results from that.
             // This is the "compat" behavior.
@@ -338,6 +432,7 @@ public class ContentPager {
         // cursor will ever be set.
         Cursor cursor = query.run(mResolver);
         mStats.increment(Stats.EXTRA_RESOLVED_QUERIES);
+        mStats.recordIpc(1, 0);
 
         //       for the window. If so, communicate the overflow back to the client.
         if (cursor == null) {
@@ -349,11 +444,22 @@ public class ContentPager {
             return processProviderPagedCursor(query, cursor);
         }
 
-        // Cache the unpaged results so we can generate pages from them on subsequent queries.
+        final int windowSize;
+        final int prefetchWindowCount;
+        final int generation;
         synchronized (mContentLock) {
-            mCursorCache.put(query.getUri(), cursor);
-            return createPagedCursor(query);
+            if (mWindowCache == null) {
+                // Cache the unpaged results so we can generate pages from them on
+                // subsequent queries.
+                mCursorCache.put(query.getUri(), cursor);
+                return createPagedCursor(query);
+            }
+            windowSize = mWindowSize;
+            prefetchWindowCount = mPrefetchWindowCount;
+            generation = mWindowGeneration;
         }
+
+        return createWindowedCursor(query, cursor, windowSize, prefetchWindowCount, generation);
     }
 
     @WorkerThread
@@ -385,14 +491,168 @@ public class ContentPager {
             // This creates an in-memory copy of the data that fits the requested page.
             // ContentObservers registered on InMemoryCursor are directly registered
             // on the unpaged cursor.
-            result = new InMemoryCursor(
+            InMemoryCursor copy = new InMemoryCursor(
                     unpaged, query.getOffset(), count, CURSOR_DISPOSITION_COPIED);
+            mStats.recordIpc(copy.getWindowFills(), copy.getSizeBytes());
+            result = copy;
+        }
+
+        mStats.includeStats(result.getExtras());
+        return result;
+    }
+
+    /**
+     * @return A page assembled from cached windows, or null if any of the windows covering
+     *     the page is missing from the cache.
+     */
+    @WorkerThread
+    @GuardedBy("mContentLock")
+    private @Nullable Cursor createCachedWindowedCursor(Query query) {
+        final int firstWindow = query.getOffset() / mWindowSize;
+        InMemoryCursor first = mWindowCache.get(new Pair<>(query.getUri(), firstWindow));
+        if (first == null) {
+            return null;
+        }
+
+        // Every window was copied from the same unpaged cursor, and carries its count.
+        final int totalCount = first.getExtras().getInt(EXTRA_TOTAL_COUNT);
+        final int count = getPageCount(query, totalCount);
+        InMemoryCursor[] windows = new InMemoryCursor[getWindowCount(query, count, mWindowSize)];
+        windows[0] = first;
+        for (int i = 1; i < windows.length; i++) {
+            windows[i] = mWindowCache.get(new Pair<>(query.getUri(), firstWindow + i));
+            if (windows[i] == null) {
+                return null;
+            }
+        }
+
+        return newWindowedCursor(query, windows, mWindowSize, count,
+                first.getColumnNames(), new Bundle(first.getExtras()), totalCount);
+    }
+
+    /**
+     * Copies the windows covering the requested page out of the unpaged cursor, then hands
+     * the unpaged cursor over to be prefetched from and closed.
+     */
+    @WorkerThread
+    private Cursor createWindowedCursor(Query query, Cursor unpaged, int windowSize,
+            int prefetchWindowCount, int generation) {
+        final int totalCount = unpaged.getCount();
+        final int count = getPageCount(query, totalCount);
+        final int firstWindow = query.getOffset() / windowSize;
+
+        InMemoryCursor[] windows = new InMemoryCursor[getWindowCount(query, count, windowSize)];
+        for (int i = 0; i < windows.length; i++) {
+            windows[i] = getOrCopyWindow(
+                    query.getUri(), unpaged, firstWindow + i, windowSize, generation);
         }
 
+        // Windows may share the unpaged cursor's extras, so the page gets its own copy.
+        Bundle extras = unpaged.getExtras();
+        Cursor result = newWindowedCursor(query, windows, windowSize, count,
+                unpaged.getColumnNames(), extras != null ? new Bundle(extras) : null, totalCount);
+
+        prefetchWindows(query.getUri(), unpaged, firstWindow + windows.length,
+                prefetchWindowCount, windowSize, generation);
+        return result;
+    }
+
+    @WorkerThread
+    private Cursor newWindowedCursor(Query query, InMemoryCursor[] windows, int windowSize,
+            int count, String[] columnNames, Bundle extras, int totalCount) {
+        if (DEBUG) Log.d(TAG, "Assembling page from " + windows.length + " windows: " + query);
+        mStats.increment(Stats.EXTRA_WINDOW_PAGED);
+
+        WindowedCursor result = new WindowedCursor(windows, windowSize,
+                query.getOffset() % windowSize, count, columnNames,
+                buildExtras(extras, totalCount, CURSOR_DISPOSITION_WINDOWED));
+        // The unpaged cursor may already be closed, so observe the uri directly.
+        result.setNotificationUri(mResolver, query.getUri());
         mStats.includeStats(result.getExtras());
         return result;
     }
 
+    @WorkerThread
+    private InMemoryCursor getOrCopyWindow(
+            Uri uri, Cursor unpaged, int index, int windowSize, int generation) {
+        Pair<Uri, Integer> key = new Pair<>(uri, index);
+        synchronized (mContentLock) {
+            InMemoryCursor window = mWindowCache != null ? mWindowCache.get(key) : null;
+            if (window != null) {
+                return window;
+            }
+        }
+
+        if (DEBUG) Log.d(TAG, "Copying window " + index + " of " + uri);
+        InMemoryCursor window = new InMemoryCursor(
+                unpaged, index * windowSize, windowSize, CURSOR_DISPOSITION_WINDOWED);
+        mStats.recordIpc(window.getWindowFills(), window.getSizeBytes());
+
+        synchronized (mContentLock) {
+            if (mWindowCache != null && generation == mWindowGeneration) {
+                mWindowCache.put(key, window);
+            }
+        }
+        return window;
+    }
+
+    /**
+     * Copies up to {@code windowCount} windows starting at {@code firstWindow} in the
+     * background, then closes the unpaged cursor.
+     */
+    @WorkerThread
+    private void prefetchWindows(final Uri uri, final Cursor unpaged, final int firstWindow,
+            int windowCount, final int windowSize, final int generation) {
+        final int available = (unpaged.getCount() + windowSize - 1) / windowSize - firstWindow;
+        final int count = Math.min(windowCount, available);
+        if (count <= 0) {
+            unpaged.close();
+            return;
+        }
+
+        final Executor executor;
+        synchronized (mContentLock) {
+            executor = generation == mWindowGeneration ? mPrefetchExecutor : null;
+        }
+        if (executor == null) {
+            // Windowed paging settings changed since the page was requested.
+            unpaged.close();
+            return;
+        }
+        executor.execute(new Runnable() {
+            @Override
+            public void run() {
+                try {
+                    for (int i = 0; i < count; i++) {
+                        synchronized (mContentLock) {
+                            if (generation != mWindowGeneration) {
+                                return;
+                            }
+                        }
+                        getOrCopyWindow(uri, unpaged, firstWindow + i, windowSize, generation);
+                    }
+                } finally {
+                    unpaged.close();
+                }
+            }
+        });
+    }
+
+    /** @return The number of rows in the requested page. */
+    private static int getPageCount(Query query, int totalCount) {
+        int remaining = Math.max(0, totalCount - query.getOffset());
+        return query.getLimit() < 0 ? remaining : Math.min(query.getLimit(), remaining);
+    }
+
+    /** @return The number of windows covering a page of {@code count} rows. */
+    private static int getWindowCount(Query query, int count, int windowSize) {
+        if (count == 0) {
+            return 0;
+        }
+        int firstWindow = query.getOffset() / windowSize;
+        return (query.getOffset() + count - 1) / windowSize - firstWindow + 1;
+    }
+
     @WorkerThread
     private @Nullable Cursor processProviderPagedCursor(Query query, Cursor cursor) {
 
@@ -434,7 +694,7 @@ public class ContentPager {
         return result;
     }
 
-    private CursorWindow getWindow(Cursor cursor) {
+    static CursorWindow getWindow(Cursor cursor) {
         if (cursor instanceof CursorWrapper) {
             return getWindow(((CursorWrapper) cursor).getWrappedCursor());
         }
@@ -601,6 +861,21 @@ public class ContentPager {
         }
     }
 
+    /**
+     * LruCache of windows copied from unpaged results, keyed by Uri and window index.
+     * The cache is bounded by the estimated memory used by the windows.
+     */
+    private static final class WindowCache extends LruCache<Pair<Uri, Integer>, InMemoryCursor> {
+        WindowCache(int maxSizeBytes) {
+            super(maxSizeBytes);
+        }
+
+        @Override
+        protected int sizeOf(Pair<Uri, Integer> key, InMemoryCursor window) {
+            return window.getSizeBytes();
+        }
+    }
+
     /**
      * Implementations of this interface provide the mechanism
      * for execution of queries off the UI thread.
@@ -662,13 +937,20 @@ public class ContentPager {
         /** Identifes the number of pages produced directly by a page-supporting provider. */
         static final String EXTRA_PROVIDER_PAGED = "android-support:extra-provider-paged";
 
+        /** Identifes the number of pages assembled from windows. */
+        static final String EXTRA_WINDOW_PAGED = "android-support:extra-window-paged";
+
         // simple stats objects tracking paged result handling.
         private int mTotalQueries;
         private int mResolvedQueries;
         private int mCompatPaged;
         private int mProviderPaged;
+        private int mWindowPaged;
+        private int mIpcCount;
+        private long mIpcBytes;
 
-        private void increment(String prop) {
+        // Windows are also copied on the prefetch thread.
+        private synchronized void increment(String prop) {
             switch (prop) {
                 case EXTRA_TOTAL_QUERIES:
                     ++mTotalQueries;
@@ -686,23 +968,38 @@ public class ContentPager {
                     ++mProviderPaged;
                     break;
 
+                case EXTRA_WINDOW_PAGED:
+                    ++mWindowPaged;
+                    break;
+
                 default:
                     throw new IllegalArgumentException("Unknown property: " + prop);
             }
         }
 
-        private void reset() {
+        private synchronized void recordIpc(int count, long bytes) {
+            mIpcCount += count;
+            mIpcBytes += bytes;
+        }
+
+        private synchronized void reset() {
             mTotalQueries = 0;
             mResolvedQueries = 0;
             mCompatPaged = 0;
             mProviderPaged = 0;
+            mWindowPaged = 0;
+            mIpcCount = 0;
+            mIpcBytes = 0;
         }
 
-        void includeStats(Bundle bundle) {
+        synchronized void includeStats(Bundle bundle) {
             bundle.putInt(EXTRA_TOTAL_QUERIES, mTotalQueries);
             bundle.putInt(EXTRA_RESOLVED_QUERIES, mResolvedQueries);
             bundle.putInt(EXTRA_COMPAT_PAGED, mCompatPaged);
             bundle.putInt(EXTRA_PROVIDER_PAGED, mProviderPaged);
+            bundle.putInt(EXTRA_WINDOW_PAGED, mWindowPaged);
+            bundle.putInt(EXTRA_IPC_COUNT, mIpcCount);
+            bundle.putLong(EXTRA_IPC_BYTES, mIpcBytes);
         }
     }
 }
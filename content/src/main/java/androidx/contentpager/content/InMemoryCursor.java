@@ -22,6 +22,7 @@ import android.database.AbstractCursor;
 import android.database.ContentObserver;
 import android.database.Cursor;
 import android.database.CursorIndexOutOfBoundsException;
+import android.database.CursorWindow;
 import android.os.Bundle;
 import android.os.Handler;
 import android.os.Looper;
@@ -44,6 +45,9 @@ final class InMemoryCursor extends AbstractCursor {
 
     private static final int NUM_TYPES = 5;
 
+    // Rough per-object overhead used when estimating the memory held by a cursor.
+    private static final int OBJECT_OVERHEAD = 16;
+
     private final String[] mColumnNames;
     private final int mRowCount;
 
@@ -79,6 +83,11 @@ final class InMemoryCursor extends AbstractCursor {
     private byte[][] mBlobs;
     private String[] mStrings;
 
+    // Estimated memory held by the row data, and the number of CursorWindow fills of the
+    // source cursor observed while copying.
+    private final int mSizeBytes;
+    private final int mWindowFills;
+
     /**
      * @param cursor source of data to copy. Ownership is reserved to the called, meaning
      *               we won't ever close it.
@@ -117,11 +126,26 @@ final class InMemoryCursor extends AbstractCursor {
         mBlobs = new byte[mRowCount * mColumnTypeCount[FIELD_TYPE_BLOB]][];
         mStrings = new String[mRowCount * mColumnTypeCount[FIELD_TYPE_STRING]];
 
+        int sizeBytes = (mLongs.length + mDoubles.length) * 8
+                + (mBlobs.length + mStrings.length) * 4;
+        int windowFills = 0;
+        CursorWindow window = ContentPager.getWindow(cursor);
+        int windowStart = window != null ? window.getStartPosition() : -1;
+
         for (int row = 0; row < mRowCount; row++) {
             if (!cursor.moveToPosition(offset + row)) {
                 throw new RuntimeException("Unable to position cursor.");
             }
 
+            if (window != null) {
+                CursorWindow current = ContentPager.getWindow(cursor);
+                if (current != window || current.getStartPosition() != windowStart) {
+                    windowFills++;
+                    window = current;
+                    windowStart = current != null ? current.getStartPosition() : -1;
+                }
+            }
+
             // Now copy data from the row into primitive arrays.
             for (int col = 0; col < mColumnType.length; col++) {
                 int type = mColumnType[col];
@@ -138,13 +162,38 @@ final class InMemoryCursor extends AbstractCursor {
                         break;
                     case FIELD_TYPE_BLOB:
                         mBlobs[position] = cursor.getBlob(col);
+                        if (mBlobs[position] != null) {
+                            sizeBytes += OBJECT_OVERHEAD + mBlobs[position].length;
+                        }
                         break;
                     case FIELD_TYPE_STRING:
                         mStrings[position] = cursor.getString(col);
+                        if (mStrings[position] != null) {
+                            sizeBytes += 2 * OBJECT_OVERHEAD + 2 * mStrings[position].length();
+                        }
                         break;
                 }
             }
         }
+
+        mSizeBytes = sizeBytes;
+        mWindowFills = windowFills;
+    }
+
+    /**
+     * @return Estimated number of bytes of memory held by the row data of this cursor.
+     */
+    int getSizeBytes() {
+        return mSizeBytes;
+    }
+
+    /**
+     * @return Number of times the source cursor's {@link CursorWindow} was filled while
+     *     rows were copied into this cursor. For a cross-process cursor each fill is a
+     *     call into the provider.
+     */
+    int getWindowFills() {
+        return mWindowFills;
     }
 
     @Override
@@ -167,53 +216,71 @@ final class InMemoryCursor extends AbstractCursor {
         return mColumnNames;
     }
 
+    // Row based accessors, used by WindowedCursor to read shared windows without moving them.
+
+    long getLong(int row, int column) {
+        return mLongs[getCellPosition(row, column, FIELD_TYPE_INTEGER)];
+    }
+
+    double getDouble(int row, int column) {
+        return mDoubles[getCellPosition(row, column, FIELD_TYPE_FLOAT)];
+    }
+
+    byte[] getBlob(int row, int column) {
+        return mBlobs[getCellPosition(row, column, FIELD_TYPE_BLOB)];
+    }
+
+    String getString(int row, int column) {
+        return mStrings[getCellPosition(row, column, FIELD_TYPE_STRING)];
+    }
+
     @Override
     public short getShort(int column) {
         checkValidColumn(column);
         checkValidPosition();
-        return (short) mLongs[getCellPosition(getPosition(), column, FIELD_TYPE_INTEGER)];
+        return (short) getLong(getPosition(), column);
     }
 
     @Override
     public int getInt(int column) {
         checkValidColumn(column);
         checkValidPosition();
-        return (int) mLongs[getCellPosition(getPosition(), column, FIELD_TYPE_INTEGER)];
+        return (int) getLong(getPosition(), column);
     }
 
     @Override
     public long getLong(int column) {
         checkValidColumn(column);
         checkValidPosition();
-        return mLongs[getCellPosition(getPosition(), column, FIELD_TYPE_INTEGER)];
+        return getLong(getPosition(), column);
     }
 
     @Override
     public float getFloat(int column) {
         checkValidColumn(column);
         checkValidPosition();
-        return (float) mDoubles[getCellPosition(getPosition(), column, FIELD_TYPE_FLOAT)];
+        return (float) getDouble(getPosition(), column);
     }
 
     @Override
     public double getDouble(int column) {
         checkValidColumn(column);
         checkValidPosition();
-        return mDoubles[getCellPosition(getPosition(), column, FIELD_TYPE_FLOAT)];
+        return getDouble(getPosition(), column);
     }
 
     @Override
     public byte[] getBlob(int column) {
         checkValidColumn(column);
         checkValidPosition();
-        return mBlobs[getCellPosition(getPosition(), column, FIELD_TYPE_BLOB)];
+        return getBlob(getPosition(), column);
     }
 
     @Override
     public String getString(int column) {
         checkValidColumn(column);
         checkValidPosition();
-        return mStrings[getCellPosition(getPosition(), column, FIELD_TYPE_STRING)];
+        return getString(getPosition(), column);
     }
 
     @Override
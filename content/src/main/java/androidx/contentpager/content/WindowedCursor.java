@@ -0,0 +1,141 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.contentpager.content;
+
+import android.database.AbstractCursor;
+import android.database.Cursor;
+import android.database.CursorIndexOutOfBoundsException;
+import android.os.Bundle;
+
+import androidx.annotation.RestrictTo;
+
+/**
+ * A {@link Cursor} presenting a page of rows that lie in consecutive windows copied by
+ * {@link ContentPager} from an unpaged cursor. Windows are immutable and may be shared by
+ * several pages, so rows are read from them by position and no data is copied when a page
+ * is assembled.
+ * @hide
+ */
+@RestrictTo(RestrictTo.Scope.LIBRARY)
+final class WindowedCursor extends AbstractCursor {
+
+    private final InMemoryCursor[] mWindows;
+    private final int mWindowSize;
+    // Position of the first row of this page within the first window.
+    private final int mFirstRow;
+    private final int mRowCount;
+    private final String[] mColumnNames;
+    private final Bundle mExtras;
+
+    WindowedCursor(InMemoryCursor[] windows, int windowSize, int firstRow, int rowCount,
+            String[] columnNames, Bundle extras) {
+        mWindows = windows;
+        mWindowSize = windowSize;
+        mFirstRow = firstRow;
+        mRowCount = rowCount;
+        mColumnNames = columnNames;
+        mExtras = extras;
+    }
+
+    private InMemoryCursor getWindow() {
+        checkPosition();
+        return mWindows[(mFirstRow + getPosition()) / mWindowSize];
+    }
+
+    private int getWindowRow() {
+        return (mFirstRow + getPosition()) % mWindowSize;
+    }
+
+    @Override
+    public Bundle getExtras() {
+        return mExtras;
+    }
+
+    @Override
+    public int getCount() {
+        return mRowCount;
+    }
+
+    @Override
+    public String[] getColumnNames() {
+        return mColumnNames;
+    }
+
+    @Override
+    public short getShort(int column) {
+        return (short) getLong(column);
+    }
+
+    @Override
+    public int getInt(int column) {
+        return (int) getLong(column);
+    }
+
+    @Override
+    public long getLong(int column) {
+        checkValidColumn(column);
+        return getWindow().getLong(getWindowRow(), column);
+    }
+
+    @Override
+    public float getFloat(int column) {
+        return (float) getDouble(column);
+    }
+
+    @Override
+    public double getDouble(int column) {
+        checkValidColumn(column);
+        return getWindow().getDouble(getWindowRow(), column);
+    }
+
+    @Override
+    public byte[] getBlob(int column) {
+        checkValidColumn(column);
+        return getWindow().getBlob(getWindowRow(), column);
+    }
+
+    @Override
+    public String getString(int column) {
+        checkValidColumn(column);
+        return getWindow().getString(getWindowRow(), column);
+    }
+
+    @Override
+    public int getType(int column) {
+        checkValidColumn(column);
+        return getWindow().getType(column);
+    }
+
+    @Override
+    public boolean isNull(int column) {
+        switch (getType(column)) {
+            case FIELD_TYPE_STRING:
+                return getString(column) == null;
+            case FIELD_TYPE_BLOB:
+                return getBlob(column) == null;
+            default:
+                return false;
+        }
+    }
+
+    private void checkValidColumn(int column) {
+        if (column < 0 || column >= mColumnNames.length) {
+            throw new CursorIndexOutOfBoundsException(
+                    "Requested column: " + column + ", # of columns: " + mColumnNames.length);
+        }
+    }
+}
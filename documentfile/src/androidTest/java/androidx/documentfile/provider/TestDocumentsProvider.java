@@ -0,0 +1,291 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.documentfile.provider;
+
+import android.database.Cursor;
+import android.database.MatrixCursor;
+import android.os.CancellationSignal;
+import android.os.ParcelFileDescriptor;
+import android.provider.DocumentsContract.Document;
+import android.provider.DocumentsContract.Root;
+import android.provider.DocumentsProvider;
+
+import androidx.annotation.RequiresApi;
+
+import java.io.FileNotFoundException;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+import java.util.Map;
+import java.util.TreeMap;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+
+/**
+ * In-memory provider of a tree of documents whose ids are their paths, such as
+ * {@code "root/dir/file.txt"}. Counts its queries and can slow down or block listings, to
+ * test how {@link DocumentFile} queries it.
+ */
+@RequiresApi(21)
+public class TestDocumentsProvider extends DocumentsProvider {
+    static final String AUTHORITY = "androidx.documentfile.test.documents";
+
+    private static final String[] DEFAULT_DOCUMENT_PROJECTION = {
+            Document.COLUMN_DOCUMENT_ID,
+            Document.COLUMN_DISPLAY_NAME,
+            Document.COLUMN_MIME_TYPE,
+            Document.COLUMN_LAST_MODIFIED,
+            Document.COLUMN_SIZE,
+            Document.COLUMN_FLAGS
+    };
+    private static final long MAX_BLOCK_MS = 10000;
+
+    private static final Map<String, TestDocument> sDocuments = new TreeMap<>();
+    private static final AtomicInteger sDocumentQueries = new AtomicInteger();
+    // Ids of the listed directories, in order.
+    private static final List<String> sListedDirectories =
+            Collections.synchronizedList(new ArrayList<String>());
+    private static final AtomicInteger sConcurrentListings = new AtomicInteger();
+    private static final AtomicInteger sMaxConcurrentListings = new AtomicInteger();
+    private static volatile long sListingDelayMs;
+    private static volatile String sBlockedDirectory;
+    private static volatile CountDownLatch sBlockStarted = new CountDownLatch(0);
+    private static volatile CountDownLatch sUnblock = new CountDownLatch(0);
+
+    static final class TestDocument {
+        final String mName;
+        final String mMimeType;
+        final long mSize;
+        final long mLastModified;
+        final int mFlags;
+
+        TestDocument(String name, String mimeType, long size, long lastModified, int flags) {
+            mName = name;
+            mMimeType = mimeType;
+            mSize = size;
+            mLastModified = lastModified;
+            mFlags = flags;
+        }
+    }
+
+    static void reset() {
+        synchronized (sDocuments) {
+            sDocuments.clear();
+        }
+        sDocumentQueries.set(0);
+        sListedDirectories.clear();
+        sConcurrentListings.set(0);
+        sMaxConcurrentListings.set(0);
+        sListingDelayMs = 0;
+        sBlockedDirectory = null;
+        sUnblock.countDown();
+    }
+
+    static void addDirectory(String id) {
+        addDocument(id, Document.MIME_TYPE_DIR, 0, 0, Document.FLAG_DIR_SUPPORTS_CREATE);
+    }
+
+    static void addDocument(String id, String mimeType, long size, long lastModified,
+            int flags) {
+        synchronized (sDocuments) {
+            sDocuments.put(id, new TestDocument(nameOf(id), mimeType, size, lastModified, flags));
+        }
+    }
+
+    /**
+     * @return the number of queries for a single document.
+     */
+    static int getDocumentQueryCount() {
+        return sDocumentQueries.get();
+    }
+
+    static List<String> getListedDirectories() {
+        synchronized (sListedDirectories) {
+            return new ArrayList<>(sListedDirectories);
+        }
+    }
+
+    static int getMaxConcurrentListings() {
+        return sMaxConcurrentListings.get();
+    }
+
+    static void setListingDelay(long delayMs) {
+        sListingDelayMs = delayMs;
+    }
+
+    /**
+     * Makes listing the given directory block until {@link #unblock()}.
+     */
+    static void blockListing(String directoryId) {
+        sBlockStarted = new CountDownLatch(1);
+        sUnblock = new CountDownLatch(1);
+        sBlockedDirectory = directoryId;
+    }
+
+    static boolean awaitBlocked(long timeoutMs) throws InterruptedException {
+        return sBlockStarted.await(timeoutMs, TimeUnit.MILLISECONDS);
+    }
+
+    static void unblock() {
+        sUnblock.countDown();
+    }
+
+    @Override
+    public boolean onCreate() {
+        return true;
+    }
+
+    @Override
+    public Cursor queryRoots(String[] projection) {
+        return new MatrixCursor(projection != null ? projection : new String[] {
+                Root.COLUMN_ROOT_ID, Root.COLUMN_DOCUMENT_ID });
+    }
+
+    @Override
+    public Cursor queryDocument(String documentId, String[] projection)
+            throws FileNotFoundException {
+        sDocumentQueries.incrementAndGet();
+        final MatrixCursor result = new MatrixCursor(resolve(projection));
+        synchronized (sDocuments) {
+            includeDocument(result, documentId, getDocument(documentId));
+        }
+        return result;
+    }
+
+    @Override
+    public Cursor queryChildDocuments(String parentDocumentId, String[] projection,
+            String sortOrder) throws FileNotFoundException {
+        sListedDirectories.add(parentDocumentId);
+        final int concurrent = sConcurrentListings.incrementAndGet();
+        try {
+            int max = sMaxConcurrentListings.get();
+            while (concurrent > max && !sMaxConcurrentListings.compareAndSet(max, concurrent)) {
+                max = sMaxConcurrentListings.get();
+            }
+            if (parentDocumentId.equals(sBlockedDirectory)) {
+                sBlockStarted.countDown();
+                sUnblock.await(MAX_BLOCK_MS, TimeUnit.MILLISECONDS);
+            } else if (sListingDelayMs > 0) {
+                Thread.sleep(sListingDelayMs);
+            }
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+        } finally {
+            sConcurrentListings.decrementAndGet();
+        }
+
+        final MatrixCursor result = new MatrixCursor(resolve(projection));
+        synchronized (sDocuments) {
+            getDocument(parentDocumentId);
+            for (Map.Entry<String, TestDocument> entry : sDocuments.entrySet()) {
+                if (isDirectChild(parentDocumentId, entry.getKey())) {
+                    includeDocument(result, entry.getKey(), entry.getValue());
+                }
+            }
+        }
+        return result;
+    }
+
+    @Override
+    public ParcelFileDescriptor openDocument(String documentId, String mode,
+            CancellationSignal signal) throws FileNotFoundException {
+        throw new FileNotFoundException("Documents have no content");
+    }
+
+    @Override
+    public boolean isChildDocument(String parentDocumentId, String documentId) {
+        return documentId.startsWith(parentDocumentId + "/");
+    }
+
+    @Override
+    public String renameDocument(String documentId, String displayName)
+            throws FileNotFoundException {
+        synchronized (sDocuments) {
+            final TestDocument document = getDocument(documentId);
+            // Keeps the id, so the children of a renamed directory keep theirs too.
+            sDocuments.put(documentId, new TestDocument(displayName, document.mMimeType,
+                    document.mSize, document.mLastModified, document.mFlags));
+        }
+        return null;
+    }
+
+    @Override
+    public void deleteDocument(String documentId) throws FileNotFoundException {
+        synchronized (sDocuments) {
+            getDocument(documentId);
+            final ArrayList<String> deleted = new ArrayList<>();
+            for (String id : sDocuments.keySet()) {
+                if (id.equals(documentId) || isChildDocument(documentId, id)) {
+                    deleted.add(id);
+                }
+            }
+            sDocuments.keySet().removeAll(deleted);
+        }
+    }
+
+    private static TestDocument getDocument(String documentId) throws FileNotFoundException {
+        final TestDocument document = sDocuments.get(documentId);
+        if (document == null) {
+            throw new FileNotFoundException("No document " + documentId);
+        }
+        return document;
+    }
+
+    private static String[] resolve(String[] projection) {
+        return projection != null ? projection : DEFAULT_DOCUMENT_PROJECTION;
+    }
+
+    private static void includeDocument(MatrixCursor result, String documentId,
+            TestDocument document) {
+        final MatrixCursor.RowBuilder row = result.newRow();
+        for (String column : result.getColumnNames()) {
+            switch (column) {
+                case Document.COLUMN_DOCUMENT_ID:
+                    row.add(documentId);
+                    break;
+                case Document.COLUMN_DISPLAY_NAME:
+                    row.add(document.mName);
+                    break;
+                case Document.COLUMN_MIME_TYPE:
+                    row.add(document.mMimeType);
+                    break;
+                case Document.COLUMN_LAST_MODIFIED:
+                    row.add(document.mLastModified);
+                    break;
+                case Document.COLUMN_SIZE:
+                    row.add(document.mSize);
+                    break;
+                case Document.COLUMN_FLAGS:
+                    row.add(document.mFlags);
+                    break;
+                default:
+                    row.add(null);
+                    break;
+            }
+        }
+    }
+
+    private static boolean isDirectChild(String parentDocumentId, String documentId) {
+        return documentId.startsWith(parentDocumentId + "/")
+                && documentId.indexOf('/', parentDocumentId.length() + 1) < 0;
+    }
+
+    private static String nameOf(String documentId) {
+        return documentId.substring(documentId.lastIndexOf('/') + 1);
+    }
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.documentfile.provider;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertTrue;
+
+import android.net.Uri;
+import android.provider.DocumentsContract;
+import android.provider.DocumentsContract.Document;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.SdkSuppress;
+import android.support.test.filters.SmallTest;
+import android.support.test.runner.AndroidJUnit4;
+
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.Arrays;
+import java.util.Comparator;
+
+@RunWith(AndroidJUnit4.class)
+@SmallTest
+@SdkSuppress(minSdkVersion = 21)
+public class TreeDocumentFileTest {
+    // DocumentsContract API level 24.
+    private static final int FLAG_VIRTUAL_DOCUMENT = 1 << 9;
+
+    private DocumentFile mRoot;
+
+    @Before
+    public void setUp() {
+        TestDocumentsProvider.reset();
+        TestDocumentsProvider.addDirectory("root");
+        TestDocumentsProvider.addDocument("root/a.txt", "text/plain", 10, 1000,
+                Document.FLAG_SUPPORTS_WRITE);
+        TestDocumentsProvider.addDocument("root/b.bin", "application/octet-stream", 20, 2000,
+                Document.FLAG_SUPPORTS_DELETE);
+        TestDocumentsProvider.addDocument("root/virtual", "application/x-virtual", 0, 3000,
+                FLAG_VIRTUAL_DOCUMENT);
+        TestDocumentsProvider.addDocument("root/untyped", null, 5, 0, 0);
+        TestDocumentsProvider.addDirectory("root/dir");
+        TestDocumentsProvider.addDocument("root/dir/c.txt", "text/plain", 30, 4000, 0);
+
+        final Uri treeUri = DocumentsContract.buildTreeDocumentUri(
+                TestDocumentsProvider.AUTHORITY, "root");
+        mRoot = DocumentFile.fromTreeUri(InstrumentationRegistry.getContext(), treeUri);
+    }
+
+    @Test
+    public void testListFileSnapshots_MatchesQueries() {
+        final DocumentFile[] snapshots = sortByUri(mRoot.listFileSnapshots());
+        final DocumentFile[] files = sortByUri(mRoot.listFiles());
+
+        assertEquals(5, snapshots.length);
+        assertEquals(files.length, snapshots.length);
+        for (int i = 0; i < files.length; i++) {
+            final DocumentFile snapshot = snapshots[i];
+            final DocumentFile file = files[i];
+            assertEquals(file.getUri(), snapshot.getUri());
+            assertEquals(file.getName(), snapshot.getName());
+            assertEquals(file.getType(), snapshot.getType());
+            assertEquals(file.isDirectory(), snapshot.isDirectory());
+            assertEquals(file.isFile(), snapshot.isFile());
+            assertEquals(file.isVirtual(), snapshot.isVirtual());
+            assertEquals(file.length(), snapshot.length());
+            assertEquals(file.lastModified(), snapshot.lastModified());
+            assertEquals(file.canRead(), snapshot.canRead());
+            assertEquals(file.canWrite(), snapshot.canWrite());
+            assertEquals(mRoot, snapshot.getParentFile());
+        }
+    }
+
+    @Test
+    public void testListFileSnapshots_QueriesOnce() {
+        final DocumentFile[] snapshots = mRoot.listFileSnapshots();
+
+        for (DocumentFile snapshot : snapshots) {
+            snapshot.getName();
+            snapshot.getType();
+            snapshot.isDirectory();
+            snapshot.isFile();
+            snapshot.isVirtual();
+            snapshot.length();
+            snapshot.lastModified();
+            snapshot.canRead();
+            snapshot.canWrite();
+        }
+        assertEquals(Arrays.asList("root"), TestDocumentsProvider.getListedDirectories());
+        assertEquals(0, TestDocumentsProvider.getDocumentQueryCount());
+    }
+
+    @Test
+    public void testRenameTo_DropsSnapshot() {
+        final DocumentFile snapshot = findSnapshot("a.txt");
+
+        assertTrue(snapshot.renameTo("renamed.txt"));
+        assertEquals("renamed.txt", snapshot.getName());
+        assertTrue(TestDocumentsProvider.getDocumentQueryCount() > 0);
+    }
+
+    @Test
+    public void testDelete_DropsSnapshot() {
+        final DocumentFile snapshot = findSnapshot("b.bin");
+
+        assertTrue(snapshot.delete());
+        assertFalse(snapshot.exists());
+        assertFalse(snapshot.isFile());
+        assertEquals(0, snapshot.length());
+        assertEquals(null, snapshot.getName());
+    }
+
+    @Test
+    public void testExists_QueriesProvider() {
+        final DocumentFile snapshot = findSnapshot("a.txt");
+
+        assertTrue(snapshot.exists());
+        assertTrue(DocumentsContract.deleteDocument(
+                InstrumentationRegistry.getContext().getContentResolver(), snapshot.getUri()));
+        assertFalse(snapshot.exists());
+    }
+
+    private DocumentFile findSnapshot(String name) {
+        for (DocumentFile snapshot : mRoot.listFileSnapshots()) {
+            if (name.equals(snapshot.getName())) {
+                return snapshot;
+            }
+        }
+        throw new AssertionError("No document named " + name);
+    }
+
+    private static DocumentFile[] sortByUri(DocumentFile[] files) {
+        Arrays.sort(files, new Comparator<DocumentFile>() {
+            @Override
+            public int compare(DocumentFile a, DocumentFile b) {
+                return a.getUri().compareTo(b.getUri());
+            }
+        });
+        return files;
+    }
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.documentfile.provider;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertSame;
+import static org.junit.Assert.assertTrue;
+import static org.junit.Assert.fail;
+
+import android.net.Uri;
+import android.provider.DocumentsContract;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.MediumTest;
+import android.support.test.filters.SdkSuppress;
+import android.support.test.runner.AndroidJUnit4;
+
+import androidx.annotation.NonNull;
+
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.HashSet;
+import java.util.Set;
+import java.util.concurrent.atomic.AtomicReference;
+
+@RunWith(AndroidJUnit4.class)
+@MediumTest
+@SdkSuppress(minSdkVersion = 21)
+public class TreeWalkerTest {
+    private static final long TIMEOUT_MS = 5000;
+
+    private DocumentFile mRoot;
+    private final Set<String> mVisited = Collections.synchronizedSet(new HashSet<String>());
+
+    @Before
+    public void setUp() {
+        TestDocumentsProvider.reset();
+        TestDocumentsProvider.addDirectory("root");
+        for (int i = 0; i < 4; i++) {
+            final String dir = "root/dir" + i;
+            TestDocumentsProvider.addDirectory(dir);
+            TestDocumentsProvider.addDirectory(dir + "/sub");
+            TestDocumentsProvider.addDocument(dir + "/sub/file" + i, "text/plain", i, 0, 0);
+        }
+        TestDocumentsProvider.addDocument("root/top", "text/plain", 1, 0, 0);
+
+        final Uri treeUri = DocumentsContract.buildTreeDocumentUri(
+                TestDocumentsProvider.AUTHORITY, "root");
+        mRoot = DocumentFile.fromTreeUri(InstrumentationRegistry.getContext(), treeUri);
+    }
+
+    @After
+    public void tearDown() {
+        TestDocumentsProvider.reset();
+    }
+
+    @Test
+    public void testWalk_VisitsWholeTree() throws InterruptedException {
+        mRoot.walk(2, new RecordingVisitor());
+
+        assertEquals(new HashSet<>(Arrays.asList("top",
+                "dir0", "sub", "file0", "dir1", "file1", "dir2", "file2", "dir3", "file3")),
+                mVisited);
+        // One listing per directory, and no query for a single document.
+        assertEquals(9, TestDocumentsProvider.getListedDirectories().size());
+        assertEquals(0, TestDocumentsProvider.getDocumentQueryCount());
+    }
+
+    @Test
+    public void testWalk_SkipsChildrenOfRejectedDirectories() throws InterruptedException {
+        mRoot.walk(2, new RecordingVisitor() {
+            @Override
+            public boolean visit(@NonNull DocumentFile file) {
+                super.visit(file);
+                return !file.getName().equals("sub");
+            }
+        });
+
+        assertFalse(mVisited.contains("file0"));
+        assertEquals(5, TestDocumentsProvider.getListedDirectories().size());
+    }
+
+    @Test
+    public void testWalk_RespectsParallelism() throws InterruptedException {
+        TestDocumentsProvider.setListingDelay(50);
+
+        mRoot.walk(2, new RecordingVisitor());
+
+        assertEquals(9, TestDocumentsProvider.getListedDirectories().size());
+        assertTrue(TestDocumentsProvider.getMaxConcurrentListings() <= 2);
+    }
+
+    @Test
+    public void testWalk_RethrowsVisitorException() throws InterruptedException {
+        final IllegalStateException failure = new IllegalStateException();
+        try {
+            mRoot.walk(2, new DocumentFile.Visitor() {
+                @Override
+                public boolean visit(@NonNull DocumentFile file) {
+                    if (file.getName().equals("dir1")) {
+                        throw failure;
+                    }
+                    return true;
+                }
+            });
+            fail("Expected the visitor's exception");
+        } catch (IllegalStateException e) {
+            assertSame(failure, e);
+        }
+    }
+
+    @Test
+    public void testWalk_StopsWhenInterrupted() throws InterruptedException {
+        TestDocumentsProvider.blockListing("root/dir0");
+        final AtomicReference<Throwable> result = new AtomicReference<>();
+        final Thread walker = new Thread(new Runnable() {
+            @Override
+            public void run() {
+                try {
+                    mRoot.walk(1, new RecordingVisitor());
+                } catch (Throwable e) {
+                    result.set(e);
+                }
+            }
+        });
+        walker.start();
+        assertTrue(TestDocumentsProvider.awaitBlocked(TIMEOUT_MS));
+
+        walker.interrupt();
+        walker.join(TIMEOUT_MS);
+        assertFalse(walker.isAlive());
+        assertTrue(result.get() instanceof InterruptedException);
+
+        // Directories queued behind the blocked one are never listed.
+        TestDocumentsProvider.unblock();
+        Thread.sleep(100);
+        assertEquals(Arrays.asList("root", "root/dir0"),
+                TestDocumentsProvider.getListedDirectories());
+    }
+
+    @Test
+    public void testWalk_RejectsInvalidParallelism() throws InterruptedException {
+        try {
+            mRoot.walk(0, new RecordingVisitor());
+            fail("Expected IllegalArgumentException");
+        } catch (IllegalArgumentException expected) {
+        }
+    }
+
+    private class RecordingVisitor implements DocumentFile.Visitor {
+        @Override
+        public boolean visit(@NonNull DocumentFile file) {
+            mVisited.add(file.getName());
+            return true;
+        }
+    }
+}
@@ -25,6 +25,7 @@ import android.provider.DocumentsContract;
 
 import androidx.annotation.NonNull;
 import androidx.annotation.Nullable;
+import androidx.annotation.WorkerThread;
 
 import java.io.File;
 
@@ -325,6 +326,71 @@ public abstract class DocumentFile {
     @NonNull
     public abstract DocumentFile[] listFiles();
 
+    /**
+     * Returns an array of snapshots of the files contained in the directory
+     * represented by this file.
+     * <p>
+     * Unlike {@link #listFiles()}, which only reads the identity of each child,
+     * this reads the name, MIME type, size, last modified time and flags of all
+     * children with a single query to the
+     * {@link android.provider.DocumentsProvider}. The returned files answer
+     * {@link #getName()}, {@link #getType()}, {@link #isDirectory()},
+     * {@link #isFile()}, {@link #isVirtual()}, {@link #length()},
+     * {@link #lastModified()}, {@link #canRead()} and {@link #canWrite()} from
+     * those values instead of querying the provider on every call, so they do not
+     * reflect changes made to the documents after they were listed.
+     *
+     * @return an array of files.
+     * @throws UnsupportedOperationException when working with a single document
+     *             created from {@link #fromSingleUri(Context, Uri)}.
+     * @see #listFiles()
+     */
+    @NonNull
+    public DocumentFile[] listFileSnapshots() {
+        return listFiles();
+    }
+
+    /**
+     * Visits every document below this directory, listing up to
+     * {@code parallelism} directories at the same time. Directories are listed
+     * with {@link #listFileSnapshots()}, so walking a tree costs one query per
+     * directory.
+     * <p>
+     * This method blocks until the whole tree was visited, and must not be called
+     * on the main thread.
+     *
+     * @param parallelism the maximum number of directories listed concurrently.
+     * @param visitor called for each document below this directory. It is called
+     *            concurrently from several threads when {@code parallelism} is
+     *            greater than 1.
+     * @throws InterruptedException if the calling thread was interrupted while
+     *             waiting for the walk to complete. No further directories are
+     *             listed in that case.
+     * @throws UnsupportedOperationException when working with a single document
+     *             created from {@link #fromSingleUri(Context, Uri)}.
+     */
+    @WorkerThread
+    public void walk(int parallelism, @NonNull Visitor visitor) throws InterruptedException {
+        if (parallelism < 1) {
+            throw new IllegalArgumentException("parallelism must be at least 1");
+        }
+        new TreeWalker(parallelism, visitor).walk(this);
+    }
+
+    /**
+     * Callback for {@link #walk(int, Visitor)}.
+     */
+    public interface Visitor {
+        /**
+         * Called for each document found while walking a tree.
+         *
+         * @param file a snapshot of the document, see {@link #listFileSnapshots()}.
+         * @return {@code true} to walk the children of {@code file} if it is a
+         *         directory, {@code false} to skip them.
+         */
+        boolean visit(@NonNull DocumentFile file);
+    }
+
     /**
      * Search through {@link #listFiles()} for the first document matching the
      * given display name. Returns {@code null} when no matching document is
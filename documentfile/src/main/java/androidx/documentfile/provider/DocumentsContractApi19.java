@@ -41,7 +41,11 @@ class DocumentsContractApi19 {
             return false;
         }
 
-        return (getFlags(context, self) & FLAG_VIRTUAL_DOCUMENT) != 0;
+        return isVirtual(getFlags(context, self));
+    }
+
+    static boolean isVirtual(long flags) {
+        return (flags & FLAG_VIRTUAL_DOCUMENT) != 0;
     }
 
     @Nullable
@@ -56,7 +60,11 @@ class DocumentsContractApi19 {
 
     @Nullable
     public static String getType(Context context, Uri self) {
-        final String rawType = getRawType(context, self);
+        return getType(getRawType(context, self));
+    }
+
+    @Nullable
+    static String getType(@Nullable String rawType) {
         if (DocumentsContract.Document.MIME_TYPE_DIR.equals(rawType)) {
             return null;
         } else {
@@ -69,11 +77,18 @@ class DocumentsContractApi19 {
     }
 
     public static boolean isDirectory(Context context, Uri self) {
-        return DocumentsContract.Document.MIME_TYPE_DIR.equals(getRawType(context, self));
+        return isDirectory(getRawType(context, self));
+    }
+
+    static boolean isDirectory(@Nullable String rawType) {
+        return DocumentsContract.Document.MIME_TYPE_DIR.equals(rawType);
     }
 
     public static boolean isFile(Context context, Uri self) {
-        final String type = getRawType(context, self);
+        return isFile(getRawType(context, self));
+    }
+
+    static boolean isFile(@Nullable String type) {
         if (DocumentsContract.Document.MIME_TYPE_DIR.equals(type) || TextUtils.isEmpty(type)) {
             return false;
         } else {
@@ -91,13 +106,21 @@ class DocumentsContractApi19 {
 
     public static boolean canRead(Context context, Uri self) {
         // Ignore if grant doesn't allow read
-        if (context.checkCallingOrSelfUriPermission(self, Intent.FLAG_GRANT_READ_URI_PERMISSION)
-                != PackageManager.PERMISSION_GRANTED) {
+        if (!hasReadPermission(context, self)) {
             return false;
         }
 
+        return canRead(getRawType(context, self));
+    }
+
+    static boolean hasReadPermission(Context context, Uri self) {
+        return context.checkCallingOrSelfUriPermission(self, Intent.FLAG_GRANT_READ_URI_PERMISSION)
+                == PackageManager.PERMISSION_GRANTED;
+    }
+
+    static boolean canRead(@Nullable String rawType) {
         // Ignore documents without MIME
-        if (TextUtils.isEmpty(getRawType(context, self))) {
+        if (TextUtils.isEmpty(rawType)) {
             return false;
         }
 
@@ -106,14 +129,21 @@ class DocumentsContractApi19 {
 
     public static boolean canWrite(Context context, Uri self) {
         // Ignore if grant doesn't allow write
-        if (context.checkCallingOrSelfUriPermission(self, Intent.FLAG_GRANT_WRITE_URI_PERMISSION)
-                != PackageManager.PERMISSION_GRANTED) {
+        if (!hasWritePermission(context, self)) {
             return false;
         }
 
         final String type = getRawType(context, self);
         final int flags = queryForInt(context, self, DocumentsContract.Document.COLUMN_FLAGS, 0);
+        return canWrite(type, flags);
+    }
+
+    static boolean hasWritePermission(Context context, Uri self) {
+        return context.checkCallingOrSelfUriPermission(self, Intent.FLAG_GRANT_WRITE_URI_PERMISSION)
+                == PackageManager.PERMISSION_GRANTED;
+    }
 
+    static boolean canWrite(@Nullable String type, int flags) {
         // Ignore documents without MIME
         if (TextUtils.isEmpty(type)) {
             return false;
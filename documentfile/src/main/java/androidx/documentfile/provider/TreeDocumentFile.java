@@ -21,8 +21,10 @@ import android.content.Context;
 import android.database.Cursor;
 import android.net.Uri;
 import android.provider.DocumentsContract;
+import android.provider.DocumentsContract.Document;
 import android.util.Log;
 
+import androidx.annotation.NonNull;
 import androidx.annotation.Nullable;
 import androidx.annotation.RequiresApi;
 
@@ -30,13 +32,32 @@ import java.util.ArrayList;
 
 @RequiresApi(21)
 class TreeDocumentFile extends DocumentFile {
+    // Columns read for every child by listFileSnapshots(), in the order of the Snapshot fields.
+    private static final String[] SNAPSHOT_PROJECTION = {
+            Document.COLUMN_DOCUMENT_ID,
+            Document.COLUMN_DISPLAY_NAME,
+            Document.COLUMN_MIME_TYPE,
+            Document.COLUMN_LAST_MODIFIED,
+            Document.COLUMN_SIZE,
+            Document.COLUMN_FLAGS
+    };
+
     private Context mContext;
     private Uri mUri;
+    // Values read when this file was listed, or null to query the provider on every call.
+    @Nullable
+    private Snapshot mSnapshot;
 
     TreeDocumentFile(@Nullable DocumentFile parent, Context context, Uri uri) {
+        this(parent, context, uri, null);
+    }
+
+    private TreeDocumentFile(@Nullable DocumentFile parent, Context context, Uri uri,
+            @Nullable Snapshot snapshot) {
         super(parent);
         mContext = context;
         mUri = uri;
+        mSnapshot = snapshot;
     }
 
     @Override
@@ -73,54 +94,97 @@ class TreeDocumentFile extends DocumentFile {
     @Override
     @Nullable
     public String getName() {
+        final Snapshot snapshot = mSnapshot;
+        if (snapshot != null) {
+            return snapshot.mName;
+        }
         return DocumentsContractApi19.getName(mContext, mUri);
     }
 
     @Override
     @Nullable
     public String getType() {
+        final Snapshot snapshot = mSnapshot;
+        if (snapshot != null) {
+            return DocumentsContractApi19.getType(snapshot.mRawType);
+        }
         return DocumentsContractApi19.getType(mContext, mUri);
     }
 
     @Override
     public boolean isDirectory() {
+        final Snapshot snapshot = mSnapshot;
+        if (snapshot != null) {
+            return DocumentsContractApi19.isDirectory(snapshot.mRawType);
+        }
         return DocumentsContractApi19.isDirectory(mContext, mUri);
     }
 
     @Override
     public boolean isFile() {
+        final Snapshot snapshot = mSnapshot;
+        if (snapshot != null) {
+            return DocumentsContractApi19.isFile(snapshot.mRawType);
+        }
         return DocumentsContractApi19.isFile(mContext, mUri);
     }
 
     @Override
     public boolean isVirtual() {
+        final Snapshot snapshot = mSnapshot;
+        if (snapshot != null) {
+            return DocumentsContractApi19.isVirtual(snapshot.mFlags);
+        }
         return DocumentsContractApi19.isVirtual(mContext, mUri);
     }
 
     @Override
     public long lastModified() {
+        final Snapshot snapshot = mSnapshot;
+        if (snapshot != null) {
+            return snapshot.mLastModified;
+        }
         return DocumentsContractApi19.lastModified(mContext, mUri);
     }
 
     @Override
     public long length() {
+        final Snapshot snapshot = mSnapshot;
+        if (snapshot != null) {
+            return snapshot.mSize;
+        }
         return DocumentsContractApi19.length(mContext, mUri);
     }
 
     @Override
     public boolean canRead() {
+        final Snapshot snapshot = mSnapshot;
+        if (snapshot != null) {
+            return DocumentsContractApi19.hasReadPermission(mContext, mUri)
+                    && DocumentsContractApi19.canRead(snapshot.mRawType);
+        }
         return DocumentsContractApi19.canRead(mContext, mUri);
     }
 
     @Override
     public boolean canWrite() {
+        final Snapshot snapshot = mSnapshot;
+        if (snapshot != null) {
+            return DocumentsContractApi19.hasWritePermission(mContext, mUri)
+                    && DocumentsContractApi19.canWrite(snapshot.mRawType, (int) snapshot.mFlags);
+        }
         return DocumentsContractApi19.canWrite(mContext, mUri);
     }
 
     @Override
     public boolean delete() {
         try {
-            return DocumentsContract.deleteDocument(mContext.getContentResolver(), mUri);
+            final boolean deleted =
+                    DocumentsContract.deleteDocument(mContext.getContentResolver(), mUri);
+            if (deleted) {
+                mSnapshot = null;
+            }
+            return deleted;
         } catch (Exception e) {
             return false;
         }
@@ -128,6 +192,7 @@ class TreeDocumentFile extends DocumentFile {
 
     @Override
     public boolean exists() {
+        // A snapshot proves the document existed when listed, but not that it still does.
         return DocumentsContractApi19.exists(mContext, mUri);
     }
 
@@ -162,6 +227,31 @@ class TreeDocumentFile extends DocumentFile {
         return resultFiles;
     }
 
+    @Override
+    @NonNull
+    public DocumentFile[] listFileSnapshots() {
+        final ContentResolver resolver = mContext.getContentResolver();
+        final Uri childrenUri = DocumentsContract.buildChildDocumentsUriUsingTree(mUri,
+                DocumentsContract.getDocumentId(mUri));
+        final ArrayList<DocumentFile> results = new ArrayList<>();
+
+        Cursor c = null;
+        try {
+            c = resolver.query(childrenUri, SNAPSHOT_PROJECTION, null, null, null);
+            while (c.moveToNext()) {
+                final Uri documentUri = DocumentsContract.buildDocumentUriUsingTree(mUri,
+                        c.getString(0));
+                results.add(new TreeDocumentFile(this, mContext, documentUri, new Snapshot(c)));
+            }
+        } catch (Exception e) {
+            Log.w(TAG, "Failed query: " + e);
+        } finally {
+            closeQuietly(c);
+        }
+
+        return results.toArray(new DocumentFile[results.size()]);
+    }
+
     private static void closeQuietly(@Nullable AutoCloseable closeable) {
         if (closeable != null) {
             try {
@@ -180,6 +270,7 @@ class TreeDocumentFile extends DocumentFile {
                     mContext.getContentResolver(), mUri, displayName);
             if (result != null) {
                 mUri = result;
+                mSnapshot = null;
                 return true;
             } else {
                 return false;
@@ -188,4 +279,26 @@ class TreeDocumentFile extends DocumentFile {
             return false;
         }
     }
+
+    /**
+     * Document columns read by {@link #listFileSnapshots()}, with the defaults the
+     * single column queries in {@link DocumentsContractApi19} fall back to.
+     */
+    private static final class Snapshot {
+        @Nullable
+        final String mName;
+        @Nullable
+        final String mRawType;
+        final long mLastModified;
+        final long mSize;
+        final long mFlags;
+
+        Snapshot(Cursor c) {
+            mName = c.isNull(1) ? null : c.getString(1);
+            mRawType = c.isNull(2) ? null : c.getString(2);
+            mLastModified = c.isNull(3) ? 0 : c.getLong(3);
+            mSize = c.isNull(4) ? 0 : c.getLong(4);
+            mFlags = c.isNull(5) ? 0 : c.getLong(5);
+        }
+    }
 }
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.documentfile.provider;
+
+import androidx.annotation.GuardedBy;
+import androidx.annotation.Nullable;
+
+import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.ThreadPoolExecutor;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Implements {@link DocumentFile#walk(int, DocumentFile.Visitor)}. Each directory is listed by
+ * a task on a pool of at most {@code parallelism} threads, which lives as long as the walk.
+ */
+final class TreeWalker {
+    private final DocumentFile.Visitor mVisitor;
+    private final ThreadPoolExecutor mExecutor;
+
+    private final Object mLock = new Object();
+    // Number of directories scheduled but not listed yet.
+    @GuardedBy("mLock")
+    private int mPending;
+    @GuardedBy("mLock")
+    @Nullable
+    private RuntimeException mFailure;
+
+    TreeWalker(int parallelism, DocumentFile.Visitor visitor) {
+        mVisitor = visitor;
+        mExecutor = new ThreadPoolExecutor(parallelism, parallelism, 1, TimeUnit.SECONDS,
+                new LinkedBlockingQueue<Runnable>());
+        mExecutor.allowCoreThreadTimeOut(true);
+    }
+
+    void walk(DocumentFile root) throws InterruptedException {
+        try {
+            schedule(root);
+            synchronized (mLock) {
+                while (mPending > 0 && mFailure == null) {
+                    mLock.wait();
+                }
+                if (mFailure != null) {
+                    throw mFailure;
+                }
+            }
+        } finally {
+            mExecutor.shutdownNow();
+        }
+    }
+
+    void schedule(final DocumentFile directory) {
+        synchronized (mLock) {
+            mPending++;
+        }
+        mExecutor.execute(new Runnable() {
+            @Override
+            public void run() {
+                try {
+                    for (DocumentFile file : directory.listFileSnapshots()) {
+                        if (mVisitor.visit(file) && file.isDirectory()) {
+                            schedule(file);
+                        }
+                    }
+                } catch (RuntimeException e) {
+                    synchronized (mLock) {
+                        if (mFailure == null) {
+                            mFailure = e;
+                        }
+                    }
+                } finally {
+                    synchronized (mLock) {
+                        mPending--;
+                        mLock.notifyAll();
+                    }
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.dynamicanimation.animation;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+
+import android.os.SystemClock;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.LargeTest;
+import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
+
+import org.junit.After;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+@LargeTest
+@RunWith(AndroidJUnit4.class)
+public class AnimationHandlerTest {
+    private static final String TAG = "AnimationHandlerTest";
+    private static final int ANIMATION_COUNT = 300;
+    private static final long FRAME_INTERVAL_MS = 16;
+    private static final int MAX_FRAMES = 1000;
+
+    /**
+     * Frame provider that only records that a frame was requested, so that the test can drive
+     * frames with a fixed interval.
+     */
+    private static class FakeFrameProvider extends AnimationHandler.AnimationFrameCallbackProvider {
+        boolean mFramePending;
+
+        FakeFrameProvider(AnimationHandler.AnimationCallbackDispatcher dispatcher) {
+            super(dispatcher);
+        }
+
+        @Override
+        void postFrameCallback() {
+            mFramePending = true;
+        }
+    }
+
+    @After
+    public void tearDown() {
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                AnimationHandler.getInstance().setProvider(null);
+            }
+        });
+    }
+
+    @Test
+    public void benchmarkManySprings() {
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                AnimationHandler handler = AnimationHandler.getInstance();
+                FakeFrameProvider provider =
+                        new FakeFrameProvider(handler.getCallbackDispatcher());
+                handler.setProvider(provider);
+
+                FloatValueHolder[] holders = new FloatValueHolder[ANIMATION_COUNT];
+                SpringAnimation[] animations = new SpringAnimation[ANIMATION_COUNT];
+                for (int i = 0; i < ANIMATION_COUNT; i++) {
+                    holders[i] = new FloatValueHolder(i);
+                    SpringForce spring = new SpringForce(i + 100f)
+                            .setStiffness(SpringForce.STIFFNESS_LOW)
+                            .setDampingRatio(SpringForce.DAMPING_RATIO_MEDIUM_BOUNCY);
+                    animations[i] = new SpringAnimation(holders[i]).setSpring(spring);
+                    animations[i].start();
+                }
+
+                long frameTime = SystemClock.uptimeMillis();
+                int frames = 0;
+                long start = SystemClock.elapsedRealtimeNanos();
+                while (provider.mFramePending && frames < MAX_FRAMES) {
+                    provider.mFramePending = false;
+                    frameTime += FRAME_INTERVAL_MS;
+                    handler.getCallbackDispatcher().dispatchAnimationFrame(frameTime);
+                    frames++;
+                }
+                long elapsed = SystemClock.elapsedRealtimeNanos() - start;
+
+                for (int i = 0; i < ANIMATION_COUNT; i++) {
+                    assertFalse(animations[i].isRunning());
+                    assertEquals(i + 100f, holders[i].getValue(), 0f);
+                }
+                Log.i(TAG, ANIMATION_COUNT + " springs settled in " + frames + " frames, "
+                        + elapsed / frames / 1000 + "us per frame");
+            }
+        });
+    }
+}
@@ -780,6 +780,105 @@ public class SpringTests {
 
     }
 
+    /**
+     * Verify that evaluating a spring at a given time gives the same result as evaluating it in
+     * several steps, for all kinds of damping.
+     */
+    @Test
+    public void testValueAtIsIndependentOfSteps() {
+        float[] dampingRatios = {SpringForce.DAMPING_RATIO_HIGH_BOUNCY,
+                SpringForce.DAMPING_RATIO_NO_BOUNCY, 2f};
+        for (float dampingRatio : dampingRatios) {
+            SpringForce spring = new SpringForce(100f)
+                    .setStiffness(SpringForce.STIFFNESS_LOW)
+                    .setDampingRatio(dampingRatio);
+            assertEquals(0f, spring.getValueAt(0f, 500f, 0), 0f);
+            assertEquals(500f, spring.getVelocityAt(0f, 500f, 0), 0f);
+
+            float value = 0f;
+            float velocity = 500f;
+            for (int i = 0; i < 10; i++) {
+                float nextValue = spring.getValueAt(value, velocity, 16);
+                velocity = spring.getVelocityAt(value, velocity, 16);
+                value = nextValue;
+            }
+            assertEquals(spring.getValueAt(0f, 500f, 160), value, 0.01f);
+            assertEquals(spring.getVelocityAt(0f, 500f, 160), velocity, 0.1f);
+        }
+    }
+
+    /**
+     * Verify that a spring is at rest at the time returned by getTimeToRest(), and not before.
+     */
+    @Test
+    public void testTimeToRest() {
+        float threshold = 0.5f;
+        SpringForce spring = new SpringForce(100f)
+                .setStiffness(SpringForce.STIFFNESS_MEDIUM)
+                .setDampingRatio(SpringForce.DAMPING_RATIO_MEDIUM_BOUNCY);
+        long timeToRest = spring.getTimeToRest(0f, 0f, threshold);
+        assertTrue(timeToRest > 0);
+        assertEquals(100f, spring.getValueAt(0f, 0f, timeToRest), threshold);
+
+        assertEquals(0, spring.getTimeToRest(100f, 0f, threshold));
+    }
+
+    /**
+     * Verify that getTimeToRest() finds the same time as stepping the spring until it is at rest,
+     * for all kinds of damping.
+     */
+    @Test
+    public void testTimeToRestMatchesStepping() {
+        float threshold = 0.1f;
+        float[] dampingRatios = {SpringForce.DAMPING_RATIO_HIGH_BOUNCY,
+                SpringForce.DAMPING_RATIO_NO_BOUNCY, 2f};
+        for (float dampingRatio : dampingRatios) {
+            SpringForce spring = new SpringForce(100f)
+                    .setStiffness(SpringForce.STIFFNESS_LOW)
+                    .setDampingRatio(dampingRatio);
+            long timeToRest = spring.getTimeToRest(0f, 500f, threshold);
+            long time = 0;
+            while (Math.abs(spring.getValueAt(0f, 500f, time) - 100f) >= threshold
+                    || Math.abs(spring.getVelocityAt(0f, 500f, time)) >= threshold * 1000 / 16) {
+                time++;
+            }
+            assertEquals(time, timeToRest, 1);
+        }
+    }
+
+    /**
+     * Verify that getTimeToRest() returns in bounded time for a barely damped spring and a tiny
+     * threshold, and that the spring is at rest at the returned time.
+     */
+    @Test
+    public void testTimeToRestBarelyDamped() {
+        float threshold = 0.0001f;
+        SpringForce spring = new SpringForce(100f)
+                .setStiffness(SpringForce.STIFFNESS_HIGH)
+                .setDampingRatio(0.0001f);
+        long timeToRest = spring.getTimeToRest(0f, 1000f, threshold);
+        assertTrue(timeToRest > 10000);
+        assertEquals(100f, spring.getValueAt(0f, 1000f, timeToRest), threshold);
+    }
+
+    /**
+     * Verify that getTimeToRest() throws for a threshold that is not positive.
+     */
+    @Test
+    public void testTimeToRestInvalidThreshold() {
+        mExpectedException.expect(IllegalArgumentException.class);
+        new SpringForce(100f).getTimeToRest(0f, 0f, 0f);
+    }
+
+    /**
+     * Verify that getTimeToRest() throws for an undamped spring.
+     */
+    @Test
+    public void testTimeToRestUndamped() {
+        mExpectedException.expect(UnsupportedOperationException.class);
+        new SpringForce(100f).setDampingRatio(0f).getTimeToRest(0f, 0f, 0.5f);
+    }
+
     static class MyEndListener implements DynamicAnimation.OnAnimationEndListener {
         public long endTime = -1;
 
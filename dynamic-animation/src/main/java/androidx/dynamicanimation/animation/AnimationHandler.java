@@ -57,7 +57,15 @@ class AnimationHandler {
      */
     class AnimationCallbackDispatcher {
         void dispatchAnimationFrame() {
-            mCurrentFrameTime = SystemClock.uptimeMillis();
+            dispatchAnimationFrame(SystemClock.uptimeMillis());
+        }
+
+        /**
+         * Notifies the on-going animations of a new frame that started at the given time, in the
+         * {@link SystemClock#uptimeMillis()} time base.
+         */
+        void dispatchAnimationFrame(long frameTime) {
+            mCurrentFrameTime = frameTime;
             AnimationHandler.this.doAnimationFrame(mCurrentFrameTime);
             if (mAnimationCallbacks.size() > 0) {
                 getProvider().postFrameCallback();
@@ -66,6 +74,7 @@ class AnimationHandler {
     }
 
     private static final long FRAME_DELAY_MS = 10;
+    private static final long NANOS_PER_MS = 1000000;
     public static final ThreadLocal<AnimationHandler> sAnimatorHandler = new ThreadLocal<>();
 
     /**
@@ -77,6 +86,7 @@ class AnimationHandler {
     private final ArrayList<AnimationFrameCallback> mAnimationCallbacks = new ArrayList<>();
     private final AnimationCallbackDispatcher mCallbackDispatcher =
             new AnimationCallbackDispatcher();
+    private final SpringTransitionCache mSpringTransitionCache = new SpringTransitionCache();
 
     private AnimationFrameCallbackProvider mProvider;
     private long mCurrentFrameTime = 0;
@@ -104,6 +114,10 @@ class AnimationHandler {
         mProvider = provider;
     }
 
+    AnimationCallbackDispatcher getCallbackDispatcher() {
+        return mCallbackDispatcher;
+    }
+
     private AnimationFrameCallbackProvider getProvider() {
         if (mProvider == null) {
             if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.JELLY_BEAN) {
@@ -115,6 +129,13 @@ class AnimationHandler {
         return mProvider;
     }
 
+    /**
+     * Returns the cache of spring transitions shared by all springs stepped in the current frame.
+     */
+    SpringTransitionCache getSpringTransitionCache() {
+        return mSpringTransitionCache;
+    }
+
     /**
      * Register to get a callback on the next frame after the delay.
      */
@@ -145,12 +166,15 @@ class AnimationHandler {
 
     private void doAnimationFrame(long frameTime) {
         long currentTime = SystemClock.uptimeMillis();
+        // All springs advance by the same time in this frame, so transitions computed for one
+        // spring can be reused by every other spring with the same configuration.
+        mSpringTransitionCache.clear();
         for (int i = 0; i < mAnimationCallbacks.size(); i++) {
             final AnimationFrameCallback callback = mAnimationCallbacks.get(i);
             if (callback == null) {
                 continue;
             }
-            if (isCallbackDue(callback, currentTime)) {
+            if (mDelayedCallbackStartTime.isEmpty() || isCallbackDue(callback, currentTime)) {
                 callback.doAnimationFrame(frameTime);
             }
         }
@@ -177,11 +201,19 @@ class AnimationHandler {
 
     private void cleanUpList() {
         if (mListDirty) {
-            for (int i = mAnimationCallbacks.size() - 1; i >= 0; i--) {
-                if (mAnimationCallbacks.get(i) == null) {
-                    mAnimationCallbacks.remove(i);
+            // Compact the list in a single pass rather than removing entries one at a time, which
+            // would shift the tail of the list for every animation that ended in this frame.
+            final int size = mAnimationCallbacks.size();
+            int newSize = 0;
+            for (int i = 0; i < size; i++) {
+                final AnimationFrameCallback callback = mAnimationCallbacks.get(i);
+                if (callback != null) {
+                    mAnimationCallbacks.set(newSize++, callback);
                 }
             }
+            for (int i = size - 1; i >= newSize; i--) {
+                mAnimationCallbacks.remove(i);
+            }
             mListDirty = false;
         }
     }
@@ -200,7 +232,9 @@ class AnimationHandler {
             mChoreographerCallback = new Choreographer.FrameCallback() {
                     @Override
                     public void doFrame(long frameTimeNanos) {
-                        mDispatcher.dispatchAnimationFrame();
+                        // Use the vsync time of the frame so that steps are evenly spaced
+                        // regardless of when in the frame the callback happens to run.
+                        mDispatcher.dispatchAnimationFrame(frameTimeNanos / NANOS_PER_MS);
                     }
                 };
         }
@@ -79,6 +79,9 @@ public final class SpringForce implements Force {
     // is a reasonable threshold.
     private static final double VELOCITY_THRESHOLD_MULTIPLIER = 1000.0 / 16.0;
 
+    // Maximum number of steps getTimeToRest() takes to find when a spring comes to rest.
+    private static final int MAX_REST_STEPS = 10000;
+
     // Natural frequency
     double mNaturalFreq = Math.sqrt(STIFFNESS_MEDIUM);
     // Damping ratio.
@@ -106,6 +109,9 @@ public final class SpringForce implements Force {
     // Internal state to hold a value/velocity pair.
     private final DynamicAnimation.MassState mMassState = new DynamicAnimation.MassState();
 
+    // Scratch space for the transition matrix of the current step.
+    private final double[] mTransition = new double[SpringTransitionCache.MATRIX_SIZE];
+
     /**
      * Creates a spring force. Note that final position of the spring must be set through
      * {@link #setFinalPosition(float)} before the spring animation starts.
@@ -206,6 +212,139 @@ public final class SpringForce implements Force {
         return (float) mFinalPosition;
     }
 
+    /**
+     * Returns the value of a spring at the given time after it was released from
+     * {@code startValue} with {@code startVelocity}. Since the spring is evaluated in closed form,
+     * the result does not depend on how often, or whether, intermediate values were computed.
+     * This makes it possible to seek to or scrub through any point of a spring animation.
+     * <p>
+     * The final position of the spring must be set before calling this method. Min and max values
+     * of a {@link SpringAnimation} are not taken into account.
+     *
+     * @param startValue value of the spring at time 0
+     * @param startVelocity velocity of the spring at time 0, in units per second
+     * @param timeMillis time since the spring was released, in milliseconds
+     * @return value of the spring at the given time
+     * @throws IllegalStateException if the final position of the spring has not been set
+     */
+    public float getValueAt(float startValue, float startVelocity, long timeMillis) {
+        init();
+        final double[] transition = mTransition;
+        computeTransition(timeMillis / 1000d, transition);
+        double displacement = startValue - mFinalPosition;
+        return (float) (transition[0] * displacement + transition[1] * startVelocity
+                + mFinalPosition);
+    }
+
+    /**
+     * Returns the velocity of a spring at the given time after it was released from
+     * {@code startValue} with {@code startVelocity}.
+     *
+     * @param startValue value of the spring at time 0
+     * @param startVelocity velocity of the spring at time 0, in units per second
+     * @param timeMillis time since the spring was released, in milliseconds
+     * @return velocity of the spring at the given time, in units per second
+     * @throws IllegalStateException if the final position of the spring has not been set
+     * @see #getValueAt(float, float, long)
+     */
+    public float getVelocityAt(float startValue, float startVelocity, long timeMillis) {
+        init();
+        final double[] transition = mTransition;
+        computeTransition(timeMillis / 1000d, transition);
+        double displacement = startValue - mFinalPosition;
+        return (float) (transition[2] * displacement + transition[3] * startVelocity);
+    }
+
+    /**
+     * Returns the time it takes for a spring released from {@code startValue} with
+     * {@code startVelocity} to come to rest, which is the first time at which it is within
+     * {@code valueThreshold} of the final position and moves slowly enough to not visibly move
+     * past that threshold within a frame. This is the same condition a {@link SpringAnimation}
+     * uses to end, evaluated with a resolution of one millisecond, or coarser for springs that
+     * take longer than ten seconds to come to rest.
+     *
+     * @param startValue value of the spring at time 0
+     * @param startVelocity velocity of the spring at time 0, in units per second
+     * @param valueThreshold distance to the final position under which the spring may be
+     *                       considered at rest
+     * @return time until the spring comes to rest, in milliseconds
+     * @throws IllegalArgumentException if the value threshold is not positive
+     * @throws IllegalStateException if the final position of the spring has not been set
+     * @throws UnsupportedOperationException if the spring is undamped and never comes to rest
+     */
+    public long getTimeToRest(float startValue, float startVelocity,
+            @FloatRange(from = 0.0, fromInclusive = false) float valueThreshold) {
+        if (!(valueThreshold > 0)) {
+            throw new IllegalArgumentException("Value threshold must be positive");
+        }
+        if (mDampingRatio <= 0) {
+            throw new UnsupportedOperationException("Springs can only come to rest when there is"
+                    + " damping");
+        }
+        init();
+        final double valueLimit = valueThreshold;
+        final double velocityLimit = valueLimit * VELOCITY_THRESHOLD_MULTIPLIER;
+        double displacement = startValue - mFinalPosition;
+        double velocity = startVelocity;
+        // The spring is guaranteed to be at rest once its decay envelope is below both limits,
+        // which bounds the search for the first time it is.
+        final long maxTime = (long) Math.ceil(
+                getSettleTime(displacement, velocity, valueLimit, velocityLimit) * 1000) + 1;
+        final long stepTime = Math.max(1, (maxTime + MAX_REST_STEPS - 1) / MAX_REST_STEPS);
+        // The transition for a fixed step is the same for every step, so each iteration is a
+        // single matrix multiplication.
+        final double[] step = mTransition;
+        computeTransition(stepTime / 1000d, step);
+        long time = 0;
+        while (time < maxTime
+                && (Math.abs(displacement) >= valueLimit || Math.abs(velocity) >= velocityLimit)) {
+            double nextDisplacement = step[0] * displacement + step[1] * velocity;
+            velocity = step[2] * displacement + step[3] * velocity;
+            displacement = nextDisplacement;
+            time += stepTime;
+        }
+        return Math.min(time, maxTime);
+    }
+
+    /**
+     * Returns the time in seconds after which the displacement and velocity of a damped spring
+     * released with the given displacement and velocity stay below the given limits. This
+     * bounds both by an exponentially decaying envelope {@code amplitude * e^(-rate * t)}.
+     */
+    private double getSettleTime(double displacement, double velocity, double valueLimit,
+            double velocityLimit) {
+        final double valueAmplitude;
+        final double velocityAmplitude;
+        final double rate;
+        if (mDampingRatio > 1) {
+            // Over damping: the slower of the two exponentials dominates
+            double c2 = (mGammaPlus * displacement - velocity) / (mGammaPlus - mGammaMinus);
+            double c1 = displacement - c2;
+            valueAmplitude = Math.abs(c1) + Math.abs(c2);
+            velocityAmplitude = Math.abs(c1 * mGammaPlus) + Math.abs(c2 * mGammaMinus);
+            rate = -mGammaPlus;
+        } else if (mDampingRatio == 1) {
+            // Critical damping: (c1 + c2 * t) * e^(-w * t). As t * e^(-w * t / 2) is at most
+            // 2 / (e * w), the envelope decays at half the natural frequency.
+            double c2 = velocity + mNaturalFreq * displacement;
+            valueAmplitude = Math.abs(displacement) + 2 * Math.abs(c2) / (Math.E * mNaturalFreq);
+            velocityAmplitude = Math.abs(c2 - mNaturalFreq * displacement)
+                    + 2 * Math.abs(c2) / Math.E;
+            rate = mNaturalFreq / 2;
+        } else {
+            // Under damping: sinusoids of the damped frequency within e^(-zeta * w * t)
+            double decay = mDampingRatio * mNaturalFreq;
+            double sinCoeff = (velocity + decay * displacement) / mDampedFreq;
+            double velocitySinCoeff = -decay * sinCoeff - mDampedFreq * displacement;
+            valueAmplitude = Math.hypot(displacement, sinCoeff);
+            velocityAmplitude = Math.hypot(velocity, velocitySinCoeff);
+            rate = decay;
+        }
+        double valueTime = Math.log(valueAmplitude / valueLimit);
+        double velocityTime = Math.log(velocityAmplitude / velocityLimit);
+        return Math.max(0, Math.max(valueTime, velocityTime)) / rate;
+    }
+
     /*********************** Below are private APIs *********************/
 
     /**
@@ -275,44 +414,57 @@ public final class SpringForce implements Force {
             long timeElapsed) {
         init();
 
-        double deltaT = timeElapsed / 1000d; // unit: seconds
+        final double[] transition = mTransition;
+        final SpringTransitionCache cache =
+                AnimationHandler.getInstance().getSpringTransitionCache();
+        if (!cache.get(mNaturalFreq, mDampingRatio, timeElapsed, transition)) {
+            computeTransition(timeElapsed / 1000d, transition);
+            cache.put(mNaturalFreq, mDampingRatio, timeElapsed, transition);
+        }
+
         lastDisplacement -= mFinalPosition;
-        double displacement;
-        double currentVelocity;
+        double displacement = transition[0] * lastDisplacement + transition[1] * lastVelocity;
+        double currentVelocity = transition[2] * lastDisplacement + transition[3] * lastVelocity;
+
+        mMassState.mValue = (float) (displacement + mFinalPosition);
+        mMassState.mVelocity = (float) currentVelocity;
+        return mMassState;
+    }
+
+    /**
+     * Computes the matrix that maps the displacement and velocity of the spring to their values
+     * {@code deltaT} seconds later. The result is stored in {@code out} as
+     * {displacement from displacement, displacement from velocity, velocity from displacement,
+     * velocity from velocity}.
+     */
+    private void computeTransition(double deltaT, double[] out) {
         if (mDampingRatio > 1) {
             // Overdamped
-            double coeffA =  lastDisplacement - (mGammaMinus * lastDisplacement - lastVelocity)
-                    / (mGammaMinus - mGammaPlus);
-            double coeffB =  (mGammaMinus * lastDisplacement - lastVelocity)
-                    / (mGammaMinus - mGammaPlus);
-            displacement = coeffA * Math.pow(Math.E, mGammaMinus * deltaT)
-                    + coeffB * Math.pow(Math.E, mGammaPlus * deltaT);
-            currentVelocity = coeffA * mGammaMinus * Math.pow(Math.E, mGammaMinus * deltaT)
-                    + coeffB * mGammaPlus * Math.pow(Math.E, mGammaPlus * deltaT);
+            double gammaDiff = mGammaMinus - mGammaPlus;
+            double expMinus = Math.pow(Math.E, mGammaMinus * deltaT);
+            double expPlus = Math.pow(Math.E, mGammaPlus * deltaT);
+            out[0] = (mGammaMinus * expPlus - mGammaPlus * expMinus) / gammaDiff;
+            out[1] = (expMinus - expPlus) / gammaDiff;
+            out[2] = mGammaMinus * mGammaPlus * (expPlus - expMinus) / gammaDiff;
+            out[3] = (mGammaMinus * expMinus - mGammaPlus * expPlus) / gammaDiff;
         } else if (mDampingRatio == 1) {
             // Critically damped
-            double coeffA = lastDisplacement;
-            double coeffB = lastVelocity + mNaturalFreq * lastDisplacement;
-            displacement = (coeffA + coeffB * deltaT) * Math.pow(Math.E, -mNaturalFreq * deltaT);
-            currentVelocity = (coeffA + coeffB * deltaT) * Math.pow(Math.E, -mNaturalFreq * deltaT)
-                    * (-mNaturalFreq) + coeffB * Math.pow(Math.E, -mNaturalFreq * deltaT);
+            double decay = Math.pow(Math.E, -mNaturalFreq * deltaT);
+            out[0] = (1 + mNaturalFreq * deltaT) * decay;
+            out[1] = deltaT * decay;
+            out[2] = -mNaturalFreq * mNaturalFreq * deltaT * decay;
+            out[3] = (1 - mNaturalFreq * deltaT) * decay;
         } else {
             // Underdamped
-            double cosCoeff = lastDisplacement;
-            double sinCoeff = (1 / mDampedFreq) * (mDampingRatio * mNaturalFreq
-                    * lastDisplacement + lastVelocity);
-            displacement = Math.pow(Math.E, -mDampingRatio * mNaturalFreq * deltaT)
-                    * (cosCoeff * Math.cos(mDampedFreq * deltaT)
-                    + sinCoeff * Math.sin(mDampedFreq * deltaT));
-            currentVelocity = displacement * (-mNaturalFreq) * mDampingRatio
-                    + Math.pow(Math.E, -mDampingRatio * mNaturalFreq * deltaT)
-                    * (-mDampedFreq * cosCoeff * Math.sin(mDampedFreq * deltaT)
-                    + mDampedFreq * sinCoeff * Math.cos(mDampedFreq * deltaT));
+            double decay = Math.pow(Math.E, -mDampingRatio * mNaturalFreq * deltaT);
+            double cos = Math.cos(mDampedFreq * deltaT);
+            double sin = Math.sin(mDampedFreq * deltaT);
+            double dampingTerm = mDampingRatio * mNaturalFreq / mDampedFreq * sin;
+            out[0] = decay * (cos + dampingTerm);
+            out[1] = decay * sin / mDampedFreq;
+            out[2] = -decay * sin * mNaturalFreq * mNaturalFreq / mDampedFreq;
+            out[3] = decay * (cos - dampingTerm);
         }
-
-        mMassState.mValue = (float) (displacement + mFinalPosition);
-        mMassState.mVelocity = (float) currentVelocity;
-        return mMassState;
     }
 
     /**
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.dynamicanimation.animation;
+
+/**
+ * Caches spring state transitions computed during one animation frame.
+ * <p>
+ * The position and velocity of a spring after a given time are linear in its displacement and
+ * velocity at the start of that time, so a step can be described by a 2x2 transition matrix
+ * that only depends on the spring's natural frequency, damping ratio and the elapsed time. All
+ * animations driven by {@link AnimationHandler} advance by the same elapsed time in a frame, so
+ * springs sharing a configuration can share the matrix and skip the exponential and
+ * trigonometric evaluations. Entries are stored as parallel arrays and the cache is cleared at
+ * the start of every frame.
+ */
+final class SpringTransitionCache {
+    private static final int CAPACITY = 16;
+
+    // Number of entries of a transition matrix: the displacement row followed by the velocity row.
+    static final int MATRIX_SIZE = 4;
+
+    private final double[] mNaturalFreqs = new double[CAPACITY];
+    private final double[] mDampingRatios = new double[CAPACITY];
+    private final long[] mTimesElapsed = new long[CAPACITY];
+    private final double[] mMatrices = new double[CAPACITY * MATRIX_SIZE];
+    private int mSize;
+    private int mNextSlot;
+
+    /**
+     * Removes all cached transitions.
+     */
+    void clear() {
+        mSize = 0;
+        mNextSlot = 0;
+    }
+
+    /**
+     * Copies the cached transition for the given spring configuration into {@code matrix}.
+     *
+     * @return true if a transition was found, false otherwise
+     */
+    boolean get(double naturalFreq, double dampingRatio, long timeElapsed, double[] matrix) {
+        for (int i = 0; i < mSize; i++) {
+            if (mTimesElapsed[i] == timeElapsed && mNaturalFreqs[i] == naturalFreq
+                    && mDampingRatios[i] == dampingRatio) {
+                System.arraycopy(mMatrices, i * MATRIX_SIZE, matrix, 0, MATRIX_SIZE);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Stores the transition for the given spring configuration, replacing the oldest entry if
+     * the cache is full.
+     */
+    void put(double naturalFreq, double dampingRatio, long timeElapsed, double[] matrix) {
+        int slot = mNextSlot;
+        mNextSlot = (mNextSlot + 1) % CAPACITY;
+        if (mSize < CAPACITY) {
+            mSize++;
+        }
+        mNaturalFreqs[slot] = naturalFreq;
+        mDampingRatios[slot] = dampingRatio;
+        mTimesElapsed[slot] = timeElapsed;
+        System.arraycopy(matrix, 0, mMatrices, slot * MATRIX_SIZE, MATRIX_SIZE);
+    }
+}
@@ -752,6 +752,49 @@ public class FragmentLifecycleTest {
         assertFalse("fragment reported state saved after destroy", f.isStateSaved());
     }
 
+    @Test
+    @UiThreadTest
+    public void testSavedStateCaching() throws Throwable {
+        FragmentController fc = startupFragmentController(null);
+        FragmentManager fm = fc.getSupportFragmentManager();
+
+        SaveStateFragment fragment = SaveStateFragment.create(1);
+        fragment.setSavedStateCachingEnabled(true);
+        fm.beginTransaction()
+                .add(fragment, "1")
+                .commitNow();
+
+        fc.dispatchPause();
+        fc.saveAllState();
+        assertEquals(1, fragment.getSaveCount());
+
+        // Nothing changed, so the previously saved state should be reused
+        fc.saveAllState();
+        assertEquals(1, fragment.getSaveCount());
+
+        // Changing lifecycle state discards the cached state
+        fc.dispatchStop();
+        fc.saveAllState();
+        assertEquals(2, fragment.getSaveCount());
+
+        fragment.invalidateCachedSavedState();
+        Parcelable savedState = fc.saveAllState();
+        assertEquals(3, fragment.getSaveCount());
+
+        // A state reused from the cache should restore just like a freshly saved one
+        savedState = fc.saveAllState();
+        assertEquals(3, fragment.getSaveCount());
+        fc.dispatchDestroy();
+
+        fc = startupFragmentController(savedState);
+        fm = fc.getSupportFragmentManager();
+        fragment = (SaveStateFragment) fm.findFragmentByTag("1");
+        assertNotNull(fragment);
+        assertEquals(1, fragment.getValue());
+        assertFalse(fragment.isSavedStateCachingEnabled());
+        shutdownFragmentController(fc);
+    }
+
     @Test
     @UiThreadTest
     public void testSetArgumentsLifecycle() throws Throwable {
@@ -1546,6 +1589,7 @@ public class FragmentLifecycleTest {
     public static class SaveStateFragment extends Fragment {
         private static final String VALUE_KEY = "SaveStateFragment.mValue";
         private int mValue;
+        private int mSaveCount;
 
         public static SaveStateFragment create(int value) {
             SaveStateFragment saveStateFragment = new SaveStateFragment();
@@ -1557,6 +1601,7 @@ public class FragmentLifecycleTest {
         public void onSaveInstanceState(Bundle outState) {
             super.onSaveInstanceState(outState);
             outState.putInt(VALUE_KEY, mValue);
+            mSaveCount++;
         }
 
         @Override
@@ -1570,6 +1615,10 @@ public class FragmentLifecycleTest {
         public int getValue() {
             return mValue;
         }
+
+        public int getSaveCount() {
+            return mSaveCount;
+        }
     }
 
     public static class RemoveHelloInOnResume extends Fragment {
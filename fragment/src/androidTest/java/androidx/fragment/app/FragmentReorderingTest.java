@@ -17,14 +17,17 @@ package androidx.fragment.app;
 
 import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNull;
 import static org.junit.Assert.assertTrue;
 
 import android.app.Instrumentation;
 import android.support.test.InstrumentationRegistry;
 import android.support.test.annotation.UiThreadTest;
+import android.support.test.filters.LargeTest;
 import android.support.test.filters.MediumTest;
 import android.support.test.rule.ActivityTestRule;
 import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
 import android.view.View;
 import android.view.ViewGroup;
 import android.widget.EditText;
@@ -40,6 +43,9 @@ import org.junit.runner.RunWith;
 @MediumTest
 @RunWith(AndroidJUnit4.class)
 public class FragmentReorderingTest {
+    private static final String TAG = "FragmentReorderingTest";
+    private static final int BURST_SIZE = 20;
+
     @Rule
     public ActivityTestRule<FragmentTestActivity> mActivityRule =
             new ActivityTestRule<FragmentTestActivity>(FragmentTestActivity.class);
@@ -680,4 +686,98 @@ public class FragmentReorderingTest {
         assertTrue(editText.isFocused());
         assertFalse(firstEditText.isFocused());
     }
+
+    // Test that a burst of committed replace transactions only creates the View of the last
+    // fragment when coalescing is enabled, while every transaction is kept on the back stack.
+    @UiThreadTest
+    @Test
+    public void coalescedReplaceBurst() throws Throwable {
+        mFM.setTransactionCoalescingEnabled(true);
+        final CountCallsFragment[] fragments = commitReplaceBurst(true);
+        mFM.executePendingTransactions();
+
+        FragmentTestUtil.assertChildren(mContainer, fragments[BURST_SIZE - 1]);
+        assertEquals(BURST_SIZE, mFM.getBackStackEntryCount());
+        for (int i = 0; i < BURST_SIZE - 1; i++) {
+            assertEquals(0, fragments[i].onCreateViewCount);
+        }
+        assertEquals(1, fragments[BURST_SIZE - 1].onCreateViewCount);
+
+        // Popping still goes through each transaction of the burst
+        mFM.popBackStackImmediate();
+        FragmentTestUtil.assertChildren(mContainer, fragments[BURST_SIZE - 2]);
+        assertEquals(1, fragments[BURST_SIZE - 2].onCreateViewCount);
+        assertEquals(BURST_SIZE - 1, mFM.getBackStackEntryCount());
+    }
+
+    // Test that fragments added and removed within a coalesced burst do not stay active.
+    @UiThreadTest
+    @Test
+    public void coalescedReplaceBurstWithoutBackStack() throws Throwable {
+        mFM.setTransactionCoalescingEnabled(true);
+        final CountCallsFragment[] fragments = commitReplaceBurst(false);
+        mFM.executePendingTransactions();
+
+        FragmentTestUtil.assertChildren(mContainer, fragments[BURST_SIZE - 1]);
+        for (int i = 0; i < BURST_SIZE - 1; i++) {
+            assertEquals(0, fragments[i].onAttachCount);
+            assertFalse(fragments[i].isAdded());
+            assertNull(mFM.findFragmentByTag(Integer.toString(i)));
+        }
+        int active = 0;
+        final FragmentManagerImpl fm = (FragmentManagerImpl) mFM;
+        for (int i = 0; i < fm.mActive.size(); i++) {
+            if (fm.mActive.valueAt(i) != null) {
+                active++;
+            }
+        }
+        assertEquals(1, active);
+    }
+
+    // Compares the time spent executing a burst of replace transactions with and without
+    // coalescing.
+    @LargeTest
+    @UiThreadTest
+    @Test
+    public void replaceBurstBenchmark() throws Throwable {
+        final CountCallsFragment[] serial = commitReplaceBurst(true);
+        final long serialTime = timeExecutePendingTransactions();
+        FragmentTestUtil.assertChildren(mContainer, serial[BURST_SIZE - 1]);
+
+        mFM.setTransactionCoalescingEnabled(true);
+        final CountCallsFragment[] coalesced = commitReplaceBurst(true);
+        final long coalescedTime = timeExecutePendingTransactions();
+        FragmentTestUtil.assertChildren(mContainer, coalesced[BURST_SIZE - 1]);
+
+        int serialViews = 0;
+        int coalescedViews = 0;
+        for (int i = 0; i < BURST_SIZE; i++) {
+            serialViews += serial[i].onCreateViewCount;
+            coalescedViews += coalesced[i].onCreateViewCount;
+        }
+        assertEquals(BURST_SIZE, serialViews);
+        assertEquals(1, coalescedViews);
+        Log.d(TAG, BURST_SIZE + " queued replaces: serial " + serialTime / 1000 + "us, "
+                + "coalesced " + coalescedTime / 1000 + "us");
+    }
+
+    private long timeExecutePendingTransactions() {
+        final long start = System.nanoTime();
+        mFM.executePendingTransactions();
+        return System.nanoTime() - start;
+    }
+
+    private CountCallsFragment[] commitReplaceBurst(boolean addToBackStack) {
+        final CountCallsFragment[] fragments = new CountCallsFragment[BURST_SIZE];
+        for (int i = 0; i < BURST_SIZE; i++) {
+            fragments[i] = new CountCallsFragment();
+            FragmentTransaction transaction = mFM.beginTransaction()
+                    .replace(R.id.fragmentContainer, fragments[i], Integer.toString(i));
+            if (addToBackStack) {
+                transaction.addToBackStack(null);
+            }
+            transaction.commit();
+        }
+        return fragments;
+    }
 }
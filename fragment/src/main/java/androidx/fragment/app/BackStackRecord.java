@@ -675,6 +675,9 @@ final class BackStackRecord extends FragmentTransaction implements
             pw.close();
         }
         mCommitted = true;
+        if (mManager.mCoalesceTransactions) {
+            mReorderingAllowed = true;
+        }
         if (mAddToBackStack) {
             mIndex = mManager.allocBackStackIndex(this);
         } else {
@@ -217,6 +217,14 @@ public class Fragment implements ComponentCallbacks, OnCreateContextMenuListener
     // Hint provided by the app that this fragment is currently visible to the user.
     boolean mUserVisibleHint = true;
 
+    // Whether the state saved by the FragmentManager may be reused by later saves as long as
+    // nothing marked it as stale, see setSavedStateCachingEnabled().
+    boolean mSavedStateCachingEnabled;
+    // The state last saved by the FragmentManager while caching was enabled and whether it is
+    // still valid. The state itself may be null if the fragment had nothing to save.
+    Bundle mCachedSavedState;
+    boolean mHasCachedSavedState;
+
     // The animation and transition information for the fragment. This will be null
     // unless the elements are explicitly accessed and should remain null for Fragments
     // without Views.
@@ -640,6 +648,7 @@ public class Fragment implements ComponentCallbacks, OnCreateContextMenuListener
         }
         mTarget = fragment;
         mTargetRequestCode = requestCode;
+        invalidateCachedSavedState();
     }
 
     /**
@@ -966,6 +975,55 @@ public class Fragment implements ComponentCallbacks, OnCreateContextMenuListener
         return mRetainInstance;
     }
 
+    /**
+     * Control whether the state saved for this fragment by its FragmentManager may be reused
+     * by later saves. This is useful for activities with many fragments on the back stack,
+     * whose state is otherwise saved again on every
+     * {@link android.app.Activity#onSaveInstanceState(Bundle)} even though it rarely changes.
+     *
+     * <p>When enabled, the state is only reused while the fragment has no view, since a view
+     * hierarchy can change its own state at any time. The cached state is discarded whenever
+     * the fragment or one of its child fragments changes lifecycle state, or when its target
+     * fragment or user visible hint change. A fragment that keeps other state which it saves
+     * in {@link #onSaveInstanceState(Bundle)} must call {@link #invalidateCachedSavedState()}
+     * whenever that state changes. While the cached state is reused,
+     * {@link #onSaveInstanceState(Bundle)} and
+     * {@link FragmentManager.FragmentLifecycleCallbacks#onFragmentSaveInstanceState} are not
+     * called for this fragment.</p>
+     *
+     * @param enabled true to allow reusing saved state, false to save it every time (the
+     *                default)
+     */
+    public void setSavedStateCachingEnabled(boolean enabled) {
+        mSavedStateCachingEnabled = enabled;
+        if (!enabled) {
+            invalidateCachedSavedState();
+        }
+    }
+
+    /**
+     * Returns whether the saved state of this fragment may be reused by later saves.
+     *
+     * @see #setSavedStateCachingEnabled(boolean)
+     */
+    public boolean isSavedStateCachingEnabled() {
+        return mSavedStateCachingEnabled;
+    }
+
+    /**
+     * Discards the state cached for this fragment, so that it is saved again the next time
+     * its FragmentManager saves its state. This also discards the state cached for the parent
+     * fragment, if any, as it includes the state of this fragment.
+     *
+     * @see #setSavedStateCachingEnabled(boolean)
+     */
+    public void invalidateCachedSavedState() {
+        for (Fragment f = this; f != null; f = f.mParentFragment) {
+            f.mCachedSavedState = null;
+            f.mHasCachedSavedState = false;
+        }
+    }
+
     /**
      * Report that this fragment would like to participate in populating
      * the options menu by receiving a call to {@link #onCreateOptionsMenu}
@@ -1022,6 +1080,7 @@ public class Fragment implements ComponentCallbacks, OnCreateContextMenuListener
             mFragmentManager.performPendingDeferredStart(this);
         }
         mUserVisibleHint = isVisibleToUser;
+        invalidateCachedSavedState();
         mDeferStart = mState < STARTED && !isVisibleToUser;
         if (mSavedFragmentState != null) {
             // Ensure that if the user visible hint is set before the Fragment has
@@ -459,6 +459,36 @@ public abstract class FragmentManager {
      */
     public abstract boolean isStateSaved();
 
+    /**
+     * Control whether transactions committed with {@link FragmentTransaction#commit()} or
+     * {@link FragmentTransaction#commitAllowingStateLoss()} are coalesced with the other
+     * pending transactions before being executed.
+     *
+     * <p>When enabled, every such transaction behaves as if
+     * {@link FragmentTransaction#setReorderingAllowed(boolean)} had been set to true, so a burst
+     * of transactions queued before the next execution, such as rapidly switching between
+     * tabs, is run as a single batch: only the net result of the burst moves fragments
+     * through their lifecycle, and fragments added and removed again within the burst never
+     * have their views created. Transactions added to the back stack are still recorded and
+     * can be popped individually.</p>
+     *
+     * <p>This has the same side effects as allowing reordering on each transaction: fragments
+     * may be created before the fragments they replace are destroyed, and postponed
+     * transitions apply. It does not affect transactions that were committed before it was
+     * enabled, nor {@link FragmentTransaction#commitNow()}.</p>
+     *
+     * @param enabled true to coalesce committed transactions, false to execute them one by one
+     *                unless they allow reordering (the default)
+     */
+    public abstract void setTransactionCoalescingEnabled(boolean enabled);
+
+    /**
+     * Returns whether committed transactions are coalesced before being executed.
+     *
+     * @see #setTransactionCoalescingEnabled(boolean)
+     */
+    public abstract boolean isTransactionCoalescingEnabled();
+
     /**
      * Callback interface for listening to fragment state changes that happen
      * within a given FragmentManager.
@@ -711,6 +741,7 @@ final class FragmentManagerImpl extends FragmentManager implements LayoutInflate
     boolean mDestroyed;
     String mNoTransactionsBecause;
     boolean mHavePendingDeferredStart;
+    boolean mCoalesceTransactions;
 
     // Temporary vars for removing redundant operations in BackStackRecords:
     ArrayList<BackStackRecord> mTmpRecords;
@@ -1335,6 +1366,9 @@ final class FragmentManagerImpl extends FragmentManager implements LayoutInflate
         if (f.mDeferStart && f.mState < Fragment.STARTED && newState > Fragment.ACTIVITY_CREATED) {
             newState = Fragment.ACTIVITY_CREATED;
         }
+        if (f.mState != newState) {
+            f.invalidateCachedSavedState();
+        }
         if (f.mState <= newState) {
             // For fragments that are created from a layout, when restoring from
             // state we don't want to allow them to be created until they are
@@ -1783,6 +1817,13 @@ final class FragmentManagerImpl extends FragmentManager implements LayoutInflate
         }
         moveToState(f, nextState, f.getNextTransition(), f.getNextTransitionStyle(), false);
 
+        if (f.mRemoving && f.mState == Fragment.INITIALIZING && !f.isInBackStack()
+                && !f.mRetaining) {
+            // The fragment was added and removed again in the same batch of reordered
+            // transactions and never got created, so nothing else will free its index.
+            makeInactive(f);
+        }
+
         if (f.mView != null) {
             // Move the view if it is out of order
             Fragment underFragment = findFragmentUnder(f);
@@ -2094,6 +2135,16 @@ final class FragmentManagerImpl extends FragmentManager implements LayoutInflate
         return mStateSaved || mStopped;
     }
 
+    @Override
+    public void setTransactionCoalescingEnabled(boolean enabled) {
+        mCoalesceTransactions = enabled;
+    }
+
+    @Override
+    public boolean isTransactionCoalescingEnabled() {
+        return mCoalesceTransactions;
+    }
+
     /**
      * Adds an action to the queue of pending actions.
      *
@@ -2933,6 +2984,23 @@ final class FragmentManagerImpl extends FragmentManager implements LayoutInflate
         return result;
     }
 
+    /**
+     * Returns the number of bytes the given state takes once written to a Parcel. This is
+     * expensive and only meant for debug logging.
+     */
+    private static int getParcelledSize(Bundle state) {
+        if (state == null) {
+            return 0;
+        }
+        Parcel parcel = Parcel.obtain();
+        try {
+            parcel.writeBundle(state);
+            return parcel.dataSize();
+        } finally {
+            parcel.recycle();
+        }
+    }
+
     Parcelable saveAllState() {
         // Make sure all pending operations have now been executed to get
         // our state update-to-date.
@@ -2965,7 +3033,12 @@ final class FragmentManagerImpl extends FragmentManager implements LayoutInflate
                 FragmentState fs = new FragmentState(f);
                 active[i] = fs;
 
-                if (f.mState > Fragment.INITIALIZING && fs.mSavedFragmentState == null) {
+                final long saveStartTime = DEBUG ? System.nanoTime() : 0;
+                if (f.mState > Fragment.INITIALIZING && fs.mSavedFragmentState == null
+                        && f.mHasCachedSavedState && f.mView == null) {
+                    // Nothing changed since the last save, reuse the state saved back then.
+                    fs.mSavedFragmentState = f.mCachedSavedState;
+                } else if (f.mState > Fragment.INITIALIZING && fs.mSavedFragmentState == null) {
                     fs.mSavedFragmentState = saveFragmentBasicState(f);
 
                     if (f.mTarget != null) {
@@ -2986,12 +3059,20 @@ final class FragmentManagerImpl extends FragmentManager implements LayoutInflate
                         }
                     }
 
+                    if (f.mSavedStateCachingEnabled) {
+                        f.mCachedSavedState = fs.mSavedFragmentState;
+                        f.mHasCachedSavedState = true;
+                    }
                 } else {
                     fs.mSavedFragmentState = f.mSavedFragmentState;
                 }
 
-                if (DEBUG) Log.v(TAG, "Saved state of " + f + ": "
-                        + fs.mSavedFragmentState);
+                if (DEBUG) {
+                    Log.v(TAG, "Saved state of " + f + " in "
+                            + (System.nanoTime() - saveStartTime) / 1000
+                            + "us, " + getParcelledSize(fs.mSavedFragmentState) + " bytes: "
+                            + fs.mSavedFragmentState);
+                }
             }
         }
 
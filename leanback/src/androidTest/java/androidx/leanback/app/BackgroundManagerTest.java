@@ -28,6 +28,7 @@ import android.graphics.Paint;
 import android.graphics.drawable.BitmapDrawable;
 import android.graphics.drawable.ColorDrawable;
 import android.graphics.drawable.Drawable;
+import android.net.Uri;
 import android.os.Bundle;
 import android.support.test.filters.LargeTest;
 import android.support.test.runner.AndroidJUnit4;
@@ -39,6 +40,9 @@ import org.junit.Test;
 import org.junit.rules.TestName;
 import org.junit.runner.RunWith;
 
+import java.io.File;
+import java.io.FileOutputStream;
+
 @LargeTest
 @RunWith(AndroidJUnit4.class)
 public class BackgroundManagerTest {
@@ -267,6 +271,95 @@ public class BackgroundManagerTest {
         testSwitchBackgrounds(manager);
     }
 
+    Uri writeBitmap(String name, Bitmap bitmap) throws Exception {
+        File file = new File(mRule.getActivity().getCacheDir(), name + ".png");
+        FileOutputStream out = new FileOutputStream(file);
+        try {
+            bitmap.compress(Bitmap.CompressFormat.PNG, 100, out);
+        } finally {
+            out.close();
+        }
+        return Uri.fromFile(file);
+    }
+
+    @Test
+    public void setBitmapUri() throws Throwable {
+        TestActivity.Provider provider1 = new TestActivity.Provider() {
+            @Override
+            public void onAttachedToWindow(TestActivity activity) {
+                BackgroundManager.getInstance(activity).attach(activity.getWindow());
+            }
+
+            @Override
+            public void onStart(TestActivity activity) {
+                BackgroundManager.getInstance(activity).setColor(Color.BLUE);
+            }
+        };
+        mRule = new TestActivity.TestActivityTestRule(provider1,
+                generateProviderName("activity1"));
+        final TestActivity activity1 = mRule.launchActivity();
+
+        final BackgroundManager manager = BackgroundManager.getInstance(activity1);
+        waitForBackgroundAnimationFinish(manager);
+        final Uri redUri = writeBitmap(mUnitTestName.getMethodName() + "_red",
+                createBitmap(200, 100, Color.RED));
+        final Uri greenUri = writeBitmap(mUnitTestName.getMethodName() + "_green",
+                createBitmap(200, 100, Color.GREEN));
+
+        // A decode superseded by another background is never applied
+        mRule.runOnUiThread(new Runnable() {
+            @Override
+            public void run() {
+                manager.setBitmapUri(greenUri);
+                manager.setColor(Color.YELLOW);
+            }
+        });
+        waitForBackgroundAnimationFinish(manager);
+        Thread.sleep(500);
+        waitForBackgroundAnimationFinish(manager);
+        assertIsColorDrawable(manager, Color.YELLOW);
+
+        mRule.runOnUiThread(new Runnable() {
+            @Override
+            public void run() {
+                manager.setBitmapUri(redUri);
+            }
+        });
+        PollingCheck.waitFor(5000/* timeout */, new PollingCheck.PollingCheckCondition() {
+            @Override
+            public boolean canPreProceed() {
+                return false;
+            }
+
+            @Override
+            public boolean canProceed() {
+                return manager.mBackgroundDrawable instanceof BackgroundManager.BitmapDrawable;
+            }
+        });
+        waitForBackgroundAnimationFinish(manager);
+        final Bitmap decoded = ((BackgroundManager.BitmapDrawable) manager.mBackgroundDrawable)
+                .getBitmap();
+        final int widthPx = activity1.getResources().getDisplayMetrics().widthPixels;
+        final int heightPx = activity1.getResources().getDisplayMetrics().heightPixels;
+        // Decoded backgrounds are scaled to the screen size ahead of drawing
+        assertEquals(widthPx, decoded.getWidth());
+        assertEquals(heightPx, decoded.getHeight());
+        assertEquals(Color.RED, decoded.getPixel(widthPx / 2, heightPx / 2));
+        assertIsBitmapDrawable(manager, decoded);
+
+        setColorAndVerify(manager, Color.BLUE);
+
+        // Setting the same uri again reuses the cached background
+        mRule.runOnUiThread(new Runnable() {
+            @Override
+            public void run() {
+                manager.setBitmapUri(redUri);
+            }
+        });
+        waitForBackgroundAnimationFinish(manager);
+        assertIsBitmapDrawable(manager, decoded);
+    }
+
     @Test
     public void multipleSetBitmaps() throws Throwable {
         TestActivity.Provider provider1 = new TestActivity.Provider() {
@@ -19,6 +19,12 @@ package androidx.leanback.widget;
 import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
 import static org.junit.Assert.assertTrue;
+import static org.mockito.Matchers.anyInt;
+import static org.mockito.Matchers.eq;
+import static org.mockito.Mockito.mock;
+import static org.mockito.Mockito.times;
+import static org.mockito.Mockito.verify;
+import static org.mockito.Mockito.when;
 
 import android.content.Context;
 import android.graphics.Color;
@@ -34,6 +40,7 @@ import android.widget.FrameLayout;
 
 import androidx.core.view.ViewCompat;
 import androidx.leanback.R;
+import androidx.recyclerview.widget.RecyclerView;
 
 import org.junit.Test;
 import org.junit.runner.RunWith;
@@ -1214,4 +1221,131 @@ public class ListRowPresenterTest {
         assertTrue(presenter.getShadowEnabled());
         assertTrue(presenter.isKeepChildForeground());
     }
+
+    int getVisibleChildCount(ViewGroup group) {
+        int count = 0;
+        for (int i = 0; i < group.getChildCount(); i++) {
+            View child = group.getChildAt(i);
+            if (child.getRight() > 0 && child.getLeft() < group.getWidth()) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    ListRowPresenter.ViewHolder bindNewRow() {
+        final ListRowPresenter.ViewHolder[] holder = new ListRowPresenter.ViewHolder[1];
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                final ViewGroup parent = new FrameLayout(mContext);
+                Presenter.ViewHolder containerVh = mListRowPresenter.onCreateViewHolder(parent);
+                holder[0] = (ListRowPresenter.ViewHolder) mListRowPresenter.getRowViewHolder(
+                        containerVh);
+                mListRowPresenter.onBindViewHolder(holder[0], mRow);
+            }
+        });
+        return holder[0];
+    }
+
+    @Test
+    public void visibleItemPrefetch() {
+        final ArrayObjectAdapter arrayAdapter = new ArrayObjectAdapter(new DummyPresenter());
+        for (int i = 0; i < 30; i++) {
+            arrayAdapter.add("item" + i);
+        }
+        ListRowPresenter presenter = new ListRowPresenter();
+        assertFalse(presenter.isVisibleItemPrefetchEnabled());
+        presenter.setVisibleItemPrefetchEnabled(true);
+        setup(presenter, arrayAdapter);
+        int visibleCount = getVisibleChildCount(mListVh.getGridView());
+        assertTrue(visibleCount > 4);
+        assertTrue(visibleCount < arrayAdapter.size());
+
+        // Rows bound after the first layout prefetch as many items as a row shows
+        assertEquals(visibleCount, bindNewRow().getGridView().getInitialPrefetchItemCount());
+    }
+
+    @Test
+    public void visibleItemPrefetchDisabled() {
+        final ArrayObjectAdapter arrayAdapter = new ArrayObjectAdapter(new DummyPresenter());
+        for (int i = 0; i < 30; i++) {
+            arrayAdapter.add("item" + i);
+        }
+        ListRowPresenter presenter = new ListRowPresenter();
+        presenter.setVisibleItemPrefetchEnabled(false);
+        setup(presenter, arrayAdapter);
+
+        ListRowPresenter.ViewHolder vh = bindNewRow();
+        assertEquals(4, vh.getGridView().getInitialPrefetchItemCount());
+        assertFalse(vh.getGridView().getLayoutManager().isItemPrefetchEnabled());
+    }
+
+    @Test
+    public void visibleItemPrefetchOfNextRow() {
+        final ArrayObjectAdapter arrayAdapter = new ArrayObjectAdapter(new DummyPresenter());
+        for (int i = 0; i < 30; i++) {
+            arrayAdapter.add("item" + i);
+        }
+        final ListRowPresenter presenter = new ListRowPresenter();
+        presenter.setVisibleItemPrefetchEnabled(true);
+        final ArrayObjectAdapter rowsAdapter = new ArrayObjectAdapter(presenter);
+        for (int i = 0; i < 10; i++) {
+            rowsAdapter.add(new ListRow(arrayAdapter));
+        }
+        final VerticalGridView parent = new VerticalGridView(mContext);
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                parent.setAdapter(new ItemBridgeAdapter(rowsAdapter));
+                parent.getLayoutManager().setItemPrefetchEnabled(true);
+                layout(parent, 1000, 1000);
+            }
+        });
+        final HorizontalGridView firstRow = getRowGridView(parent.getChildAt(0));
+        final int visibleCount = getVisibleChildCount(firstRow);
+        assertTrue(visibleCount > 4);
+        final int nextPosition = parent.getChildAdapterPosition(
+                parent.getChildAt(parent.getChildCount() - 1)) + 1;
+        assertTrue(nextPosition < rowsAdapter.size());
+
+        // The parent grid prefetches the next row when scrolling towards it.
+        RecyclerView.State state = mock(RecyclerView.State.class);
+        when(state.getItemCount()).thenReturn(rowsAdapter.size());
+        RecyclerView.LayoutManager.LayoutPrefetchRegistry registry =
+                mock(RecyclerView.LayoutManager.LayoutPrefetchRegistry.class);
+        parent.getLayoutManager().collectAdjacentPrefetchPositions(0, 10, state, registry);
+        verify(registry).addPosition(eq(nextPosition), anyInt());
+
+        // The next row, once bound, prefetches the items the first row shows.
+        final RecyclerView.ViewHolder[] nextRowHolder = new RecyclerView.ViewHolder[1];
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                RecyclerView.Adapter adapter = parent.getAdapter();
+                nextRowHolder[0] = adapter.createViewHolder(parent,
+                        adapter.getItemViewType(nextPosition));
+                adapter.bindViewHolder(nextRowHolder[0], nextPosition);
+            }
+        });
+        final HorizontalGridView nextRow = getRowGridView(nextRowHolder[0].itemView);
+        assertTrue(nextRow.getLayoutManager().isItemPrefetchEnabled());
+        registry = mock(RecyclerView.LayoutManager.LayoutPrefetchRegistry.class);
+        nextRow.getLayoutManager().collectInitialPrefetchPositions(arrayAdapter.size(),
+                registry);
+        verify(registry, times(visibleCount)).addPosition(anyInt(), anyInt());
+        for (int i = 0; i < visibleCount; i++) {
+            verify(registry).addPosition(i, 0);
+        }
+    }
+
+    static void layout(View view, int width, int height) {
+        view.measure(View.MeasureSpec.makeMeasureSpec(width, View.MeasureSpec.EXACTLY),
+                View.MeasureSpec.makeMeasureSpec(height, View.MeasureSpec.EXACTLY));
+        view.layout(0, 0, width, height);
+    }
+
+    static HorizontalGridView getRowGridView(View rowView) {
+        return (HorizontalGridView) rowView.findViewById(R.id.row_content);
+    }
 }
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.leanback.widget;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNotNull;
+import static org.junit.Assert.assertSame;
+import static org.junit.Assert.assertTrue;
+
+import android.graphics.Bitmap;
+import android.graphics.Canvas;
+import android.graphics.Color;
+import android.graphics.Paint;
+import android.os.SystemClock;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.MediumTest;
+import android.support.test.runner.AndroidJUnit4;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.io.ByteArrayInputStream;
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+
+@MediumTest
+@RunWith(AndroidJUnit4.class)
+public class PlaybackSeekSpriteDataProviderTest {
+    static final int COLUMNS = 4;
+    static final int ROWS = 2;
+    static final int THUMB_SIZE = 10;
+    static final int NUM_THUMBS = 40;
+
+    static int getColor(int index) {
+        return Color.rgb(index * 5, 255 - index * 5, 0);
+    }
+
+    static class SpriteProvider extends PlaybackSeekSpriteDataProvider {
+        final List<Integer> mOpenedSheets = new ArrayList<>();
+        CountDownLatch mGate;
+
+        SpriteProvider() {
+            super(createPositions(), COLUMNS, ROWS);
+        }
+
+        static long[] createPositions() {
+            long[] positions = new long[NUM_THUMBS];
+            for (int i = 0; i < positions.length; i++) {
+                positions[i] = i * 1000;
+            }
+            return positions;
+        }
+
+        @Override
+        protected InputStream openSpriteSheet(int sheetIndex) throws IOException {
+            synchronized (mOpenedSheets) {
+                mOpenedSheets.add(sheetIndex);
+            }
+            if (mGate != null) {
+                try {
+                    mGate.await(5, TimeUnit.SECONDS);
+                } catch (InterruptedException e) {
+                    throw new IOException(e);
+                }
+            }
+            Bitmap sheet = Bitmap.createBitmap(COLUMNS * THUMB_SIZE, ROWS * THUMB_SIZE,
+                    Bitmap.Config.ARGB_8888);
+            Canvas canvas = new Canvas(sheet);
+            Paint paint = new Paint();
+            for (int i = 0; i < COLUMNS * ROWS; i++) {
+                paint.setColor(getColor(sheetIndex * COLUMNS * ROWS + i));
+                int left = (i % COLUMNS) * THUMB_SIZE;
+                int top = (i / COLUMNS) * THUMB_SIZE;
+                canvas.drawRect(left, top, left + THUMB_SIZE, top + THUMB_SIZE, paint);
+            }
+            ByteArrayOutputStream out = new ByteArrayOutputStream();
+            sheet.compress(Bitmap.CompressFormat.PNG, 100, out);
+            return new ByteArrayInputStream(out.toByteArray());
+        }
+
+        List<Integer> getOpenedSheets() {
+            synchronized (mOpenedSheets) {
+                return new ArrayList<>(mOpenedSheets);
+            }
+        }
+    }
+
+    static class Result extends PlaybackSeekDataProvider.ResultCallback {
+        final CountDownLatch mLatch = new CountDownLatch(1);
+        Bitmap mBitmap;
+        int mIndex = -1;
+
+        @Override
+        public void onThumbnailLoaded(Bitmap bitmap, int index) {
+            mBitmap = bitmap;
+            mIndex = index;
+            mLatch.countDown();
+        }
+
+        boolean await() throws InterruptedException {
+            return mLatch.await(5, TimeUnit.SECONDS);
+        }
+    }
+
+    void getThumbnail(final PlaybackSeekDataProvider provider, final int index,
+            final Result result) {
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                provider.getThumbnail(index, result);
+            }
+        });
+    }
+
+    @Test
+    public void loadsThumbnailFromSheet() throws Throwable {
+        final SpriteProvider provider = new SpriteProvider();
+        final Result result = new Result();
+        getThumbnail(provider, 9, result);
+        assertTrue(result.await());
+        assertEquals(9, result.mIndex);
+        assertEquals(THUMB_SIZE, result.mBitmap.getWidth());
+        assertEquals(THUMB_SIZE, result.mBitmap.getHeight());
+        assertEquals(getColor(9), result.mBitmap.getPixel(THUMB_SIZE / 2, THUMB_SIZE / 2));
+
+        // Thumbnails of other sheets in the window are loaded as well
+        final Result prefetched = new Result();
+        getThumbnail(provider, 18, prefetched);
+        assertTrue(prefetched.await());
+        assertEquals(getColor(18), prefetched.mBitmap.getPixel(THUMB_SIZE / 2, THUMB_SIZE / 2));
+
+        // Cached thumbnails are returned without decoding their sheet again
+        final int openCount = provider.getOpenedSheets().size();
+        final Result cached = new Result();
+        getThumbnail(provider, 9, cached);
+        assertEquals(9, cached.mIndex);
+        assertSame(result.mBitmap, cached.mBitmap);
+        assertEquals(openCount, provider.getOpenedSheets().size());
+    }
+
+    @Test
+    public void skipsSheetsOutsideOfWindow() throws Throwable {
+        // Occupy the worker thread so that the following requests are queued
+        final SpriteProvider blocker = new SpriteProvider();
+        blocker.mGate = new CountDownLatch(1);
+        blocker.setPrefetchWindowSize(0);
+        final Result blockerResult = new Result();
+        getThumbnail(blocker, 0, blockerResult);
+
+        final SpriteProvider provider = new SpriteProvider();
+        provider.setPrefetchWindowSize(0);
+        final Result result0 = new Result();
+        final Result result20 = new Result();
+        final Result result39 = new Result();
+        getThumbnail(provider, 0, result0);
+        getThumbnail(provider, 20, result20);
+        getThumbnail(provider, 39, result39);
+        blocker.mGate.countDown();
+
+        assertTrue(result39.await());
+        assertEquals(getColor(39), result39.mBitmap.getPixel(THUMB_SIZE / 2, THUMB_SIZE / 2));
+        assertNotNull(blockerResult.await() ? blockerResult.mBitmap : null);
+        List<Integer> opened = provider.getOpenedSheets();
+        assertEquals(1, opened.size());
+        assertEquals(39 / (COLUMNS * ROWS), (int) opened.get(0));
+        assertFalse(result0.await());
+    }
+
+    @Test
+    public void reloadsSkippedSheetRequestedAgain() throws Throwable {
+        // Occupy the worker thread so that the following requests are queued
+        final SpriteProvider blocker = new SpriteProvider();
+        blocker.mGate = new CountDownLatch(1);
+        blocker.setPrefetchWindowSize(0);
+        getThumbnail(blocker, 0, new Result());
+
+        final SpriteProvider provider = new SpriteProvider();
+        provider.setPrefetchWindowSize(0);
+        final Result result = new Result();
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                provider.getThumbnail(0, new Result());
+                provider.getThumbnail(39, new Result());
+                blocker.mGate.countDown();
+                // Once the last sheet is opened the first one was skipped, and the main thread
+                // did not process that yet.
+                final long end = SystemClock.uptimeMillis() + 5000;
+                while (!provider.getOpenedSheets().contains(39 / (COLUMNS * ROWS))
+                        && SystemClock.uptimeMillis() < end) {
+                    SystemClock.sleep(10);
+                }
+                provider.getThumbnail(0, result);
+            }
+        });
+
+        assertTrue(result.await());
+        assertEquals(getColor(0), result.mBitmap.getPixel(THUMB_SIZE / 2, THUMB_SIZE / 2));
+    }
+
+    @Test
+    public void resetCancelsPendingRequests() throws Throwable {
+        final SpriteProvider provider = new SpriteProvider();
+        final Result result = new Result();
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                provider.getThumbnail(3, result);
+                provider.reset();
+            }
+        });
+        assertFalse(result.await());
+    }
+}
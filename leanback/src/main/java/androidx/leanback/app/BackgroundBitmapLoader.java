@@ -0,0 +1,203 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License
+ * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing permissions and limitations under
+ * the License.
+ */
+package androidx.leanback.app;
+
+import android.content.ContentResolver;
+import android.graphics.Bitmap;
+import android.graphics.BitmapFactory;
+import android.graphics.Canvas;
+import android.graphics.Matrix;
+import android.graphics.Paint;
+import android.net.Uri;
+import android.os.Handler;
+import android.os.SystemClock;
+import android.util.Log;
+
+import androidx.collection.LruCache;
+import androidx.core.os.TraceCompat;
+import androidx.leanback.util.BackgroundExecutor;
+
+import java.io.IOException;
+import java.io.InputStream;
+
+/**
+ * Decodes background images on a worker thread for {@link BackgroundManager}.
+ * <p>
+ * Images are downsampled while decoding and then scaled and cropped to exactly fill the
+ * screen, so that drawing them does not need any further scaling. Only the most recent request
+ * is delivered: a request that is superseded before its decode starts is skipped, and one that
+ * is superseded while decoding is only kept in the cache. Decoded backgrounds are kept in a
+ * cache bounded by their size in bytes, which is emptied when the activity stops.
+ */
+final class BackgroundBitmapLoader {
+    static final String TAG = "BackgroundBitmapLoader";
+    static final boolean DEBUG = BackgroundManager.DEBUG;
+
+    // Number of screen sized backgrounds kept in the cache.
+    private static final int MAX_CACHED_BACKGROUNDS = 3;
+
+    /**
+     * Called on the main thread with the decoded bitmap of the latest request, or null if it
+     * could not be decoded.
+     */
+    interface Callback {
+        void onBitmapLoaded(Uri uri, Bitmap bitmap);
+    }
+
+    final ContentResolver mResolver;
+    final Handler mHandler;
+    final int mWidthPx;
+    final int mHeightPx;
+    final LruCache<Uri, Bitmap> mCache;
+    // Incremented on the main thread for every request and cancellation, read by the worker to
+    // skip superseded requests.
+    volatile int mGeneration;
+
+    BackgroundBitmapLoader(ContentResolver resolver, Handler handler, int widthPx,
+            int heightPx) {
+        mResolver = resolver;
+        mHandler = handler;
+        mWidthPx = widthPx;
+        mHeightPx = heightPx;
+        mCache = new LruCache<Uri, Bitmap>(
+                Math.max(1, MAX_CACHED_BACKGROUNDS * widthPx * heightPx * 4)) {
+            @Override
+            protected int sizeOf(Uri key, Bitmap value) {
+                return value.getByteCount();
+            }
+        };
+    }
+
+    /**
+     * Returns the cached background decoded from the given uri, or null.
+     */
+    Bitmap getCachedBitmap(Uri uri) {
+        return mCache.get(uri);
+    }
+
+    /**
+     * Decodes the given uri on a worker thread, superseding all previous requests.
+     */
+    void load(final Uri uri, final Callback callback) {
+        final int generation = ++mGeneration;
+        BackgroundExecutor.get().execute(new Runnable() {
+            @Override
+            public void run() {
+                if (generation != mGeneration) {
+                    if (DEBUG) Log.v(TAG, "skipping superseded request " + uri);
+                    return;
+                }
+                final Bitmap bitmap = decode(uri);
+                mHandler.post(new Runnable() {
+                    @Override
+                    public void run() {
+                        if (bitmap != null) {
+                            mCache.put(uri, bitmap);
+                        }
+                        if (generation == mGeneration) {
+                            callback.onBitmapLoaded(uri, bitmap);
+                        }
+                    }
+                });
+            }
+        });
+    }
+
+    /**
+     * Drops the pending request, if any.
+     */
+    void cancel() {
+        mGeneration++;
+    }
+
+    /**
+     * Drops all cached backgrounds, keeping the pending request.
+     */
+    void evictCache() {
+        mCache.evictAll();
+    }
+
+    /**
+     * Drops the pending request and all cached backgrounds.
+     */
+    void clear() {
+        cancel();
+        evictCache();
+    }
+
+    Bitmap decode(Uri uri) {
+        TraceCompat.beginSection("BackgroundBitmapLoader decode");
+        final long startTime = SystemClock.elapsedRealtime();
+        try {
+            BitmapFactory.Options options = new BitmapFactory.Options();
+            options.inJustDecodeBounds = true;
+            decodeStream(uri, options);
+            if (options.outWidth <= 0 || options.outHeight <= 0) {
+                if (DEBUG) Log.v(TAG, "invalid bitmap bounds for " + uri);
+                return null;
+            }
+            final int width = options.outWidth;
+            final int height = options.outHeight;
+            int sampleSize = 1;
+            while (width / (sampleSize * 2) >= mWidthPx && height / (sampleSize * 2) >= mHeightPx) {
+                sampleSize *= 2;
+            }
+            options.inJustDecodeBounds = false;
+            options.inSampleSize = sampleSize;
+            Bitmap bitmap = decodeStream(uri, options);
+            if (bitmap == null) {
+                return null;
+            }
+            Bitmap result = scaleToScreen(bitmap);
+            if (DEBUG) {
+                Log.v(TAG, "decoded " + uri + " (" + width + "x" + height + ", sample size "
+                        + sampleSize + ") in " + (SystemClock.elapsedRealtime() - startTime)
+                        + "ms");
+            }
+            return result;
+        } catch (IOException | RuntimeException e) {
+            Log.w(TAG, "Failed to decode " + uri, e);
+            return null;
+        } finally {
+            TraceCompat.endSection();
+        }
+    }
+
+    private Bitmap decodeStream(Uri uri, BitmapFactory.Options options) throws IOException {
+        InputStream in = mResolver.openInputStream(uri);
+        if (in == null) {
+            return null;
+        }
+        try {
+            return BitmapFactory.decodeStream(in, null, options);
+        } finally {
+            in.close();
+        }
+    }
+
+    private Bitmap scaleToScreen(Bitmap bitmap) {
+        Matrix matrix = BackgroundManager.createCoverMatrix(bitmap.getWidth(), bitmap.getHeight(),
+                mWidthPx, mHeightPx);
+        if (matrix == null) {
+            return bitmap;
+        }
+        Bitmap result = Bitmap.createBitmap(mWidthPx, mHeightPx, bitmap.getConfig() != null
+                ? bitmap.getConfig() : Bitmap.Config.ARGB_8888);
+        Canvas canvas = new Canvas(result);
+        canvas.drawBitmap(bitmap, matrix, new Paint(Paint.FILTER_BITMAP_FLAG));
+        canvas.setBitmap(null);
+        bitmap.recycle();
+        return result;
+    }
+}
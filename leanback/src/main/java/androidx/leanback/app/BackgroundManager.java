@@ -29,6 +29,7 @@ import android.graphics.PixelFormat;
 import android.graphics.drawable.ColorDrawable;
 import android.graphics.drawable.Drawable;
 import android.graphics.drawable.LayerDrawable;
+import android.net.Uri;
 import android.os.Build;
 import android.os.Handler;
 import android.util.Log;
@@ -73,6 +74,10 @@ import java.lang.ref.WeakReference;
  *   {@link #setDrawable}), which may be in transition</li>
  * </ul>
  *
+ * <p>Images that still need to be decoded can be set with {@link #setBitmapUri}, which
+ * decodes and scales them to the screen size on a worker thread and keeps the last few
+ * decoded backgrounds in memory.
+ *
  * <p>BackgroundManager holds references to potentially large bitmap Drawables.
  * Call {@link #release} to release these references when the Activity is not
  * visible.
@@ -105,6 +110,7 @@ public final class BackgroundManager {
     Drawable mBackgroundDrawable;
     private boolean mAttached;
     private long mLastSetTime;
+    private BackgroundBitmapLoader mBitmapLoader;
 
     private final Interpolator mAccelerateInterpolator;
     private final Interpolator mDecelerateInterpolator;
@@ -626,6 +632,9 @@ public final class BackgroundManager {
     void onStop() {
         if (isAutoReleaseOnStop()) {
             release();
+        } else if (mBitmapLoader != null) {
+            // Keep the pending request but do not hold screen sized bitmaps while not visible.
+            mBitmapLoader.evictCache();
         }
     }
 
@@ -732,6 +741,9 @@ public final class BackgroundManager {
             mLayerDrawable = null;
         }
         mBackgroundDrawable = null;
+        if (mBitmapLoader != null) {
+            mBitmapLoader.clear();
+        }
     }
 
     /**
@@ -814,6 +826,12 @@ public final class BackgroundManager {
         mLayerDrawable.clearDrawable(R.id.background_imageout, mContext);
     }
 
+    private void cancelBitmapLoad() {
+        if (mBitmapLoader != null) {
+            mBitmapLoader.cancel();
+        }
+    }
+
     /**
      * Sets the background to the given color. The timing for when this becomes
      * visible in the app is undefined and may take place after a small delay.
@@ -821,6 +839,7 @@ public final class BackgroundManager {
     public void setColor(@ColorInt int color) {
         if (DEBUG) Log.v(TAG, "setColor " + Integer.toHexString(color));
 
+        cancelBitmapLoad();
         mService.setColor(color);
         mBackgroundColor = color;
         mBackgroundDrawable = null;
@@ -839,6 +858,7 @@ public final class BackgroundManager {
     public void setDrawable(Drawable drawable) {
         if (DEBUG) Log.v(TAG, "setBackgroundDrawable " + drawable);
 
+        cancelBitmapLoad();
         mService.setDrawable(drawable);
         mBackgroundDrawable = drawable;
         if (mLayerDrawable == null) {
@@ -907,36 +927,83 @@ public final class BackgroundManager {
             return;
         }
 
-        Matrix matrix = null;
+        Matrix matrix = createCoverMatrix(bitmap.getWidth(), bitmap.getHeight(), mWidthPx,
+                mHeightPx);
 
-        if ((bitmap.getWidth() != mWidthPx || bitmap.getHeight() != mHeightPx)) {
-            int dwidth = bitmap.getWidth();
-            int dheight = bitmap.getHeight();
-            float scale;
+        BitmapDrawable bitmapDrawable = new BitmapDrawable(mContext.getResources(), bitmap, matrix);
 
-            // Scale proportionately to fit width and height.
-            if (dwidth * mHeightPx > mWidthPx * dheight) {
-                scale = (float) mHeightPx / (float) dheight;
-            } else {
-                scale = (float) mWidthPx / (float) dwidth;
-            }
+        setDrawable(bitmapDrawable);
+    }
 
-            int subX = Math.min((int) (mWidthPx / scale), dwidth);
-            int dx = Math.max(0, (dwidth - subX) / 2);
+    /**
+     * Returns the matrix that scales an image of the given size to fill the given width and
+     * height, cropping it horizontally around its center, or null if the sizes match.
+     */
+    static Matrix createCoverMatrix(int dwidth, int dheight, int width, int height) {
+        if (dwidth == width && dheight == height) {
+            return null;
+        }
+        float scale;
 
-            matrix = new Matrix();
-            matrix.setScale(scale, scale);
-            matrix.preTranslate(-dx, 0);
+        // Scale proportionately to fit width and height.
+        if (dwidth * height > width * dheight) {
+            scale = (float) height / (float) dheight;
+        } else {
+            scale = (float) width / (float) dwidth;
+        }
 
-            if (DEBUG) {
-                Log.v(TAG, "original image size " + bitmap.getWidth() + "x" + bitmap.getHeight()
-                        + " scale " + scale + " dx " + dx);
-            }
+        int subX = Math.min((int) (width / scale), dwidth);
+        int dx = Math.max(0, (dwidth - subX) / 2);
+
+        Matrix matrix = new Matrix();
+        matrix.setScale(scale, scale);
+        matrix.preTranslate(-dx, 0);
+
+        if (DEBUG) {
+            Log.v(TAG, "original image size " + dwidth + "x" + dheight
+                    + " scale " + scale + " dx " + dx);
         }
+        return matrix;
+    }
 
-        BitmapDrawable bitmapDrawable = new BitmapDrawable(mContext.getResources(), bitmap, matrix);
+    /**
+     * Sets the image at the given uri into the background. The image is decoded and scaled
+     * to the screen size on a worker thread, then set as if by {@link #setBitmap(Bitmap)}.
+     * Any uri supported by {@link android.content.ContentResolver#openInputStream(Uri)} can be
+     * used.
+     *
+     * <p>Only the latest request is applied: setting another background before the image
+     * is decoded cancels it. The last few decoded backgrounds are kept in memory until
+     * {@link #release()}, so setting them again is immediate. If the image cannot be decoded,
+     * the background is left unchanged.</p>
+     *
+     * @param uri The uri of the image to decode, or null to clear the background.
+     */
+    public void setBitmapUri(Uri uri) {
+        if (DEBUG) Log.v(TAG, "setBitmapUri " + uri);
 
-        setDrawable(bitmapDrawable);
+        if (uri == null) {
+            setBitmap(null);
+            return;
+        }
+        if (mBitmapLoader == null) {
+            mBitmapLoader = new BackgroundBitmapLoader(mContext.getContentResolver(), mHandler,
+                    mWidthPx, mHeightPx);
+        }
+        Bitmap cached = mBitmapLoader.getCachedBitmap(uri);
+        if (cached != null) {
+            if (DEBUG) Log.v(TAG, "using cached background for " + uri);
+            setBitmap(cached);
+            return;
+        }
+        mBitmapLoader.load(uri, new BackgroundBitmapLoader.Callback() {
+            @Override
+            public void onBitmapLoaded(Uri loadedUri, Bitmap bitmap) {
+                if (bitmap != null && mAttached) {
+                    setBitmap(bitmap);
+                }
+            }
+        });
     }
 
     /**
@@ -977,7 +1044,10 @@ public final class BackgroundManager {
             return true;
         }
         if (first instanceof BitmapDrawable && second instanceof BitmapDrawable) {
-            if (((BitmapDrawable) first).getBitmap().sameAs(((BitmapDrawable) second).getBitmap())) {
+            Bitmap firstBitmap = ((BitmapDrawable) first).getBitmap();
+            Bitmap secondBitmap = ((BitmapDrawable) second).getBitmap();
+            // Backgrounds reused from the cache share their bitmap, skip comparing pixels then.
+            if (firstBitmap == secondBitmap || firstBitmap.sameAs(secondBitmap)) {
                 return true;
             }
         }
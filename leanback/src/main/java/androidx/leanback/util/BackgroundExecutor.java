@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License. You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under the License
+ * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+ * or implied. See the License for the specific language governing permissions and limitations under
+ * the License.
+ */
+package androidx.leanback.util;
+
+import android.os.Process;
+
+import androidx.annotation.RestrictTo;
+
+import java.util.concurrent.Executor;
+import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.ThreadFactory;
+import java.util.concurrent.ThreadPoolExecutor;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Background thread shared by leanback components to decode images. The thread is started on
+ * first use and stops after being idle for a few seconds.
+ * @hide
+ */
+@RestrictTo(RestrictTo.Scope.LIBRARY)
+public final class BackgroundExecutor {
+
+    private static final String THREAD_NAME = "LeanbackBackground";
+    private static final int KEEP_ALIVE_SECONDS = 10;
+
+    private static Executor sExecutor;
+
+    private BackgroundExecutor() {
+        // Prevent construction of this util class
+    }
+
+    /**
+     * Returns the shared executor. Tasks run one after the other, in the order they were
+     * submitted.
+     */
+    public static synchronized Executor get() {
+        if (sExecutor == null) {
+            ThreadPoolExecutor executor = new ThreadPoolExecutor(1, 1,
+                    KEEP_ALIVE_SECONDS, TimeUnit.SECONDS, new LinkedBlockingQueue<Runnable>(),
+                    new ThreadFactory() {
+                        @Override
+                        public Thread newThread(final Runnable runnable) {
+                            return new Thread(new Runnable() {
+                                @Override
+                                public void run() {
+                                    Process.setThreadPriority(Process.THREAD_PRIORITY_BACKGROUND);
+                                    runnable.run();
+                                }
+                            }, THREAD_NAME);
+                        }
+                    });
+            executor.allowCoreThreadTimeOut(true);
+            sExecutor = executor;
+        }
+        return sExecutor;
+    }
+}
@@ -20,6 +20,7 @@ import android.view.KeyEvent;
 import android.view.View;
 import android.view.ViewGroup;
 
+import androidx.core.os.TraceCompat;
 import androidx.leanback.R;
 import androidx.leanback.system.Settings;
 import androidx.leanback.transition.TransitionHelper;
@@ -46,6 +47,13 @@ import java.util.HashMap;
  * ListRowPresenter applies a default shadow to each child view.  Call
  * {@link #setShadowEnabled(boolean)} to disable shadows.  A subclass may override and return
  * false in {@link #isUsingDefaultShadow()} and replace with its own shadow implementation.
+ *
+ * <h3>Prefetch</h3>
+ * Call {@link #setVisibleItemPrefetchEnabled(boolean)} to prefetch the items of rows.
+ * ListRowPresenter then remembers how many items a row displays once it is laid out, and uses
+ * that number as the {@link BaseGridView#setInitialPrefetchItemCount(int) initial prefetch
+ * count} of rows bound afterwards. When the parent grid has item prefetch enabled, the items a
+ * row shows first are created and bound before the row scrolls into view.
  */
 public class ListRowPresenter extends RowPresenter {
 
@@ -292,6 +300,8 @@ public class ListRowPresenter extends RowPresenter {
     private int mBrowseRowsFadingEdgeLength = -1;
     private boolean mRoundedCornersEnabled = true;
     private boolean mKeepChildForeground = true;
+    private boolean mVisibleItemPrefetchEnabled;
+    private int mVisibleItemCount;
     private HashMap<Presenter, Integer> mRecycledPoolSize = new HashMap<Presenter, Integer>();
     ShadowOverlayHelper mShadowOverlayHelper;
     private ItemBridgeAdapter.Wrapper mShadowOverlayWrapper;
@@ -457,6 +467,29 @@ public class ListRowPresenter extends RowPresenter {
                 }
             });
         rowViewHolder.mGridView.setNumRows(mNumRows);
+        rowViewHolder.mGridView.addOnLayoutChangeListener(new View.OnLayoutChangeListener() {
+            @Override
+            public void onLayoutChange(View v, int left, int top, int right, int bottom,
+                    int oldLeft, int oldTop, int oldRight, int oldBottom) {
+                onRowLaidOut(rowViewHolder);
+            }
+        });
+    }
+
+    void onRowLaidOut(ViewHolder vh) {
+        final HorizontalGridView gridView = vh.mGridView;
+        final int width = gridView.getWidth();
+        int visibleCount = 0;
+        for (int i = 0, count = gridView.getChildCount(); i < count; i++) {
+            final View child = gridView.getChildAt(i);
+            if (child.getRight() > 0 && child.getLeft() < width) {
+                visibleCount++;
+            }
+        }
+        if (visibleCount == 0) {
+            return;
+        }
+        mVisibleItemCount = visibleCount;
     }
 
     final boolean needsDefaultListSelectEffect() {
@@ -652,12 +685,24 @@ public class ListRowPresenter extends RowPresenter {
 
     @Override
     protected void onBindRowViewHolder(RowPresenter.ViewHolder holder, Object item) {
-        super.onBindRowViewHolder(holder, item);
-        ViewHolder vh = (ViewHolder) holder;
-        ListRow rowItem = (ListRow) item;
-        vh.mItemBridgeAdapter.setAdapter(rowItem.getAdapter());
-        vh.mGridView.setAdapter(vh.mItemBridgeAdapter);
-        vh.mGridView.setContentDescription(rowItem.getContentDescription());
+        TraceCompat.beginSection("ListRowPresenter bind");
+        try {
+            super.onBindRowViewHolder(holder, item);
+            ViewHolder vh = (ViewHolder) holder;
+            ListRow rowItem = (ListRow) item;
+            if (mVisibleItemPrefetchEnabled) {
+                // Nested prefetch only collects the items of rows that allow prefetch.
+                vh.mGridView.getLayoutManager().setItemPrefetchEnabled(true);
+                if (mVisibleItemCount > 0) {
+                    vh.mGridView.setInitialPrefetchItemCount(mVisibleItemCount);
+                }
+            }
+            vh.mItemBridgeAdapter.setAdapter(rowItem.getAdapter());
+            vh.mGridView.setAdapter(vh.mItemBridgeAdapter);
+            vh.mGridView.setContentDescription(rowItem.getContentDescription());
+        } finally {
+            TraceCompat.endSection();
+        }
     }
 
     @Override
@@ -779,6 +824,31 @@ public class ListRowPresenter extends RowPresenter {
         return mKeepChildForeground;
     }
 
+    /**
+     * Enables or disables prefetching the items of each bound row. When enabled, item prefetch
+     * of each row's {@link HorizontalGridView} is enabled, and its initial prefetch count is set
+     * to the number of items rows display once laid out. The default value is false, which
+     * leaves the row's {@link HorizontalGridView} untouched.
+     *
+     * <p>Prefetching of a row's items only happens when the parent grid has item prefetch
+     * enabled, see {@link RecyclerView.LayoutManager#setItemPrefetchEnabled(boolean)}.</p>
+     *
+     * @param enabled true to prefetch the items visible in a row, false otherwise.
+     * @see BaseGridView#setInitialPrefetchItemCount(int)
+     */
+    public final void setVisibleItemPrefetchEnabled(boolean enabled) {
+        mVisibleItemPrefetchEnabled = enabled;
+    }
+
+    /**
+     * Returns true if the items of each bound row are prefetched, false otherwise.
+     *
+     * @see #setVisibleItemPrefetchEnabled(boolean)
+     */
+    public final boolean isVisibleItemPrefetchEnabled() {
+        return mVisibleItemPrefetchEnabled;
+    }
+
     /**
      * Create ShadowOverlayHelper Options.  Subclass may override.
      * e.g.
@@ -0,0 +1,305 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.leanback.widget;
+
+import android.graphics.Bitmap;
+import android.graphics.BitmapFactory;
+import android.os.Handler;
+import android.os.Looper;
+import android.os.SystemClock;
+import android.util.Log;
+import android.util.SparseArray;
+import android.util.SparseBooleanArray;
+
+import androidx.annotation.NonNull;
+import androidx.collection.LruCache;
+import androidx.leanback.util.BackgroundExecutor;
+
+import java.io.IOException;
+import java.io.InputStream;
+
+/**
+ * A {@link PlaybackSeekDataProvider} that loads thumbnails from sprite sheets, images holding
+ * a grid of thumbnails for consecutive seek positions.
+ *
+ * <p>Sprite sheets are opened with {@link #openSpriteSheet(int)} and decoded on a worker
+ * thread, and their thumbnails are kept in a cache bounded by its size in bytes. Around the
+ * position being seeked to, a window of {@link #getPrefetchWindowSize()} thumbnails on each
+ * side is loaded ahead of time, favoring the direction of the seek. Sprite sheets that fall
+ * outside of that window before their decoding starts are skipped, so fast scrubbing only
+ * decodes the sheets the user actually stops at.</p>
+ *
+ * <p>Thumbnail {@code i} of {@link #getSeekPositions()} is expected in sprite sheet
+ * {@code i / (columns * rows)}, at row {@code (i % (columns * rows)) / columns} and column
+ * {@code i % columns}. All thumbnails of a sheet have the same size.</p>
+ */
+public abstract class PlaybackSeekSpriteDataProvider extends PlaybackSeekDataProvider {
+    static final String TAG = "SeekSpriteProvider";
+    static final boolean DEBUG = false;
+
+    private static final int DEFAULT_MAX_CACHE_SIZE_BYTES = 8 * 1024 * 1024;
+    private static final int DEFAULT_PREFETCH_WINDOW_SIZE = 10;
+
+    final long[] mSeekPositions;
+    final int mColumns;
+    final int mRows;
+    final int mThumbsPerSheet;
+    final Handler mHandler = new Handler(Looper.getMainLooper());
+    final LruCache<Integer, Bitmap> mCache;
+    final SparseBooleanArray mLoadingSheets = new SparseBooleanArray();
+    final SparseArray<ResultCallback> mCallbacks = new SparseArray<>();
+    private int mPrefetchWindowSize = DEFAULT_PREFETCH_WINDOW_SIZE;
+    private int mLastRequestedIndex = -1;
+    // Range of sprite sheets a pending decode must overlap with to be worth running. Written on
+    // the UI thread, read by the worker.
+    volatile int mFirstSheetInWindow = -1;
+    volatile int mLastSheetInWindow = -1;
+    // Incremented by reset(), so that decodes started before do not deliver results.
+    int mGeneration;
+
+    /**
+     * Creates a provider using the default cache size.
+     *
+     * @param seekPositions Sorted seek positions, one for each thumbnail.
+     * @param columns Number of thumbnails in a row of a sprite sheet.
+     * @param rows Number of rows of thumbnails in a sprite sheet.
+     */
+    public PlaybackSeekSpriteDataProvider(@NonNull long[] seekPositions, int columns, int rows) {
+        this(seekPositions, columns, rows, DEFAULT_MAX_CACHE_SIZE_BYTES);
+    }
+
+    /**
+     * Creates a provider.
+     *
+     * @param seekPositions Sorted seek positions, one for each thumbnail.
+     * @param columns Number of thumbnails in a row of a sprite sheet.
+     * @param rows Number of rows of thumbnails in a sprite sheet.
+     * @param maxCacheSizeBytes Maximum total size in bytes of the cached thumbnails.
+     */
+    public PlaybackSeekSpriteDataProvider(@NonNull long[] seekPositions, int columns, int rows,
+            int maxCacheSizeBytes) {
+        if (columns <= 0 || rows <= 0) {
+            throw new IllegalArgumentException("Invalid sprite sheet layout " + columns + "x"
+                    + rows);
+        }
+        mSeekPositions = seekPositions;
+        mColumns = columns;
+        mRows = rows;
+        mThumbsPerSheet = columns * rows;
+        mCache = new LruCache<Integer, Bitmap>(maxCacheSizeBytes) {
+            @Override
+            protected int sizeOf(Integer key, Bitmap value) {
+                return value.getByteCount();
+            }
+        };
+    }
+
+    /**
+     * Opens the encoded image of the given sprite sheet. This method is called on a worker
+     * thread, and the returned stream is closed by the provider.
+     *
+     * @param sheetIndex Index of the sprite sheet, starting at 0.
+     * @return The encoded sprite sheet, or null if it is not available.
+     */
+    protected abstract InputStream openSpriteSheet(int sheetIndex) throws IOException;
+
+    /**
+     * Sets the number of thumbnails on each side of the requested one that are loaded ahead
+     * of time. Sprite sheets which do not hold any of these thumbnails are not decoded.
+     */
+    public void setPrefetchWindowSize(int size) {
+        mPrefetchWindowSize = size;
+    }
+
+    /**
+     * Returns the number of thumbnails on each side of the requested one that are loaded ahead
+     * of time.
+     */
+    public int getPrefetchWindowSize() {
+        return mPrefetchWindowSize;
+    }
+
+    @Override
+    public long[] getSeekPositions() {
+        return mSeekPositions;
+    }
+
+    @Override
+    public void getThumbnail(int index, ResultCallback callback) {
+        final boolean forward = index >= mLastRequestedIndex;
+        mLastRequestedIndex = index;
+        updateWindow(index);
+
+        Bitmap bitmap = mCache.get(index);
+        if (bitmap != null) {
+            mCallbacks.remove(index);
+            callback.onThumbnailLoaded(bitmap, index);
+        } else {
+            mCallbacks.put(index, callback);
+            loadSheet(index / mThumbsPerSheet);
+        }
+
+        // Load the sheets of the window, starting with the ones in the seek direction
+        final int first = mFirstSheetInWindow;
+        final int last = mLastSheetInWindow;
+        if (forward) {
+            for (int sheet = first; sheet <= last; sheet++) {
+                loadSheet(sheet);
+            }
+        } else {
+            for (int sheet = last; sheet >= first; sheet--) {
+                loadSheet(sheet);
+            }
+        }
+    }
+
+    private void updateWindow(int index) {
+        final int start = Math.max(0, index - mPrefetchWindowSize);
+        final int end = Math.min(mSeekPositions.length - 1, index + mPrefetchWindowSize);
+        mFirstSheetInWindow = start / mThumbsPerSheet;
+        mLastSheetInWindow = end / mThumbsPerSheet;
+        // Results outside of the window will not be displayed anymore.
+        for (int i = mCallbacks.size() - 1; i >= 0; i--) {
+            final int key = mCallbacks.keyAt(i);
+            if (key < start || key > end) {
+                mCallbacks.removeAt(i);
+            }
+        }
+    }
+
+    private boolean isSheetCached(int sheet) {
+        final int first = sheet * mThumbsPerSheet;
+        final int last = Math.min(first + mThumbsPerSheet, mSeekPositions.length) - 1;
+        // Thumbnails of a sheet are cached together, so checking both ends is enough unless
+        // some were evicted, in which case the sheet is decoded again.
+        return mCache.get(first) != null && mCache.get(last) != null;
+    }
+
+    private void loadSheet(final int sheet) {
+        if (mLoadingSheets.get(sheet) || isSheetCached(sheet)) {
+            return;
+        }
+        mLoadingSheets.put(sheet, true);
+        final int generation = mGeneration;
+        BackgroundExecutor.get().execute(new Runnable() {
+            @Override
+            public void run() {
+                final boolean skipped =
+                        sheet < mFirstSheetInWindow || sheet > mLastSheetInWindow;
+                final Bitmap[] thumbs;
+                if (skipped) {
+                    if (DEBUG) Log.v(TAG, "skipping sheet " + sheet + " outside of window");
+                    thumbs = null;
+                } else {
+                    thumbs = decodeSheet(sheet);
+                }
+                mHandler.post(new Runnable() {
+                    @Override
+                    public void run() {
+                        if (generation != mGeneration) {
+                            return;
+                        }
+                        mLoadingSheets.delete(sheet);
+                        if (thumbs != null) {
+                            onSheetLoaded(sheet, thumbs);
+                        } else if (skipped && sheet >= mFirstSheetInWindow
+                                && sheet <= mLastSheetInWindow) {
+                            // The sheet was requested again after it was skipped, while it
+                            // was still marked as loading.
+                            loadSheet(sheet);
+                        }
+                    }
+                });
+            }
+        });
+    }
+
+    void onSheetLoaded(int sheet, Bitmap[] thumbs) {
+        final int first = sheet * mThumbsPerSheet;
+        for (int i = 0; i < thumbs.length; i++) {
+            if (thumbs[i] != null) {
+                mCache.put(first + i, thumbs[i]);
+            }
+        }
+        for (int i = 0; i < thumbs.length; i++) {
+            final int index = first + i;
+            final ResultCallback callback = mCallbacks.get(index);
+            if (callback != null && thumbs[i] != null) {
+                mCallbacks.remove(index);
+                callback.onThumbnailLoaded(thumbs[i], index);
+            }
+        }
+    }
+
+    Bitmap[] decodeSheet(int sheet) {
+        final long startTime = DEBUG ? SystemClock.uptimeMillis() : 0;
+        Bitmap sheetBitmap;
+        try {
+            InputStream in = openSpriteSheet(sheet);
+            if (in == null) {
+                return null;
+            }
+            try {
+                sheetBitmap = BitmapFactory.decodeStream(in);
+            } finally {
+                in.close();
+            }
+        } catch (IOException e) {
+            Log.w(TAG, "Failed to open sprite sheet " + sheet, e);
+            return null;
+        }
+        if (sheetBitmap == null) {
+            return null;
+        }
+        final int count = Math.min(mThumbsPerSheet,
+                mSeekPositions.length - sheet * mThumbsPerSheet);
+        final int width = sheetBitmap.getWidth() / mColumns;
+        final int height = sheetBitmap.getHeight() / mRows;
+        final Bitmap[] thumbs = new Bitmap[Math.max(0, count)];
+        boolean sheetInUse = false;
+        if (width > 0 && height > 0) {
+            for (int i = 0; i < thumbs.length; i++) {
+                thumbs[i] = Bitmap.createBitmap(sheetBitmap, (i % mColumns) * width,
+                        (i / mColumns) * height, width, height);
+                // A sheet holding a single thumbnail may be returned as is.
+                sheetInUse |= thumbs[i] == sheetBitmap;
+            }
+        }
+        if (!sheetInUse) {
+            sheetBitmap.recycle();
+        }
+        if (DEBUG) {
+            Log.v(TAG, "decoded sheet " + sheet + " in "
+                    + (SystemClock.uptimeMillis() - startTime) + "ms");
+        }
+        return thumbs;
+    }
+
+    /**
+     * Cancels pending requests and sprite sheet decodes. Thumbnails that are already decoded
+     * stay cached, so seeking again around the same positions does not decode them again.
+     */
+    @Override
+    public void reset() {
+        mGeneration++;
+        mCallbacks.clear();
+        mLoadingSheets.clear();
+        mLastRequestedIndex = -1;
+        mFirstSheetInWindow = -1;
+        mLastSheetInWindow = -1;
+    }
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.localbroadcastmanager.content;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNotSame;
+import static org.junit.Assert.assertTrue;
+
+import android.content.BroadcastReceiver;
+import android.content.Context;
+import android.content.Intent;
+import android.content.IntentFilter;
+import android.net.Uri;
+import android.os.Looper;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.LargeTest;
+import android.support.test.filters.SmallTest;
+import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
+
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.TimeUnit;
+
+@RunWith(AndroidJUnit4.class)
+public class LocalBroadcastManagerTest {
+    private static final String TAG = "LocalBroadcastManagerTest";
+    private static final String ACTION = "androidx.localbroadcastmanager.test.ACTION";
+
+    private LocalBroadcastManager mManager;
+    private final List<BroadcastReceiver> mRegistered = new ArrayList<>();
+    // Names of the receivers that were called, in order.
+    final List<String> mReceived = new ArrayList<>();
+
+    @Before
+    public void setUp() {
+        mManager = LocalBroadcastManager.getInstance(InstrumentationRegistry.getTargetContext());
+    }
+
+    @After
+    public void tearDown() {
+        for (BroadcastReceiver receiver : mRegistered) {
+            mManager.unregisterReceiver(receiver);
+        }
+    }
+
+    private BroadcastReceiver register(final String name, IntentFilter filter) {
+        BroadcastReceiver receiver = new BroadcastReceiver() {
+            @Override
+            public void onReceive(Context context, Intent intent) {
+                synchronized (mReceived) {
+                    mReceived.add(name);
+                }
+            }
+        };
+        mManager.registerReceiver(receiver, filter);
+        mRegistered.add(receiver);
+        return receiver;
+    }
+
+    private List<String> sendSync(Intent intent) {
+        synchronized (mReceived) {
+            mReceived.clear();
+        }
+        mManager.sendBroadcastSync(intent);
+        synchronized (mReceived) {
+            return new ArrayList<>(mReceived);
+        }
+    }
+
+    @SmallTest
+    @Test
+    public void routesByActionSchemeAndType() {
+        register("plain", new IntentFilter(ACTION));
+        IntentFilter schemeFilter = new IntentFilter(ACTION);
+        schemeFilter.addDataScheme("app");
+        register("app", schemeFilter);
+        IntentFilter typeFilter = new IntentFilter(ACTION);
+        typeFilter.addDataType("image/*");
+        register("image", typeFilter);
+        IntentFilter anyTypeFilter = new IntentFilter(ACTION);
+        anyTypeFilter.addDataType("*/*");
+        register("any", anyTypeFilter);
+        register("other", new IntentFilter(ACTION + ".OTHER"));
+
+        assertEquals(Arrays.asList("plain"), sendSync(new Intent(ACTION)));
+        assertEquals(Arrays.asList("other"), sendSync(new Intent(ACTION + ".OTHER")));
+        assertEquals(Arrays.asList("app"),
+                sendSync(new Intent(ACTION, Uri.parse("app://authority/path"))));
+        assertEquals(Arrays.asList("image", "any"),
+                sendSync(new Intent(ACTION).setType("image/png")));
+        assertEquals(Arrays.asList("any"),
+                sendSync(new Intent(ACTION).setType("text/plain")));
+        assertEquals(Arrays.asList(),
+                sendSync(new Intent(ACTION, Uri.parse("http://authority/path"))));
+        assertFalse(mManager.sendBroadcast(new Intent(ACTION + ".NONE")));
+    }
+
+    @SmallTest
+    @Test
+    public void deliversInRegistrationOrder() {
+        IntentFilter typeFilter = new IntentFilter(ACTION);
+        typeFilter.addDataType("image/png");
+        IntentFilter schemeFilter = new IntentFilter(ACTION);
+        schemeFilter.addDataScheme("content");
+        schemeFilter.addDataType("image/png");
+        register("type1", typeFilter);
+        register("scheme1", schemeFilter);
+        register("type2", typeFilter);
+        register("scheme2", schemeFilter);
+
+        Intent intent = new Intent(ACTION);
+        intent.setDataAndType(Uri.parse("content://authority/path"), "image/png");
+        assertEquals(Arrays.asList("type1", "scheme1", "type2", "scheme2"), sendSync(intent));
+    }
+
+    @SmallTest
+    @Test
+    public void unregisterStopsDelivery() {
+        BroadcastReceiver receiver = register("first", new IntentFilter(ACTION));
+        register("second", new IntentFilter(ACTION));
+        mManager.unregisterReceiver(receiver);
+        mRegistered.remove(receiver);
+        assertEquals(Arrays.asList("second"), sendSync(new Intent(ACTION)));
+    }
+
+    @SmallTest
+    @Test
+    public void deliversOnExecutor() throws InterruptedException {
+        final int count = 10;
+        final CountDownLatch latch = new CountDownLatch(count);
+        final List<Integer> received = new ArrayList<>();
+        final Thread[] threads = new Thread[1];
+        ExecutorService executor = Executors.newSingleThreadExecutor();
+        try {
+            BroadcastReceiver receiver = new BroadcastReceiver() {
+                @Override
+                public void onReceive(Context context, Intent intent) {
+                    threads[0] = Thread.currentThread();
+                    synchronized (received) {
+                        received.add(intent.getIntExtra("index", -1));
+                    }
+                    latch.countDown();
+                }
+            };
+            mManager.registerReceiver(receiver, new IntentFilter(ACTION), executor);
+            mRegistered.add(receiver);
+            for (int i = 0; i < count; i++) {
+                assertTrue(mManager.sendBroadcast(new Intent(ACTION).putExtra("index", i)));
+            }
+            assertTrue(latch.await(5, TimeUnit.SECONDS));
+            assertNotSame(Looper.getMainLooper().getThread(), threads[0]);
+            synchronized (received) {
+                for (int i = 0; i < count; i++) {
+                    assertEquals(i, (int) received.get(i));
+                }
+            }
+        } finally {
+            executor.shutdown();
+        }
+    }
+
+    /**
+     * Measures the throughput of {@link LocalBroadcastManager#sendBroadcastSync} with many
+     * registered filters, most of which are for other actions or data schemes.
+     */
+    @LargeTest
+    @Test
+    public void dispatchThroughputBenchmark() {
+        final int filterCount = 200;
+        final int broadcastCount = 50000;
+        final int[] received = new int[1];
+        BroadcastReceiver counter = new BroadcastReceiver() {
+            @Override
+            public void onReceive(Context context, Intent intent) {
+                received[0]++;
+            }
+        };
+        for (int i = 0; i < filterCount; i++) {
+            IntentFilter filter = new IntentFilter(ACTION + (i % 10));
+            if (i % 2 == 0) {
+                filter.addDataScheme("scheme" + (i % 20));
+            }
+            mManager.registerReceiver(counter, filter);
+        }
+        mRegistered.add(counter);
+
+        Intent plain = new Intent(ACTION + 1);
+        Intent withData = new Intent(ACTION + 2, Uri.parse("scheme2://authority/path"));
+        long startTime = System.nanoTime();
+        for (int i = 0; i < broadcastCount; i++) {
+            mManager.sendBroadcastSync((i & 1) == 0 ? plain : withData);
+        }
+        long elapsedNanos = System.nanoTime() - startTime;
+        assertTrue(received[0] > 0);
+        Log.d(TAG, "dispatched " + broadcastCount + " broadcasts to " + received[0]
+                + " receivers in " + (elapsedNanos / 1000000) + "ms, "
+                + (broadcastCount * 1000000000L / Math.max(1, elapsedNanos)) + " broadcasts/s");
+    }
+}
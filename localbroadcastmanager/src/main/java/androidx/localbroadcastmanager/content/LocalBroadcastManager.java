@@ -27,9 +27,12 @@ import android.util.Log;
 
 import androidx.annotation.NonNull;
 
+import java.util.ArrayDeque;
 import java.util.ArrayList;
 import java.util.HashMap;
+import java.util.List;
 import java.util.Set;
+import java.util.concurrent.Executor;
 
 /**
  * Helper to register for and send broadcasts of Intents to local objects
@@ -44,17 +47,99 @@ import java.util.Set;
  * <li> It is more efficient than sending a global broadcast through the
  * system.
  * </ul>
+ *
+ * <p>Registered filters are indexed by action, then by data scheme and by whether they declare
+ * data types, so sending a broadcast only runs {@link IntentFilter#match} against the filters
+ * that can possibly match it. The index is rebuilt when receivers are registered or
+ * unregistered and is read without locking, so broadcasts may be sent from any thread.
  */
 public final class LocalBroadcastManager {
-    private static final class ReceiverRecord {
+    private static final class ReceiverRecord implements Runnable {
         final IntentFilter filter;
         final BroadcastReceiver receiver;
-        boolean broadcasting;
-        boolean dead;
+        // Registration order, used to deliver to receivers of different index buckets in the
+        // order they were registered.
+        final int order;
+        final Executor executor;
+        final Context context;
+        // Major MIME types of the filter if it declares data types, null otherwise.
+        final String[] majorTypes;
+        volatile boolean dead;
+
+        // Broadcasts waiting to be run on the executor, guarded by this record.
+        private final ArrayDeque<Intent> pendingIntents;
+        private boolean scheduled;
 
-        ReceiverRecord(IntentFilter _filter, BroadcastReceiver _receiver) {
+        ReceiverRecord(IntentFilter _filter, BroadcastReceiver _receiver, int _order,
+                Executor _executor, Context _context) {
             filter = _filter;
             receiver = _receiver;
+            order = _order;
+            executor = _executor;
+            context = _context;
+            pendingIntents = _executor != null ? new ArrayDeque<Intent>() : null;
+            final int typeCount = _filter.countDataTypes();
+            if (typeCount > 0) {
+                majorTypes = new String[typeCount];
+                for (int i = 0; i < typeCount; i++) {
+                    majorTypes[i] = getMajorType(_filter.getDataType(i));
+                }
+            } else {
+                majorTypes = null;
+            }
+        }
+
+        /**
+         * Returns false if the given type cannot match any of the data types of the filter. The
+         * full comparison is left to {@link IntentFilter#match}.
+         */
+        boolean mayMatchType(String type) {
+            if (majorTypes == null) {
+                return false;
+            }
+            final int slash = type.indexOf('/');
+            final int length = slash >= 0 ? slash : type.length();
+            if (length == 1 && type.charAt(0) == '*') {
+                return true;
+            }
+            for (String majorType : majorTypes) {
+                if (majorType.equals("*") || (majorType.length() == length
+                        && type.startsWith(majorType))) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Queues the given broadcast for delivery on the executor of this record.
+         */
+        void enqueue(Intent intent) {
+            synchronized (this) {
+                pendingIntents.addLast(intent);
+                if (scheduled) {
+                    return;
+                }
+                scheduled = true;
+            }
+            executor.execute(this);
+        }
+
+        @Override
+        public void run() {
+            while (true) {
+                final Intent intent;
+                synchronized (this) {
+                    intent = pendingIntents.pollFirst();
+                    if (intent == null) {
+                        scheduled = false;
+                        return;
+                    }
+                }
+                if (!dead) {
+                    receiver.onReceive(context, intent);
+                }
+            }
         }
 
         @Override
@@ -72,26 +157,78 @@ public final class LocalBroadcastManager {
         }
     }
 
-    private static final class BroadcastRecord {
-        final Intent intent;
-        final ArrayList<ReceiverRecord> receivers;
+    private static final ReceiverRecord[] EMPTY_RECORDS = new ReceiverRecord[0];
+
+    /**
+     * Immutable index of the receivers registered for one action.
+     */
+    private static final class ActionIndex {
+        // Filters without data schemes or types, which only match broadcasts without data.
+        final ReceiverRecord[] plain;
+        // Filters with data types but no schemes, which only match broadcasts with a type.
+        final ReceiverRecord[] typed;
+        // Filters with data schemes, by scheme.
+        final HashMap<String, ReceiverRecord[]> schemes;
 
-        BroadcastRecord(Intent _intent, ArrayList<ReceiverRecord> _receivers) {
-            intent = _intent;
-            receivers = _receivers;
+        ActionIndex(ArrayList<ReceiverRecord> records) {
+            ArrayList<ReceiverRecord> plainRecords = new ArrayList<>();
+            ArrayList<ReceiverRecord> typedRecords = new ArrayList<>();
+            HashMap<String, ArrayList<ReceiverRecord>> schemeRecords = new HashMap<>();
+            for (int i = 0; i < records.size(); i++) {
+                final ReceiverRecord record = records.get(i);
+                final IntentFilter filter = record.filter;
+                if (filter.countDataSchemes() > 0) {
+                    for (int j = 0; j < filter.countDataSchemes(); j++) {
+                        final String scheme = filter.getDataScheme(j);
+                        ArrayList<ReceiverRecord> list = schemeRecords.get(scheme);
+                        if (list == null) {
+                            list = new ArrayList<>(1);
+                            schemeRecords.put(scheme, list);
+                        }
+                        if (!list.contains(record)) {
+                            list.add(record);
+                        }
+                    }
+                } else if (filter.countDataTypes() > 0) {
+                    typedRecords.add(record);
+                } else {
+                    plainRecords.add(record);
+                }
+            }
+            plain = plainRecords.toArray(EMPTY_RECORDS);
+            typed = typedRecords.toArray(EMPTY_RECORDS);
+            schemes = new HashMap<>(schemeRecords.size());
+            for (String scheme : schemeRecords.keySet()) {
+                schemes.put(scheme, schemeRecords.get(scheme).toArray(EMPTY_RECORDS));
+            }
         }
     }
 
+    private static final class BroadcastRecord {
+        Intent intent;
+        final ArrayList<ReceiverRecord> receivers = new ArrayList<>();
+    }
+
     private static final String TAG = "LocalBroadcastManager";
     private static final boolean DEBUG = false;
 
+    private static final int MAX_POOLED_BROADCAST_RECORDS = 16;
+
     private final Context mAppContext;
 
     private final HashMap<BroadcastReceiver, ArrayList<ReceiverRecord>> mReceivers
             = new HashMap<>();
     private final HashMap<String, ArrayList<ReceiverRecord>> mActions = new HashMap<>();
+    private int mNextOrder;
+
+    // Copy of mActions indexed for sending, replaced whenever mActions changes.
+    private volatile HashMap<String, ActionIndex> mIndex = new HashMap<>();
 
-    private final ArrayList<BroadcastRecord> mPendingBroadcasts = new ArrayList<>();
+    // Broadcasts waiting for delivery on the main thread and recycled records, guarded by
+    // mPendingBroadcasts.
+    private final ArrayDeque<BroadcastRecord> mPendingBroadcasts = new ArrayDeque<>();
+    private final ArrayList<BroadcastRecord> mBroadcastRecordPool = new ArrayList<>();
+    private boolean mExecScheduled;
 
     static final int MSG_EXEC_PENDING_BROADCASTS = 1;
 
@@ -118,6 +255,9 @@ public final class LocalBroadcastManager {
             public void handleMessage(Message msg) {
                 switch (msg.what) {
                     case MSG_EXEC_PENDING_BROADCASTS:
+                        synchronized (mPendingBroadcasts) {
+                            mExecScheduled = false;
+                        }
                         executePendingBroadcasts();
                         break;
                     default:
@@ -137,8 +277,31 @@ public final class LocalBroadcastManager {
      */
     public void registerReceiver(@NonNull BroadcastReceiver receiver,
             @NonNull IntentFilter filter) {
+        registerReceiverInternal(receiver, filter, null);
+    }
+
+    /**
+     * Register a receive for any local broadcasts that match the given IntentFilter, to be run
+     * on the given Executor instead of the main thread. Broadcasts are delivered to the
+     * receiver one at a time, in the order they were sent, including broadcasts sent with
+     * {@link #sendBroadcastSync(Intent)}.
+     *
+     * @param receiver The BroadcastReceiver to handle the broadcast.
+     * @param filter Selects the Intent broadcasts to be received.
+     * @param executor The Executor running {@link BroadcastReceiver#onReceive}.
+     *
+     * @see #unregisterReceiver
+     */
+    public void registerReceiver(@NonNull BroadcastReceiver receiver,
+            @NonNull IntentFilter filter, @NonNull Executor executor) {
+        registerReceiverInternal(receiver, filter, executor);
+    }
+
+    private void registerReceiverInternal(BroadcastReceiver receiver, IntentFilter filter,
+            Executor executor) {
         synchronized (mReceivers) {
-            ReceiverRecord entry = new ReceiverRecord(filter, receiver);
+            ReceiverRecord entry = new ReceiverRecord(filter, receiver, mNextOrder++, executor,
+                    mAppContext);
             ArrayList<ReceiverRecord> filters = mReceivers.get(receiver);
             if (filters == null) {
                 filters = new ArrayList<>(1);
@@ -154,6 +317,7 @@ public final class LocalBroadcastManager {
                 }
                 entries.add(entry);
             }
+            updateIndexLocked(filters.subList(filters.size() - 1, filters.size()));
         }
     }
 
@@ -192,9 +356,31 @@ public final class LocalBroadcastManager {
                     }
                 }
             }
+            updateIndexLocked(filters);
         }
     }
 
+    /**
+     * Publishes a new index in which the actions of the given records are rebuilt from
+     * {@link #mActions}.
+     */
+    private void updateIndexLocked(List<ReceiverRecord> records) {
+        final HashMap<String, ActionIndex> index = new HashMap<>(mIndex);
+        for (int i = 0; i < records.size(); i++) {
+            final IntentFilter filter = records.get(i).filter;
+            for (int j = 0; j < filter.countActions(); j++) {
+                final String action = filter.getAction(j);
+                final ArrayList<ReceiverRecord> entries = mActions.get(action);
+                if (entries == null) {
+                    index.remove(action);
+                } else {
+                    index.put(action, new ActionIndex(entries));
+                }
+            }
+        }
+        mIndex = index;
+    }
+
     /**
      * Broadcast the given intent to all interested BroadcastReceivers.  This
      * call is asynchronous; it returns immediately, and you will continue
@@ -210,80 +396,103 @@ public final class LocalBroadcastManager {
      * receivers is unregistered before it is dispatched.)
      */
     public boolean sendBroadcast(@NonNull Intent intent) {
-        synchronized (mReceivers) {
-            final String action = intent.getAction();
-            final String type = intent.resolveTypeIfNeeded(
-                    mAppContext.getContentResolver());
-            final Uri data = intent.getData();
-            final String scheme = intent.getScheme();
-            final Set<String> categories = intent.getCategories();
-
-            final boolean debug = DEBUG ||
-                    ((intent.getFlags() & Intent.FLAG_DEBUG_LOG_RESOLUTION) != 0);
-            if (debug) Log.v(
-                    TAG, "Resolving type " + type + " scheme " + scheme
-                    + " of intent " + intent);
-
-            ArrayList<ReceiverRecord> entries = mActions.get(intent.getAction());
-            if (entries != null) {
-                if (debug) Log.v(TAG, "Action list: " + entries);
-
-                ArrayList<ReceiverRecord> receivers = null;
-                for (int i=0; i<entries.size(); i++) {
-                    ReceiverRecord receiver = entries.get(i);
-                    if (debug) Log.v(TAG, "Matching against filter " + receiver.filter);
-
-                    if (receiver.broadcasting) {
-                        if (debug) {
-                            Log.v(TAG, "  Filter's target already added");
-                        }
-                        continue;
-                    }
+        final String action = intent.getAction();
+        final String type = intent.resolveTypeIfNeeded(
+                mAppContext.getContentResolver());
+        final Uri data = intent.getData();
+        final String scheme = intent.getScheme();
+        final Set<String> categories = intent.getCategories();
 
-                    int match = receiver.filter.match(action, type, scheme, data,
-                            categories, "LocalBroadcastManager");
-                    if (match >= 0) {
-                        if (debug) Log.v(TAG, "  Filter matched!  match=0x" +
-                                Integer.toHexString(match));
-                        if (receivers == null) {
-                            receivers = new ArrayList<ReceiverRecord>();
-                        }
-                        receivers.add(receiver);
-                        receiver.broadcasting = true;
-                    } else {
-                        if (debug) {
-                            String reason;
-                            switch (match) {
-                                case IntentFilter.NO_MATCH_ACTION: reason = "action"; break;
-                                case IntentFilter.NO_MATCH_CATEGORY: reason = "category"; break;
-                                case IntentFilter.NO_MATCH_DATA: reason = "data"; break;
-                                case IntentFilter.NO_MATCH_TYPE: reason = "type"; break;
-                                default: reason = "unknown reason"; break;
-                            }
-                            Log.v(TAG, "  Filter did not match: " + reason);
-                        }
-                    }
+        final boolean debug = DEBUG ||
+                ((intent.getFlags() & Intent.FLAG_DEBUG_LOG_RESOLUTION) != 0);
+        if (debug) Log.v(
+                TAG, "Resolving type " + type + " scheme " + scheme
+                + " of intent " + intent);
+
+        final ActionIndex index = action != null ? mIndex.get(action) : null;
+        if (index == null) {
+            return false;
+        }
+
+        // Plain and typed filters are exclusive of each other, and both may overlap with the
+        // filters of the scheme. Merge them by registration order.
+        final ReceiverRecord[] first;
+        if (type != null) {
+            first = index.typed;
+        } else if (data == null) {
+            first = index.plain;
+        } else {
+            first = EMPTY_RECORDS;
+        }
+        ReceiverRecord[] second = index.schemes.get(scheme != null ? scheme : "");
+        if (second == null) {
+            second = EMPTY_RECORDS;
+        }
+
+        boolean scheduled = false;
+        BroadcastRecord broadcast = null;
+        int i = 0;
+        int j = 0;
+        while (i < first.length || j < second.length) {
+            final ReceiverRecord receiver;
+            if (j >= second.length || (i < first.length && first[i].order < second[j].order)) {
+                receiver = first[i++];
+                if (type != null && !receiver.mayMatchType(type)) {
+                    continue;
                 }
+            } else {
+                receiver = second[j++];
+            }
+            if (debug) Log.v(TAG, "Matching against filter " + receiver.filter);
 
-                if (receivers != null) {
-                    for (int i=0; i<receivers.size(); i++) {
-                        receivers.get(i).broadcasting = false;
+            int match = receiver.filter.match(action, type, scheme, data,
+                    categories, "LocalBroadcastManager");
+            if (match >= 0) {
+                if (debug) Log.v(TAG, "  Filter matched!  match=0x" +
+                        Integer.toHexString(match));
+                scheduled = true;
+                if (receiver.executor != null) {
+                    receiver.enqueue(intent);
+                } else {
+                    if (broadcast == null) {
+                        broadcast = obtainBroadcastRecord(intent);
                     }
-                    mPendingBroadcasts.add(new BroadcastRecord(intent, receivers));
-                    if (!mHandler.hasMessages(MSG_EXEC_PENDING_BROADCASTS)) {
-                        mHandler.sendEmptyMessage(MSG_EXEC_PENDING_BROADCASTS);
+                    broadcast.receivers.add(receiver);
+                }
+            } else {
+                if (debug) {
+                    String reason;
+                    switch (match) {
+                        case IntentFilter.NO_MATCH_ACTION: reason = "action"; break;
+                        case IntentFilter.NO_MATCH_CATEGORY: reason = "category"; break;
+                        case IntentFilter.NO_MATCH_DATA: reason = "data"; break;
+                        case IntentFilter.NO_MATCH_TYPE: reason = "type"; break;
+                        default: reason = "unknown reason"; break;
                     }
-                    return true;
+                    Log.v(TAG, "  Filter did not match: " + reason);
                 }
             }
         }
-        return false;
+
+        if (broadcast != null) {
+            final boolean schedule;
+            synchronized (mPendingBroadcasts) {
+                mPendingBroadcasts.addLast(broadcast);
+                schedule = !mExecScheduled;
+                mExecScheduled = true;
+            }
+            if (schedule) {
+                mHandler.sendEmptyMessage(MSG_EXEC_PENDING_BROADCASTS);
+            }
+        }
+        return scheduled;
     }
 
     /**
      * Like {@link #sendBroadcast(Intent)}, but if there are any receivers for
      * the Intent this function will block and immediately dispatch them before
-     * returning.
+     * returning. Receivers registered with an {@link Executor} are still run on
+     * their executor.
      */
     public void sendBroadcastSync(@NonNull Intent intent) {
         if (sendBroadcast(intent)) {
@@ -291,28 +500,49 @@ public final class LocalBroadcastManager {
         }
     }
 
+    private BroadcastRecord obtainBroadcastRecord(Intent intent) {
+        BroadcastRecord record = null;
+        synchronized (mPendingBroadcasts) {
+            final int size = mBroadcastRecordPool.size();
+            if (size > 0) {
+                record = mBroadcastRecordPool.remove(size - 1);
+            }
+        }
+        if (record == null) {
+            record = new BroadcastRecord();
+        }
+        record.intent = intent;
+        return record;
+    }
+
     private void executePendingBroadcasts() {
         while (true) {
-            final BroadcastRecord[] brs;
-            synchronized (mReceivers) {
-                final int N = mPendingBroadcasts.size();
-                if (N <= 0) {
-                    return;
+            final BroadcastRecord br;
+            synchronized (mPendingBroadcasts) {
+                br = mPendingBroadcasts.pollFirst();
+            }
+            if (br == null) {
+                return;
+            }
+            final int nbr = br.receivers.size();
+            for (int j=0; j<nbr; j++) {
+                final ReceiverRecord rec = br.receivers.get(j);
+                if (!rec.dead) {
+                    rec.receiver.onReceive(mAppContext, br.intent);
                 }
-                brs = new BroadcastRecord[N];
-                mPendingBroadcasts.toArray(brs);
-                mPendingBroadcasts.clear();
             }
-            for (int i=0; i<brs.length; i++) {
-                final BroadcastRecord br = brs[i];
-                final int nbr = br.receivers.size();
-                for (int j=0; j<nbr; j++) {
-                    final ReceiverRecord rec = br.receivers.get(j);
-                    if (!rec.dead) {
-                        rec.receiver.onReceive(mAppContext, br.intent);
-                    }
+            br.intent = null;
+            br.receivers.clear();
+            synchronized (mPendingBroadcasts) {
+                if (mBroadcastRecordPool.size() < MAX_POOLED_BROADCAST_RECORDS) {
+                    mBroadcastRecordPool.add(br);
                 }
             }
         }
     }
+
+    static String getMajorType(String type) {
+        final int slash = type.indexOf('/');
+        return slash >= 0 ? type.substring(0, slash) : type;
+    }
 }
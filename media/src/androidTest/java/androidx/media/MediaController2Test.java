@@ -26,6 +26,7 @@ import static org.junit.Assert.fail;
 
 import android.app.PendingIntent;
 import android.content.Intent;
+import android.graphics.Bitmap;
 import android.media.AudioManager;
 import android.net.Uri;
 import android.os.Build;
@@ -54,8 +55,10 @@ import org.junit.Test;
 import org.junit.runner.RunWith;
 
 import java.lang.reflect.Method;
+import java.util.ArrayList;
 import java.util.List;
 import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.LinkedBlockingQueue;
 import java.util.concurrent.TimeUnit;
 import java.util.concurrent.atomic.AtomicReference;
 
@@ -262,6 +265,28 @@ public class MediaController2Test extends MediaSession2TestBase {
         }
     }
 
+    @Test
+    public void testSetPlaylist_keepsBitmaps() throws InterruptedException {
+        prepareLooper();
+        final Bitmap bitmap = Bitmap.createBitmap(16, 16, Bitmap.Config.ARGB_8888);
+        final List<MediaItem2> list = new ArrayList<>();
+        list.add(new MediaItem2.Builder(MediaItem2.FLAG_PLAYABLE)
+                .setMetadata(new MediaMetadata2.Builder()
+                        .putString(MediaMetadata2.METADATA_KEY_MEDIA_ID, "testSetPlaylist")
+                        .putBitmap(MediaMetadata2.METADATA_KEY_ART, bitmap)
+                        .putString(MediaMetadata2.METADATA_KEY_ART_URI, "content://art")
+                        .build())
+                .build());
+        mController.setPlaylist(list, null /* Metadata */);
+        assertTrue(mMockAgent.mCountDownLatch.await(TIMEOUT_MS, TimeUnit.MILLISECONDS));
+
+        // Bitmaps with a Uri are only left out of the items sent by sessions.
+        assertNotNull(mMockAgent.mPlaylist);
+        assertEquals(1, mMockAgent.mPlaylist.size());
+        assertNotNull(mMockAgent.mPlaylist.get(0).getMetadata()
+                .getBitmap(MediaMetadata2.METADATA_KEY_ART));
+    }
+
     /**
      * This also tests {@link ControllerCallback#onPlaylistChanged(
      * MediaController2, List, MediaMetadata2)}.
@@ -305,6 +330,117 @@ public class MediaController2Test extends MediaSession2TestBase {
         }
     }
 
+    /**
+     * Tests that changes of a part of the playlist are applied to the playlist of the controller.
+     */
+    @Test
+    public void testControllerCallback_onPlaylistChanged_partialChanges()
+            throws InterruptedException {
+        prepareLooper();
+        final List<MediaItem2> testList = new ArrayList<>();
+        for (int i = 0; i < 10; i++) {
+            testList.add(createMediaItem("item_" + i));
+        }
+        final LinkedBlockingQueue<List<MediaItem2>> playlists = new LinkedBlockingQueue<>();
+        final ControllerCallback callback = new ControllerCallback() {
+            @Override
+            public void onPlaylistChanged(MediaController2 controller,
+                    List<MediaItem2> playlist, MediaMetadata2 metadata) {
+                playlists.add(playlist);
+            }
+        };
+        final MediaPlaylistAgent agent = new MockPlaylistAgent() {
+            @Override
+            public List<MediaItem2> getPlaylist() {
+                return testList;
+            }
+        };
+        try (MediaSession2 session = new MediaSession2.Builder(mContext)
+                .setPlayer(mPlayer)
+                .setId("testControllerCallback_onPlaylistChanged_partialChanges")
+                .setSessionCallback(sHandlerExecutor, new SessionCallback() {})
+                .setPlaylistAgent(agent)
+                .build()) {
+            MediaController2 controller = createController(
+                    session.getToken(), true, callback);
+            assertMediaIdsEqual(testList, controller.getPlaylist());
+
+            testList.add(3, createMediaItem("added"));
+            agent.notifyPlaylistChanged();
+            assertMediaIdsEqual(testList, playlists.poll(TIMEOUT_MS, TimeUnit.MILLISECONDS));
+
+            testList.remove(7);
+            testList.set(0, createMediaItem("replaced"));
+            agent.notifyPlaylistChanged();
+            assertMediaIdsEqual(testList, playlists.poll(TIMEOUT_MS, TimeUnit.MILLISECONDS));
+            assertMediaIdsEqual(testList, controller.getPlaylist());
+        }
+    }
+
+    /**
+     * Tests that changes of some fields of the playlist metadata are applied to the playlist
+     * metadata of the controller.
+     */
+    @Test
+    public void testControllerCallback_onPlaylistMetadataChanged_partialChanges()
+            throws InterruptedException {
+        prepareLooper();
+        final MediaMetadata2.Builder builder = new MediaMetadata2.Builder();
+        for (int i = 0; i < 10; i++) {
+            builder.putString("key_" + i, "value_" + i);
+        }
+        final MediaMetadata2[] playlistMetadata = { builder.build() };
+        final LinkedBlockingQueue<MediaMetadata2> metadataQueue = new LinkedBlockingQueue<>();
+        final ControllerCallback callback = new ControllerCallback() {
+            @Override
+            public void onPlaylistMetadataChanged(MediaController2 controller,
+                    MediaMetadata2 metadata) {
+                metadataQueue.add(metadata);
+            }
+        };
+        final MediaPlaylistAgent agent = new MockPlaylistAgent() {
+            @Override
+            public MediaMetadata2 getPlaylistMetadata() {
+                return playlistMetadata[0];
+            }
+        };
+        try (MediaSession2 session = new MediaSession2.Builder(mContext)
+                .setPlayer(mPlayer)
+                .setId("testControllerCallback_onPlaylistMetadataChanged_partialChanges")
+                .setSessionCallback(sHandlerExecutor, new SessionCallback() {})
+                .setPlaylistAgent(agent)
+                .build()) {
+            MediaController2 controller = createController(
+                    session.getToken(), true, callback);
+            assertEquals("value_3", controller.getPlaylistMetadata().getString("key_3"));
+
+            playlistMetadata[0] = new MediaMetadata2.Builder(playlistMetadata[0])
+                    .putString("key_3", "changed")
+                    .putLong("added", 1)
+                    .build();
+            agent.notifyPlaylistMetadataChanged();
+            MediaMetadata2 metadata = metadataQueue.poll(TIMEOUT_MS, TimeUnit.MILLISECONDS);
+            assertNotNull(metadata);
+            assertEquals(11, metadata.size());
+            assertEquals("changed", metadata.getString("key_3"));
+            assertEquals("value_4", metadata.getString("key_4"));
+            assertEquals(1, metadata.getLong("added"));
+            assertEquals(11, controller.getPlaylistMetadata().size());
+        }
+    }
+
+    private static MediaItem2 createMediaItem(String mediaId) {
+        return new MediaItem2.Builder(MediaItem2.FLAG_PLAYABLE).setMediaId(mediaId).build();
+    }
+
+    private static void assertMediaIdsEqual(List<MediaItem2> expected, List<MediaItem2> actual) {
+        assertNotNull(actual);
+        assertEquals(expected.size(), actual.size());
+        for (int i = 0; i < expected.size(); i++) {
+            assertEquals(expected.get(i).getMediaId(), actual.get(i).getMediaId());
+        }
+    }
+
     @Test
     public void testUpdatePlaylistMetadata() throws InterruptedException {
         prepareLooper();
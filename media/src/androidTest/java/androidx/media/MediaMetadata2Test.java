@@ -17,11 +17,20 @@
 package androidx.media;
 
 import static junit.framework.Assert.assertEquals;
+import static junit.framework.Assert.assertFalse;
+import static junit.framework.Assert.assertNotNull;
+import static junit.framework.Assert.assertNotSame;
+import static junit.framework.Assert.assertSame;
 import static junit.framework.Assert.assertTrue;
 
+import android.graphics.Bitmap;
 import android.os.Bundle;
+import android.os.Parcel;
+import android.os.SystemClock;
+import android.support.test.filters.LargeTest;
 import android.support.test.filters.SmallTest;
 import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
 
 import androidx.media.MediaMetadata2.Builder;
 
@@ -31,6 +40,8 @@ import org.junit.runner.RunWith;
 @RunWith(AndroidJUnit4.class)
 @SmallTest
 public class MediaMetadata2Test {
+    private static final String TAG = "MediaMetadata2Test";
+
     @Test
     public void testBuilder() {
         final Bundle extras = new Bundle();
@@ -51,4 +62,101 @@ public class MediaMetadata2Test {
         assertEquals(discNumber, metadata.getLong(MediaMetadata2.METADATA_KEY_DISC_NUMBER));
         assertEquals(rating, metadata.getRating(MediaMetadata2.METADATA_KEY_USER_RATING));
     }
+
+    @Test
+    public void testToTransferBundle_leavesOutBitmapsWithUri() {
+        final Bitmap bitmap = Bitmap.createBitmap(16, 16, Bitmap.Config.ARGB_8888);
+        MediaMetadata2 metadata = new Builder()
+                .putBitmap(MediaMetadata2.METADATA_KEY_ART, bitmap)
+                .putString(MediaMetadata2.METADATA_KEY_ART_URI, "content://art")
+                .putBitmap(MediaMetadata2.METADATA_KEY_DISPLAY_ICON, bitmap)
+                .build();
+
+        Bundle bundle = metadata.toTransferBundle();
+        assertFalse(bundle.containsKey(MediaMetadata2.METADATA_KEY_ART));
+        assertEquals("content://art", bundle.getString(MediaMetadata2.METADATA_KEY_ART_URI));
+        assertNotNull(bundle.getParcelable(MediaMetadata2.METADATA_KEY_DISPLAY_ICON));
+        assertSame(bundle, metadata.toTransferBundle());
+        // The metadata itself keeps the bitmap.
+        assertSame(bitmap, metadata.getBitmap(MediaMetadata2.METADATA_KEY_ART));
+    }
+
+    @Test
+    public void testMediaItemToBundle_returnsFullCopy() {
+        final Bitmap bitmap = Bitmap.createBitmap(16, 16, Bitmap.Config.ARGB_8888);
+        MediaItem2 item = new MediaItem2.Builder(MediaItem2.FLAG_PLAYABLE)
+                .setMetadata(new Builder()
+                        .putString(MediaMetadata2.METADATA_KEY_MEDIA_ID, "testMediaItem")
+                        .putBitmap(MediaMetadata2.METADATA_KEY_ART, bitmap)
+                        .putString(MediaMetadata2.METADATA_KEY_ART_URI, "content://art")
+                        .build())
+                .build();
+        Bundle bundle = item.toBundle();
+        assertNotSame(bundle, item.toBundle());
+        MediaMetadata2 metadata = MediaItem2.fromBundle(bundle).getMetadata();
+        assertNotNull(metadata.getBitmap(MediaMetadata2.METADATA_KEY_ART));
+        assertFalse(MediaItem2.fromBundle(item.toTransferBundle()).getMetadata()
+                .containsKey(MediaMetadata2.METADATA_KEY_ART));
+    }
+
+    @Test
+    public void testMediaItemToTransferBundle_recreatedWhenMetadataChanges() {
+        MediaItem2 item = TestUtils.createMediaItemWithMetadata();
+        Bundle bundle = item.toTransferBundle();
+        assertSame(bundle, item.toTransferBundle());
+
+        item.setMetadata(new Builder(item.getMetadata())
+                .putString(MediaMetadata2.METADATA_KEY_TITLE, "title").build());
+        Bundle updated = item.toTransferBundle();
+        assertNotSame(bundle, updated);
+        assertEquals("title", MediaItem2.fromBundle(updated).getMetadata()
+                .getString(MediaMetadata2.METADATA_KEY_TITLE));
+    }
+
+    /**
+     * Measures marshalling a media item with artwork, with the bitmap inlined and with the
+     * bitmap carried by its Uri.
+     */
+    @Test
+    @LargeTest
+    public void testMarshallingBenchmark() {
+        final int count = 100;
+        // Small enough to be written into the parcel rather than into shared memory.
+        final Bitmap bitmap = Bitmap.createBitmap(48, 48, Bitmap.Config.ARGB_8888);
+        Builder builder = new Builder()
+                .putString(MediaMetadata2.METADATA_KEY_MEDIA_ID, "testMarshallingBenchmark")
+                .putString(MediaMetadata2.METADATA_KEY_TITLE, "title")
+                .putString(MediaMetadata2.METADATA_KEY_ARTIST, "artist")
+                .putLong(MediaMetadata2.METADATA_KEY_DURATION, 180000)
+                .putBitmap(MediaMetadata2.METADATA_KEY_ART, bitmap);
+        final MediaItem2 inlineItem = new MediaItem2.Builder(MediaItem2.FLAG_PLAYABLE)
+                .setMetadata(builder.build()).build();
+        builder.putString(MediaMetadata2.METADATA_KEY_ART_URI, "content://art");
+        final MediaItem2 uriItem = new MediaItem2.Builder(MediaItem2.FLAG_PLAYABLE)
+                .setMetadata(builder.build()).build();
+
+        long start = SystemClock.elapsedRealtime();
+        final int inlineSize = marshall(inlineItem, count);
+        final long inlineTime = SystemClock.elapsedRealtime() - start;
+
+        start = SystemClock.elapsedRealtime();
+        final int uriSize = marshall(uriItem, count);
+        final long uriTime = SystemClock.elapsedRealtime() - start;
+        assertTrue(uriSize < inlineSize);
+
+        Log.d(TAG, "Marshalling " + count + " items: inline artwork " + inlineTime + "ms, "
+                + inlineSize + " bytes per item, artwork by Uri " + uriTime + "ms, "
+                + uriSize + " bytes per item");
+    }
+
+    private static int marshall(MediaItem2 item, int count) {
+        int size = 0;
+        for (int i = 0; i < count; i++) {
+            Parcel parcel = Parcel.obtain();
+            parcel.writeBundle(item.toTransferBundle());
+            size = parcel.dataSize();
+            parcel.recycle();
+        }
+        return size;
+    }
 }
@@ -61,6 +61,7 @@ import android.os.Message;
 import android.os.Messenger;
 import android.os.Parcel;
 import android.os.RemoteException;
+import android.os.SystemClock;
 import android.support.v4.media.MediaBrowserCompat;
 import android.support.v4.media.session.IMediaSession;
 import android.support.v4.media.session.MediaSessionCompat;
@@ -176,6 +177,13 @@ public abstract class MediaBrowserServiceCompat extends Service {
     final ServiceHandler mHandler = new ServiceHandler();
     MediaSessionCompat.Token mSession;
 
+    // The following fields are only accessed on the thread of mHandler.
+    boolean mChildrenCacheEnabled;
+    // Full lists of children of subscribed parents, by parent id.
+    final ArrayMap<String, List<MediaBrowserCompat.MediaItem>> mChildrenCache = new ArrayMap<>();
+    // Incremented when cached children are invalidated, so that lists loaded before aren't kept.
+    int mChildrenCacheGeneration;
+
     interface MediaBrowserServiceImpl {
         void onCreate();
         IBinder onBind(Intent intent);
@@ -442,11 +450,19 @@ public abstract class MediaBrowserServiceCompat extends Service {
 
         @Override
         public void onLoadChildren(String parentId,
-                final MediaBrowserServiceCompatApi26.ResultWrapper resultWrapper, Bundle options) {
+                final MediaBrowserServiceCompatApi26.ResultWrapper resultWrapper,
+                final Bundle options) {
             final Result<List<MediaBrowserCompat.MediaItem>> result
                     = new Result<List<MediaBrowserCompat.MediaItem>>(parentId) {
                 @Override
                 void onResultSent(List<MediaBrowserCompat.MediaItem> list) {
+                    int flags = getFlags();
+                    if (options != null && (flags & RESULT_FLAG_OPTION_NOT_HANDLED) != 0) {
+                        // Apply the options here rather than in the framework, so that only the
+                        // requested page is written to parcels.
+                        list = applyOptions(list, options);
+                        flags &= ~RESULT_FLAG_OPTION_NOT_HANDLED;
+                    }
                     List<Parcel> parcelList = null;
                     if (list != null) {
                         parcelList = new ArrayList<>();
@@ -456,7 +472,7 @@ public abstract class MediaBrowserServiceCompat extends Service {
                             parcelList.add(parcel);
                         }
                     }
-                    resultWrapper.sendResult(parcelList, getFlags());
+                    resultWrapper.sendResult(parcelList, flags);
                 }
 
                 @Override
@@ -586,6 +602,7 @@ public abstract class MediaBrowserServiceCompat extends Service {
                 @Override
                 public void run() {
                     mConnections.remove(callbacks.asBinder());
+                    pruneChildrenCache();
                 }
             });
         }
@@ -803,6 +820,7 @@ public abstract class MediaBrowserServiceCompat extends Service {
                     if (old != null) {
                         // TODO
                         old.callbacks.asBinder().unlinkToDeath(old, 0);
+                        pruneChildrenCache();
                     }
                 }
             });
@@ -902,6 +920,7 @@ public abstract class MediaBrowserServiceCompat extends Service {
                     ConnectionRecord old = mConnections.remove(b);
                     if (old != null) {
                         b.unlinkToDeath(old, 0);
+                        pruneChildrenCache();
                     }
                 }
             });
@@ -1114,6 +1133,12 @@ public abstract class MediaBrowserServiceCompat extends Service {
      * with an empty list. When the given {@code parentId} is invalid, implementations must
      * call {@link Result#sendResult result.sendResult} with {@code null}, which will invoke
      * {@link MediaBrowserCompat.SubscriptionCallback#onError}.
+     * </p><p>
+     * When the options contain {@link MediaBrowserCompat#EXTRA_PAGE} and
+     * {@link MediaBrowserCompat#EXTRA_PAGE_SIZE}, implementations should only load and send the
+     * requested page of children. The default implementation sends all the children loaded by
+     * {@link #onLoadChildren(String, Result)} and the requested page is then taken from them,
+     * see {@link #setChildrenCacheEnabled}.
      * </p>
      *
      * @param parentId The id of the parent media item whose children are to be
@@ -1252,6 +1277,37 @@ public abstract class MediaBrowserServiceCompat extends Service {
         return mImpl.getBrowserRootHints();
     }
 
+    /**
+     * Sets whether the children loaded by {@link #onLoadChildren(String, Result)} are kept while
+     * media browsers are subscribed to their parent. Pages of kept children that are requested
+     * with {@link MediaBrowserCompat#EXTRA_PAGE} and {@link MediaBrowserCompat#EXTRA_PAGE_SIZE}
+     * are then sent without loading all the children again. Kept children are dropped when
+     * {@link #notifyChildrenChanged} is called for their parent, or when no media browser is
+     * subscribed to it anymore.
+     * <p>
+     * Kept children are sent for any options of a subscription, so this should only be enabled
+     * when the children of a parent don't depend on other options. Children sent by an
+     * implementation of {@link #onLoadChildren(String, Result, Bundle)} that handles the options
+     * are not kept. This only applies to media browsers that are connected with
+     * {@link MediaBrowserCompat}.
+     * <p>
+     * Caching is disabled by default.
+     *
+     * @param enabled Whether to keep loaded children.
+     */
+    public void setChildrenCacheEnabled(final boolean enabled) {
+        mHandler.postOrRun(new Runnable() {
+            @Override
+            public void run() {
+                mChildrenCacheEnabled = enabled;
+                if (!enabled) {
+                    mChildrenCache.clear();
+                    mChildrenCacheGeneration++;
+                }
+            }
+        });
+    }
+
     /**
      * Notifies all connected media browsers that the children of
      * the specified parent id have changed in some way.
@@ -1264,6 +1320,7 @@ public abstract class MediaBrowserServiceCompat extends Service {
         if (parentId == null) {
             throw new IllegalArgumentException("parentId cannot be null in notifyChildrenChanged");
         }
+        invalidateChildren(parentId);
         mImpl.notifyChildrenChanged(parentId, null);
     }
 
@@ -1285,9 +1342,43 @@ public abstract class MediaBrowserServiceCompat extends Service {
         if (options == null) {
             throw new IllegalArgumentException("options cannot be null in notifyChildrenChanged");
         }
+        invalidateChildren(parentId);
         mImpl.notifyChildrenChanged(parentId, options);
     }
 
+    /**
+     * Drops the kept children of the given parent before browsers are notified of the change.
+     */
+    private void invalidateChildren(final String parentId) {
+        mHandler.postOrRun(new Runnable() {
+            @Override
+            public void run() {
+                mChildrenCache.remove(parentId);
+                mChildrenCacheGeneration++;
+            }
+        });
+    }
+
+    /**
+     * Drops the kept children of parents that no connected browser is subscribed to.
+     */
+    void pruneChildrenCache() {
+        for (int i = mChildrenCache.size() - 1; i >= 0; i--) {
+            if (!isSubscribed(mChildrenCache.keyAt(i))) {
+                mChildrenCache.removeAt(i);
+            }
+        }
+    }
+
+    boolean isSubscribed(String parentId) {
+        for (int i = 0; i < mConnections.size(); i++) {
+            if (mConnections.valueAt(i).subscriptions.containsKey(parentId)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     /**
      * Return whether the given package is one of the ones that is owned by the uid.
      */
@@ -1333,7 +1424,11 @@ public abstract class MediaBrowserServiceCompat extends Service {
      */
     boolean removeSubscription(String id, ConnectionRecord connection, IBinder token) {
         if (token == null) {
-            return connection.subscriptions.remove(id) != null;
+            if (connection.subscriptions.remove(id) == null) {
+                return false;
+            }
+            pruneChildrenCache();
+            return true;
         }
         boolean removed = false;
         List<Pair<IBinder, Bundle>> callbackList = connection.subscriptions.get(id);
@@ -1349,6 +1444,9 @@ public abstract class MediaBrowserServiceCompat extends Service {
                 connection.subscriptions.remove(id);
             }
         }
+        if (removed) {
+            pruneChildrenCache();
+        }
         return removed;
     }
 
@@ -1359,6 +1457,18 @@ public abstract class MediaBrowserServiceCompat extends Service {
      */
     void performLoadChildren(final String parentId, final ConnectionRecord connection,
             final Bundle options) {
+        final long startTime = DEBUG ? SystemClock.elapsedRealtime() : 0;
+        if (mChildrenCacheEnabled) {
+            List<MediaBrowserCompat.MediaItem> cachedList = mChildrenCache.get(parentId);
+            if (cachedList != null) {
+                sendChildren(parentId, connection,
+                        options == null ? cachedList : applyOptions(cachedList, options),
+                        options, startTime, true);
+                return;
+            }
+        }
+
+        final int cacheGeneration = mChildrenCacheGeneration;
         final Result<List<MediaBrowserCompat.MediaItem>> result
                 = new Result<List<MediaBrowserCompat.MediaItem>>(parentId) {
             @Override
@@ -1371,16 +1481,14 @@ public abstract class MediaBrowserServiceCompat extends Service {
                     return;
                 }
 
-                List<MediaBrowserCompat.MediaItem> filteredList =
-                        (getFlags() & RESULT_FLAG_OPTION_NOT_HANDLED) != 0
-                                ? applyOptions(list, options) : list;
-                try {
-                    connection.callbacks.onLoadChildren(parentId, filteredList, options);
-                } catch (RemoteException ex) {
-                    // The other side is in the process of crashing.
-                    Log.w(TAG, "Calling onLoadChildren() failed for id=" + parentId
-                            + " package=" + connection.pkg);
+                final boolean optionsNotHandled =
+                        (getFlags() & RESULT_FLAG_OPTION_NOT_HANDLED) != 0;
+                if (list != null && (options == null || optionsNotHandled)) {
+                    cacheChildren(parentId, list, cacheGeneration);
                 }
+                List<MediaBrowserCompat.MediaItem> filteredList =
+                        optionsNotHandled ? applyOptions(list, options) : list;
+                sendChildren(parentId, connection, filteredList, options, startTime, false);
             }
         };
 
@@ -1398,6 +1506,56 @@ public abstract class MediaBrowserServiceCompat extends Service {
         }
     }
 
+    /**
+     * Keeps the full list of children of a parent, unless caching is disabled or the children
+     * have been invalidated since they started loading.
+     */
+    void cacheChildren(final String parentId, List<MediaBrowserCompat.MediaItem> list,
+            final int cacheGeneration) {
+        // Copy the list in case the implementation keeps modifying it.
+        final List<MediaBrowserCompat.MediaItem> copy = new ArrayList<>(list);
+        mHandler.postOrRun(new Runnable() {
+            @Override
+            public void run() {
+                if (mChildrenCacheEnabled && cacheGeneration == mChildrenCacheGeneration
+                        && isSubscribed(parentId)) {
+                    mChildrenCache.put(parentId, copy);
+                }
+            }
+        });
+    }
+
+    void sendChildren(String parentId, ConnectionRecord connection,
+            List<MediaBrowserCompat.MediaItem> list, Bundle options, long startTime,
+            boolean cached) {
+        try {
+            connection.callbacks.onLoadChildren(parentId, list, options);
+        } catch (RemoteException ex) {
+            // The other side is in the process of crashing.
+            Log.w(TAG, "Calling onLoadChildren() failed for id=" + parentId
+                    + " package=" + connection.pkg);
+        }
+        if (DEBUG) {
+            Log.d(TAG, "Sent " + (list == null ? "no" : list.size()) + " children of "
+                    + parentId + (cached ? " from cache" : "") + " to " + connection.pkg
+                    + " in " + (SystemClock.elapsedRealtime() - startTime) + "ms, "
+                    + getParcelSize(list) + " bytes");
+        }
+    }
+
+    private static int getParcelSize(List<MediaBrowserCompat.MediaItem> list) {
+        if (list == null) {
+            return 0;
+        }
+        Parcel parcel = Parcel.obtain();
+        try {
+            parcel.writeTypedList(list);
+            return parcel.dataSize();
+        } finally {
+            parcel.recycle();
+        }
+    }
+
     List<MediaBrowserCompat.MediaItem> applyOptions(List<MediaBrowserCompat.MediaItem> list,
             final Bundle options) {
         if (list == null) {
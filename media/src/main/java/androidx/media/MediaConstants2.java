@@ -73,6 +73,17 @@ class MediaConstants2 {
     static final String ARGUMENT_PLAYLIST = "androidx.media.argument.PLAYLIST";
     static final String ARGUMENT_PLAYLIST_INDEX = "androidx.media.argument.PLAYLIST_INDEX";
     static final String ARGUMENT_PLAYLIST_METADATA = "androidx.media.argument.PLAYLIST_METADATA";
+    static final String ARGUMENT_PLAYLIST_VERSION = "androidx.media.argument.PLAYLIST_VERSION";
+    static final String ARGUMENT_PLAYLIST_REMOVED_COUNT =
+            "androidx.media.argument.PLAYLIST_REMOVED_COUNT";
+    static final String ARGUMENT_PLAYLIST_ADDED_ITEMS =
+            "androidx.media.argument.PLAYLIST_ADDED_ITEMS";
+    static final String ARGUMENT_PLAYLIST_METADATA_VERSION =
+            "androidx.media.argument.PLAYLIST_METADATA_VERSION";
+    static final String ARGUMENT_PLAYLIST_METADATA_CHANGED_FIELDS =
+            "androidx.media.argument.PLAYLIST_METADATA_CHANGED_FIELDS";
+    static final String ARGUMENT_PLAYLIST_METADATA_REMOVED_KEYS =
+            "androidx.media.argument.PLAYLIST_METADATA_REMOVED_KEYS";
     static final String ARGUMENT_RATING = "androidx.media.argument.RATING";
     static final String ARGUMENT_MEDIA_ITEM = "androidx.media.argument.MEDIA_ITEM";
     static final String ARGUMENT_MEDIA_ID = "androidx.media.argument.MEDIA_ID";
@@ -37,8 +37,14 @@ import static androidx.media.MediaConstants2.ARGUMENT_PLAYBACK_SPEED;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYBACK_STATE_COMPAT;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYER_STATE;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_ADDED_ITEMS;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_INDEX;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_METADATA;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_METADATA_CHANGED_FIELDS;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_METADATA_REMOVED_KEYS;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_METADATA_VERSION;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_REMOVED_COUNT;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_VERSION;
 import static androidx.media.MediaConstants2.ARGUMENT_QUERY;
 import static androidx.media.MediaConstants2.ARGUMENT_RATING;
 import static androidx.media.MediaConstants2.ARGUMENT_REPEAT_MODE;
@@ -80,6 +86,8 @@ import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYBACK_RESET;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYBACK_SEEK_TO;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYBACK_SET_SPEED;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_ADD_ITEM;
+import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_GET_LIST;
+import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_GET_LIST_METADATA;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_REMOVE_ITEM;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_REPLACE_ITEM;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_SET_LIST;
@@ -138,6 +146,7 @@ import androidx.media.MediaSession2.ErrorCode;
 
 import java.lang.annotation.Retention;
 import java.lang.annotation.RetentionPolicy;
+import java.util.ArrayList;
 import java.util.List;
 import java.util.concurrent.Executor;
 
@@ -574,22 +583,74 @@ public class MediaController2 implements AutoCloseable {
                 case SESSION_EVENT_ON_PLAYLIST_CHANGED: {
                     MediaMetadata2 playlistMetadata = MediaMetadata2.fromBundle(
                             extras.getBundle(ARGUMENT_PLAYLIST_METADATA));
-                    List<MediaItem2> playlist = MediaUtils2.fromMediaItem2ParcelableArray(
-                            extras.getParcelableArray(ARGUMENT_PLAYLIST));
+                    int version = extras.getInt(ARGUMENT_PLAYLIST_VERSION);
+                    int metadataVersion = extras.getInt(ARGUMENT_PLAYLIST_METADATA_VERSION);
+                    List<MediaItem2> playlist = null;
+                    boolean requestPlaylist = false;
                     synchronized (mLock) {
-                        mPlaylist = playlist;
-                        mPlaylistMetadata = playlistMetadata;
+                        if (version != 0 && version <= mPlaylistVersion) {
+                            // Already part of a playlist that was requested from the session.
+                            return;
+                        }
+                        if (extras.containsKey(ARGUMENT_PLAYLIST)) {
+                            playlist = MediaUtils2.fromMediaItem2ParcelableArray(
+                                    extras.getParcelableArray(ARGUMENT_PLAYLIST));
+                            mPlaylistRequested = false;
+                        } else if (mPlaylist != null && version == mPlaylistVersion + 1) {
+                            playlist = applyPlaylistChange(mPlaylist, extras);
+                        } else {
+                            // A change was missed, so the whole playlist is needed.
+                            mPlaylistMissedVersion = Math.max(mPlaylistMissedVersion, version);
+                            requestPlaylist = !mPlaylistRequested;
+                            mPlaylistRequested = true;
+                        }
+                        if (playlist != null) {
+                            mPlaylist = playlist;
+                            mPlaylistVersion = version;
+                            updatePlaylistMetadataLocked(playlistMetadata, metadataVersion);
+                            playlistMetadata = mPlaylistMetadata;
+                        }
+                    }
+                    if (requestPlaylist) {
+                        requestPlaylist();
+                    }
+                    if (playlist != null) {
+                        mCallback.onPlaylistChanged(MediaController2.this, playlist,
+                                playlistMetadata);
                     }
-                    mCallback.onPlaylistChanged(MediaController2.this, playlist, playlistMetadata);
                     break;
                 }
                 case SESSION_EVENT_ON_PLAYLIST_METADATA_CHANGED: {
-                    MediaMetadata2 playlistMetadata = MediaMetadata2.fromBundle(
+                    final boolean isChange =
+                            extras.containsKey(ARGUMENT_PLAYLIST_METADATA_CHANGED_FIELDS);
+                    MediaMetadata2 playlistMetadata = isChange ? null : MediaMetadata2.fromBundle(
                             extras.getBundle(ARGUMENT_PLAYLIST_METADATA));
+                    int version = extras.getInt(ARGUMENT_PLAYLIST_METADATA_VERSION);
+                    boolean changed = false;
+                    boolean requestPlaylistMetadata = false;
                     synchronized (mLock) {
-                        mPlaylistMetadata = playlistMetadata;
+                        if (!isChange) {
+                            changed = updatePlaylistMetadataLocked(playlistMetadata, version);
+                        } else if (mPlaylistMetadata != null
+                                && version == mPlaylistMetadataVersion + 1) {
+                            playlistMetadata = applyPlaylistMetadataChange(
+                                    mPlaylistMetadata, extras);
+                            changed = updatePlaylistMetadataLocked(playlistMetadata, version);
+                        } else if (version > mPlaylistMetadataVersion) {
+                            // A change was missed, so the whole metadata is needed.
+                            mPlaylistMetadataMissedVersion =
+                                    Math.max(mPlaylistMetadataMissedVersion, version);
+                            requestPlaylistMetadata = !mPlaylistMetadataRequested;
+                            mPlaylistMetadataRequested = true;
+                        }
+                    }
+                    if (requestPlaylistMetadata) {
+                        requestPlaylistMetadata();
+                    }
+                    if (changed) {
+                        mCallback.onPlaylistMetadataChanged(MediaController2.this,
+                                playlistMetadata);
                     }
-                    mCallback.onPlaylistMetadataChanged(MediaController2.this, playlistMetadata);
                     break;
                 }
                 case SESSION_EVENT_ON_REPEAT_MODE_CHANGED: {
@@ -696,8 +757,24 @@ public class MediaController2 implements AutoCloseable {
     private boolean mIsReleased;
     @GuardedBy("mLock")
     private List<MediaItem2> mPlaylist;
+    // Version of mPlaylist in the session, which is incremented with each change.
+    @GuardedBy("mLock")
+    private int mPlaylistVersion;
+    // Latest version of the playlist whose change couldn't be applied.
+    @GuardedBy("mLock")
+    private int mPlaylistMissedVersion;
+    @GuardedBy("mLock")
+    private boolean mPlaylistRequested;
     @GuardedBy("mLock")
     private MediaMetadata2 mPlaylistMetadata;
+    // Version of mPlaylistMetadata in the session, which is incremented with each change.
+    @GuardedBy("mLock")
+    private int mPlaylistMetadataVersion;
+    // Latest version of the playlist metadata whose change couldn't be applied.
+    @GuardedBy("mLock")
+    private int mPlaylistMetadataMissedVersion;
+    @GuardedBy("mLock")
+    private boolean mPlaylistMetadataRequested;
     @GuardedBy("mLock")
     private @RepeatMode int mRepeatMode;
     @GuardedBy("mLock")
@@ -1586,12 +1663,14 @@ public class MediaController2 implements AutoCloseable {
         final int shuffleMode = data.getInt(ARGUMENT_SHUFFLE_MODE);
         final List<MediaItem2> playlist = MediaUtils2.fromMediaItem2ParcelableArray(
                 data.getParcelableArray(ARGUMENT_PLAYLIST));
+        final int playlistVersion = data.getInt(ARGUMENT_PLAYLIST_VERSION);
         final MediaItem2 currentMediaItem = MediaItem2.fromBundle(
                 data.getBundle(ARGUMENT_MEDIA_ITEM));
         final PlaybackInfo playbackInfo =
                 PlaybackInfo.fromBundle(data.getBundle(ARGUMENT_PLAYBACK_INFO));
         final MediaMetadata2 metadata = MediaMetadata2.fromBundle(
                 data.getBundle(ARGUMENT_PLAYLIST_METADATA));
+        final int metadataVersion = data.getInt(ARGUMENT_PLAYLIST_METADATA_VERSION);
         if (DEBUG) {
             Log.d(TAG, "onConnectedNotLocked sessionCompatToken=" + mToken.getSessionCompatToken()
                     + ", allowedCommands=" + allowedCommands);
@@ -1614,9 +1693,15 @@ public class MediaController2 implements AutoCloseable {
                 mPlaybackStateCompat = playbackStateCompat;
                 mRepeatMode = repeatMode;
                 mShuffleMode = shuffleMode;
-                mPlaylist = playlist;
+                if (mPlaylist == null || playlistVersion >= mPlaylistVersion) {
+                    // Changes may have been received before the connection result.
+                    mPlaylist = playlist;
+                    mPlaylistVersion = playlistVersion;
+                }
+                mPlaylistRequested = false;
                 mCurrentMediaItem = currentMediaItem;
-                mPlaylistMetadata = metadata;
+                updatePlaylistMetadataLocked(metadata, metadataVersion);
+                mPlaylistMetadataRequested = false;
                 mConnected = true;
                 mPlaybackInfo = playbackInfo;
             }
@@ -1691,6 +1776,145 @@ public class MediaController2 implements AutoCloseable {
         }
     }
 
+    /**
+     * Applies a playlist change sent by the session, which replaces a range of items of the
+     * playlist with the added items.
+     */
+    private static List<MediaItem2> applyPlaylistChange(List<MediaItem2> playlist,
+            Bundle change) {
+        final int index = change.getInt(ARGUMENT_PLAYLIST_INDEX);
+        final int removedCount = change.getInt(ARGUMENT_PLAYLIST_REMOVED_COUNT);
+        final List<MediaItem2> addedItems = MediaUtils2.fromMediaItem2ParcelableArray(
+                change.getParcelableArray(ARGUMENT_PLAYLIST_ADDED_ITEMS));
+        // The playlist is copied, as lists given to the callback must not change afterwards.
+        final List<MediaItem2> newPlaylist = new ArrayList<>(
+                playlist.size() - removedCount + addedItems.size());
+        newPlaylist.addAll(playlist.subList(0, index));
+        newPlaylist.addAll(addedItems);
+        newPlaylist.addAll(playlist.subList(index + removedCount, playlist.size()));
+        return newPlaylist;
+    }
+
+    /**
+     * Requests the whole playlist from the session, after a change to it was missed.
+     */
+    private void requestPlaylist() {
+        Bundle args = new Bundle();
+        args.putInt(ARGUMENT_COMMAND_CODE, COMMAND_CODE_PLAYLIST_GET_LIST);
+        sendCommand(CONTROLLER_COMMAND_BY_COMMAND_CODE, args, new ResultReceiver(mHandler) {
+            @Override
+            protected void onReceiveResult(int resultCode, Bundle resultData) {
+                if (!mHandlerThread.isAlive() || resultData == null) {
+                    return;
+                }
+                onPlaylistReceived(resultData);
+            }
+        });
+    }
+
+    void onPlaylistReceived(Bundle data) {
+        final List<MediaItem2> playlist = MediaUtils2.fromMediaItem2ParcelableArray(
+                data.getParcelableArray(ARGUMENT_PLAYLIST));
+        final int version = data.getInt(ARGUMENT_PLAYLIST_VERSION);
+        MediaMetadata2 playlistMetadata = MediaMetadata2.fromBundle(
+                data.getBundle(ARGUMENT_PLAYLIST_METADATA));
+        final int metadataVersion = data.getInt(ARGUMENT_PLAYLIST_METADATA_VERSION);
+        final boolean changed;
+        boolean requestAgain;
+        synchronized (mLock) {
+            mPlaylistRequested = false;
+            changed = version > mPlaylistVersion;
+            if (changed) {
+                mPlaylist = playlist;
+                mPlaylistVersion = version;
+                updatePlaylistMetadataLocked(playlistMetadata, metadataVersion);
+                playlistMetadata = mPlaylistMetadata;
+            }
+            // Changes missed after the playlist was sent can't be applied anymore.
+            requestAgain = mPlaylistMissedVersion > mPlaylistVersion;
+            mPlaylistRequested = requestAgain;
+        }
+        if (requestAgain) {
+            requestPlaylist();
+        }
+        if (changed) {
+            mCallback.onPlaylistChanged(MediaController2.this, playlist, playlistMetadata);
+        }
+    }
+
+    /**
+     * Applies a playlist metadata change sent by the session, which puts the changed fields and
+     * removes the fields of the removed keys.
+     */
+    private static MediaMetadata2 applyPlaylistMetadataChange(MediaMetadata2 metadata,
+            Bundle change) {
+        // The fields are copied, as metadata given to the callback must not change afterwards.
+        final Bundle fields = new Bundle(metadata.toBundle());
+        final List<String> removedKeys =
+                change.getStringArrayList(ARGUMENT_PLAYLIST_METADATA_REMOVED_KEYS);
+        if (removedKeys != null) {
+            for (int i = 0; i < removedKeys.size(); i++) {
+                fields.remove(removedKeys.get(i));
+            }
+        }
+        final Bundle changedFields = change.getBundle(ARGUMENT_PLAYLIST_METADATA_CHANGED_FIELDS);
+        if (changedFields != null) {
+            fields.putAll(changedFields);
+        }
+        return MediaMetadata2.fromBundle(fields);
+    }
+
+    /**
+     * Keeps the playlist metadata sent by the session, unless newer metadata was already
+     * received. Returns whether the metadata was kept.
+     */
+    @GuardedBy("mLock")
+    private boolean updatePlaylistMetadataLocked(MediaMetadata2 metadata, int version) {
+        if (version != 0 && version <= mPlaylistMetadataVersion) {
+            return false;
+        }
+        mPlaylistMetadata = metadata;
+        mPlaylistMetadataVersion = version;
+        return true;
+    }
+
+    /**
+     * Requests the playlist metadata from the session, after a change to it was missed.
+     */
+    private void requestPlaylistMetadata() {
+        Bundle args = new Bundle();
+        args.putInt(ARGUMENT_COMMAND_CODE, COMMAND_CODE_PLAYLIST_GET_LIST_METADATA);
+        sendCommand(CONTROLLER_COMMAND_BY_COMMAND_CODE, args, new ResultReceiver(mHandler) {
+            @Override
+            protected void onReceiveResult(int resultCode, Bundle resultData) {
+                if (!mHandlerThread.isAlive() || resultData == null) {
+                    return;
+                }
+                onPlaylistMetadataReceived(resultData);
+            }
+        });
+    }
+
+    void onPlaylistMetadataReceived(Bundle data) {
+        final MediaMetadata2 playlistMetadata = MediaMetadata2.fromBundle(
+                data.getBundle(ARGUMENT_PLAYLIST_METADATA));
+        final int version = data.getInt(ARGUMENT_PLAYLIST_METADATA_VERSION);
+        final boolean changed;
+        final boolean requestAgain;
+        synchronized (mLock) {
+            changed = updatePlaylistMetadataLocked(playlistMetadata, version);
+            // Changes missed after the metadata was sent can't be applied anymore.
+            requestAgain = mPlaylistMetadataMissedVersion > mPlaylistMetadataVersion;
+            mPlaylistMetadataRequested = requestAgain;
+        }
+        if (requestAgain) {
+            requestPlaylistMetadata();
+        }
+        if (changed) {
+            mCallback.onPlaylistMetadataChanged(MediaController2.this, playlistMetadata);
+        }
+    }
+
     private void sendCommand(int commandCode) {
         sendCommand(commandCode, null);
     }
@@ -68,6 +68,8 @@ public class MediaItem2 {
     private final UUID mUUID;
     private MediaMetadata2 mMetadata;
     private DataSourceDesc mDataSourceDesc;
+    // Bundle returned by toTransferBundle(), which is created again when the metadata is changed.
+    private volatile Bundle mTransferBundle;
 
     private MediaItem2(@NonNull String mediaId, @Nullable DataSourceDesc dsd,
             @Nullable MediaMetadata2 metadata, @Flags int flags) {
@@ -105,6 +107,26 @@ public class MediaItem2 {
         return bundle;
     }
 
+    /**
+     * Returns this object as a bundle for a session to send to its controllers. Bitmaps are left
+     * out of the metadata as with {@link MediaMetadata2#toTransferBundle()}. The bundle is kept
+     * until the metadata is changed, and must not be modified.
+     */
+    Bundle toTransferBundle() {
+        Bundle bundle = mTransferBundle;
+        if (bundle == null) {
+            bundle = new Bundle();
+            bundle.putString(KEY_ID, mId);
+            bundle.putInt(KEY_FLAGS, mFlags);
+            if (mMetadata != null) {
+                bundle.putBundle(KEY_METADATA, mMetadata.toTransferBundle());
+            }
+            bundle.putString(KEY_UUID, mUUID.toString());
+            mTransferBundle = bundle;
+        }
+        return bundle;
+    }
+
     /**
      * Create a MediaItem2 from the {@link Bundle}.
      *
@@ -183,6 +205,7 @@ public class MediaItem2 {
             throw new IllegalArgumentException("metadata's id should be matched with the mediaId");
         }
         mMetadata = metadata;
+        mTransferBundle = null;
     }
 
     /**
@@ -618,6 +618,8 @@ public final class MediaMetadata2 {
     };
 
     final Bundle mBundle;
+    // Bundle sent to other processes, which is created once as the metadata is immutable.
+    private volatile Bundle mTransferBundle;
 
     MediaMetadata2(Bundle bundle) {
         mBundle = new Bundle(bundle);
@@ -799,6 +801,29 @@ public final class MediaMetadata2 {
         return mBundle;
     }
 
+    /**
+     * Gets the bundle for sending the metadata to other processes. Bitmaps are left out when the
+     * Uri of the same artwork is also given, so that the artwork is carried by reference instead
+     * of being copied into every transaction. The bundle is shared, and must not be modified.
+     */
+    @NonNull Bundle toTransferBundle() {
+        Bundle bundle = mTransferBundle;
+        if (bundle == null) {
+            bundle = mBundle;
+            for (int i = 0; i < PREFERRED_BITMAP_ORDER.length; i++) {
+                if (mBundle.containsKey(PREFERRED_BITMAP_ORDER[i])
+                        && mBundle.getCharSequence(PREFERRED_URI_ORDER[i]) != null) {
+                    if (bundle == mBundle) {
+                        bundle = new Bundle(mBundle);
+                    }
+                    bundle.remove(PREFERRED_BITMAP_ORDER[i]);
+                }
+            }
+            mTransferBundle = bundle;
+        }
+        return bundle;
+    }
+
     /**
      * Creates the {@link MediaMetadata2} from the bundle that previously returned by
      * {@link #toBundle()}.
@@ -1022,6 +1047,10 @@ public final class MediaMetadata2 {
          * {@link android.media.session.MediaSession#setMetadata} is called.
          * To pass full resolution images {@link Uri Uris} should be used with
          * {@link #putString}.
+         * <p>
+         * When the Uri of the same artwork is also put, such as {@link #METADATA_KEY_ART_URI}
+         * for {@link #METADATA_KEY_ART}, the bitmap isn't sent to controllers in other processes,
+         * which should load the artwork from the Uri instead.
          *
          * @param key The key for referencing this value
          * @param value The Bitmap to store
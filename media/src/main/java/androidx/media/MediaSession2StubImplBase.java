@@ -34,8 +34,14 @@ import static androidx.media.MediaConstants2.ARGUMENT_PLAYBACK_SPEED;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYBACK_STATE_COMPAT;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYER_STATE;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_ADDED_ITEMS;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_INDEX;
 import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_METADATA;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_METADATA_CHANGED_FIELDS;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_METADATA_REMOVED_KEYS;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_METADATA_VERSION;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_REMOVED_COUNT;
+import static androidx.media.MediaConstants2.ARGUMENT_PLAYLIST_VERSION;
 import static androidx.media.MediaConstants2.ARGUMENT_QUERY;
 import static androidx.media.MediaConstants2.ARGUMENT_RATING;
 import static androidx.media.MediaConstants2.ARGUMENT_REPEAT_MODE;
@@ -77,6 +83,7 @@ import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYBACK_SET_SPEED;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_ADD_ITEM;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_GET_CURRENT_MEDIA_ITEM;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_GET_LIST;
+import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_GET_LIST_METADATA;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_REMOVE_ITEM;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_REPLACE_ITEM;
 import static androidx.media.SessionCommand2.COMMAND_CODE_PLAYLIST_SET_LIST;
@@ -119,6 +126,7 @@ import android.util.SparseArray;
 import androidx.annotation.GuardedBy;
 import androidx.annotation.NonNull;
 import androidx.annotation.Nullable;
+import androidx.core.util.ObjectsCompat;
 import androidx.media.MediaController2.PlaybackInfo;
 import androidx.media.MediaSession2.CommandButton;
 import androidx.media.MediaSession2.ControllerInfo;
@@ -160,6 +168,18 @@ class MediaSession2StubImplBase extends MediaSessionCompat.Callback {
     @GuardedBy("mLock")
     private final ArrayMap<ControllerInfo, SessionCommandGroup2> mAllowedCommandGroupMap =
             new ArrayMap<>();
+    // Playlist as last sent to the controllers, which is never modified but replaced.
+    @GuardedBy("mLock")
+    private List<MediaItem2> mPlaylist;
+    // Incremented with each playlist change sent to the controllers, so that they can tell
+    // whether a change applies to the playlist that they have.
+    @GuardedBy("mLock")
+    private int mPlaylistVersion;
+    // Playlist metadata as last sent to the controllers, and its version.
+    @GuardedBy("mLock")
+    private MediaMetadata2 mPlaylistMetadata;
+    @GuardedBy("mLock")
+    private int mPlaylistMetadataVersion;
 
     MediaSession2StubImplBase(MediaSession2.SupportLibraryImpl session) {
         mSession = session;
@@ -279,6 +299,25 @@ class MediaSession2StubImplBase extends MediaSessionCompat.Callback {
                                 mSession.setShuffleMode(shuffleMode);
                                 break;
                             }
+                            case COMMAND_CODE_PLAYLIST_GET_LIST: {
+                                // Sent by controllers that missed a playlist change.
+                                if (cb != null) {
+                                    Bundle result = new Bundle();
+                                    putPlaylist(result);
+                                    putPlaylistMetadata(result);
+                                    cb.send(0, result);
+                                }
+                                break;
+                            }
+                            case COMMAND_CODE_PLAYLIST_GET_LIST_METADATA: {
+                                // Sent by controllers that missed a playlist metadata change.
+                                if (cb != null) {
+                                    Bundle result = new Bundle();
+                                    putPlaylistMetadata(result);
+                                    cb.send(0, result);
+                                }
+                                break;
+                            }
                             case COMMAND_CODE_PLAYLIST_SET_LIST: {
                                 List<MediaItem2> list = MediaUtils2.fromMediaItem2ParcelableArray(
                                         extras.getParcelableArray(ARGUMENT_PLAYLIST));
@@ -536,7 +575,7 @@ class MediaSession2StubImplBase extends MediaSessionCompat.Callback {
             @Override
             public void run(ControllerInfo controller) throws RemoteException {
                 Bundle bundle = new Bundle();
-                bundle.putBundle(ARGUMENT_MEDIA_ITEM, item.toBundle());
+                bundle.putBundle(ARGUMENT_MEDIA_ITEM, item.toTransferBundle());
                 controller.getControllerBinder().onEvent(
                         SESSION_EVENT_ON_CURRENT_MEDIA_ITEM_CHANGED, bundle);
             }
@@ -585,7 +624,7 @@ class MediaSession2StubImplBase extends MediaSessionCompat.Callback {
             @Override
             public void run(ControllerInfo controller) throws RemoteException {
                 Bundle bundle = new Bundle();
-                bundle.putBundle(ARGUMENT_MEDIA_ITEM, item.toBundle());
+                bundle.putBundle(ARGUMENT_MEDIA_ITEM, item.toTransferBundle());
                 bundle.putInt(ARGUMENT_BUFFERING_STATE, bufferingState);
                 controller.getControllerBinder().onEvent(
                         SESSION_EVENT_ON_BUFFERING_STATE_CHAGNED, bundle);
@@ -623,33 +662,167 @@ class MediaSession2StubImplBase extends MediaSessionCompat.Callback {
 
     void notifyPlaylistChanged(final List<MediaItem2> playlist,
             final MediaMetadata2 metadata) {
+        final List<MediaItem2> newPlaylist = playlist == null
+                ? new ArrayList<MediaItem2>() : new ArrayList<>(playlist);
+        final List<MediaItem2> oldPlaylist;
+        final int version;
+        final int metadataVersion;
+        synchronized (mLock) {
+            oldPlaylist = mPlaylist;
+            mPlaylist = newPlaylist;
+            version = ++mPlaylistVersion;
+            if (metadata != mPlaylistMetadata) {
+                mPlaylistMetadata = metadata;
+                mPlaylistMetadataVersion++;
+            }
+            metadataVersion = mPlaylistMetadataVersion;
+        }
+        // The bundle is shared by all controllers, so that items are only converted once.
+        final Bundle bundle = new Bundle();
+        putPlaylistChange(bundle, oldPlaylist, newPlaylist, version);
+        bundle.putBundle(ARGUMENT_PLAYLIST_METADATA,
+                metadata == null ? null : metadata.toTransferBundle());
+        bundle.putInt(ARGUMENT_PLAYLIST_METADATA_VERSION, metadataVersion);
         notifyAll(COMMAND_CODE_PLAYLIST_GET_LIST, new Session2Runnable() {
             @Override
             public void run(ControllerInfo controller) throws RemoteException {
-                Bundle bundle = new Bundle();
-                bundle.putParcelableArray(ARGUMENT_PLAYLIST,
-                        MediaUtils2.toMediaItem2ParcelableArray(playlist));
-                bundle.putBundle(ARGUMENT_PLAYLIST_METADATA,
-                        metadata == null ? null : metadata.toBundle());
                 controller.getControllerBinder().onEvent(
                         SESSION_EVENT_ON_PLAYLIST_CHANGED, bundle);
             }
         });
     }
 
+    /**
+     * Puts the whole playlist that was last sent to the controllers and its version.
+     */
+    private void putPlaylist(Bundle bundle) {
+        final List<MediaItem2> playlist;
+        final int version;
+        synchronized (mLock) {
+            if (mPlaylist == null) {
+                List<MediaItem2> current = mSession.getPlaylist();
+                mPlaylist = current == null
+                        ? new ArrayList<MediaItem2>() : new ArrayList<>(current);
+            }
+            playlist = mPlaylist;
+            version = mPlaylistVersion;
+        }
+        bundle.putParcelableArray(ARGUMENT_PLAYLIST,
+                MediaUtils2.toMediaItem2TransferParcelableArray(playlist));
+        bundle.putInt(ARGUMENT_PLAYLIST_VERSION, version);
+    }
+
+    /**
+     * Puts the change between two playlists, as the range of items of the old playlist that was
+     * replaced by the added items. The whole new playlist is put instead when there is no old
+     * playlist, or when most of the items were added. Items are compared by identity, as
+     * playlist agents keep the instances of the items that stay in the playlist.
+     */
+    @SuppressWarnings("ReferenceEquality")
+    private static void putPlaylistChange(Bundle bundle, List<MediaItem2> oldPlaylist,
+            List<MediaItem2> newPlaylist, int version) {
+        bundle.putInt(ARGUMENT_PLAYLIST_VERSION, version);
+        if (oldPlaylist != null) {
+            int start = 0;
+            int oldEnd = oldPlaylist.size();
+            int newEnd = newPlaylist.size();
+            while (start < oldEnd && start < newEnd
+                    && oldPlaylist.get(start) == newPlaylist.get(start)) {
+                start++;
+            }
+            while (oldEnd > start && newEnd > start
+                    && oldPlaylist.get(oldEnd - 1) == newPlaylist.get(newEnd - 1)) {
+                oldEnd--;
+                newEnd--;
+            }
+            if ((newEnd - start) * 2 < newPlaylist.size()) {
+                bundle.putInt(ARGUMENT_PLAYLIST_INDEX, start);
+                bundle.putInt(ARGUMENT_PLAYLIST_REMOVED_COUNT, oldEnd - start);
+                bundle.putParcelableArray(ARGUMENT_PLAYLIST_ADDED_ITEMS,
+                        MediaUtils2.toMediaItem2TransferParcelableArray(
+                                newPlaylist.subList(start, newEnd)));
+                return;
+            }
+        }
+        bundle.putParcelableArray(ARGUMENT_PLAYLIST,
+                MediaUtils2.toMediaItem2TransferParcelableArray(newPlaylist));
+    }
+
+    /**
+     * Puts the playlist metadata of the session and its version. The metadata is recorded as
+     * the last one sent to the controllers, so that later changes are sent relative to it.
+     */
+    private void putPlaylistMetadata(Bundle bundle) {
+        final MediaMetadata2 metadata = mSession.getPlaylistMetadata();
+        final int version;
+        synchronized (mLock) {
+            if (metadata != mPlaylistMetadata) {
+                mPlaylistMetadata = metadata;
+                mPlaylistMetadataVersion++;
+            }
+            version = mPlaylistMetadataVersion;
+        }
+        bundle.putBundle(ARGUMENT_PLAYLIST_METADATA,
+                metadata == null ? null : metadata.toTransferBundle());
+        bundle.putInt(ARGUMENT_PLAYLIST_METADATA_VERSION, version);
+    }
+
     void notifyPlaylistMetadataChanged(final MediaMetadata2 metadata) {
-        notifyAll(SessionCommand2.COMMAND_CODE_PLAYLIST_GET_LIST_METADATA, new Session2Runnable() {
+        final MediaMetadata2 oldMetadata;
+        final int version;
+        synchronized (mLock) {
+            oldMetadata = mPlaylistMetadata;
+            mPlaylistMetadata = metadata;
+            version = ++mPlaylistMetadataVersion;
+        }
+        final Bundle bundle = new Bundle();
+        putPlaylistMetadataChange(bundle, oldMetadata, metadata, version);
+        notifyAll(COMMAND_CODE_PLAYLIST_GET_LIST_METADATA, new Session2Runnable() {
             @Override
             public void run(ControllerInfo controller) throws RemoteException {
-                Bundle bundle = new Bundle();
-                bundle.putBundle(ARGUMENT_PLAYLIST_METADATA,
-                        metadata == null ? null : metadata.toBundle());
                 controller.getControllerBinder().onEvent(
                         SESSION_EVENT_ON_PLAYLIST_METADATA_CHANGED, bundle);
             }
         });
     }
 
+    /**
+     * Puts the change between two playlist metadata, as the fields that were put or changed and
+     * the keys of the removed fields. The whole new metadata is put instead when there is no
+     * old metadata, or when most of the fields were changed. Values that don't override
+     * {@link Object#equals(Object)}, such as bitmaps and bundles, are compared by identity,
+     * which holds for the fields that {@link MediaMetadata2.Builder} copies from the old metadata.
+     */
+    private static void putPlaylistMetadataChange(Bundle bundle, MediaMetadata2 oldMetadata,
+            MediaMetadata2 newMetadata, int version) {
+        bundle.putInt(ARGUMENT_PLAYLIST_METADATA_VERSION, version);
+        if (oldMetadata != null && newMetadata != null) {
+            final Bundle oldFields = oldMetadata.toTransferBundle();
+            final Bundle newFields = newMetadata.toTransferBundle();
+            // Bundle has no generic put, so unchanged fields are removed from a copy instead.
+            final Bundle changedFields = new Bundle(newFields);
+            for (String key : newFields.keySet()) {
+                if (oldFields.containsKey(key)
+                        && ObjectsCompat.equals(oldFields.get(key), newFields.get(key))) {
+                    changedFields.remove(key);
+                }
+            }
+            final ArrayList<String> removedKeys = new ArrayList<>();
+            for (String key : oldFields.keySet()) {
+                if (!newFields.containsKey(key)) {
+                    removedKeys.add(key);
+                }
+            }
+            if ((changedFields.size() + removedKeys.size()) * 2 < newFields.size()) {
+                bundle.putBundle(ARGUMENT_PLAYLIST_METADATA_CHANGED_FIELDS, changedFields);
+                bundle.putStringArrayList(ARGUMENT_PLAYLIST_METADATA_REMOVED_KEYS, removedKeys);
+                return;
+            }
+        }
+        bundle.putBundle(ARGUMENT_PLAYLIST_METADATA,
+                newMetadata == null ? null : newMetadata.toTransferBundle());
+    }
+
     void notifyRepeatModeChanged(final int repeatMode) {
         notifyAll(new Session2Runnable() {
             @Override
@@ -871,25 +1044,19 @@ class MediaSession2StubImplBase extends MediaSessionCompat.Callback {
                             mSession.getPlaybackStateCompat());
                     resultData.putInt(ARGUMENT_REPEAT_MODE, mSession.getRepeatMode());
                     resultData.putInt(ARGUMENT_SHUFFLE_MODE, mSession.getShuffleMode());
-                    final List<MediaItem2> playlist = allowedCommands.hasCommand(
-                            COMMAND_CODE_PLAYLIST_GET_LIST) ? mSession.getPlaylist() : null;
-                    if (playlist != null) {
-                        resultData.putParcelableArray(ARGUMENT_PLAYLIST,
-                                MediaUtils2.toMediaItem2ParcelableArray(playlist));
+                    if (allowedCommands.hasCommand(COMMAND_CODE_PLAYLIST_GET_LIST)) {
+                        putPlaylist(resultData);
                     }
                     final MediaItem2 currentMediaItem =
                             allowedCommands.hasCommand(COMMAND_CODE_PLAYLIST_GET_CURRENT_MEDIA_ITEM)
                                     ? mSession.getCurrentMediaItem() : null;
                     if (currentMediaItem != null) {
-                        resultData.putBundle(ARGUMENT_MEDIA_ITEM, currentMediaItem.toBundle());
+                        resultData.putBundle(ARGUMENT_MEDIA_ITEM,
+                                currentMediaItem.toTransferBundle());
                     }
                     resultData.putBundle(ARGUMENT_PLAYBACK_INFO,
                             mSession.getPlaybackInfo().toBundle());
-                    final MediaMetadata2 playlistMetadata = mSession.getPlaylistMetadata();
-                    if (playlistMetadata != null) {
-                        resultData.putBundle(ARGUMENT_PLAYLIST_METADATA,
-                                playlistMetadata.toBundle());
-                    }
+                    putPlaylistMetadata(resultData);
                     // Double check if session is still there, because close() can be
                     // called in another thread.
                     if (mSession.isClosed()) {
@@ -289,6 +289,19 @@ class MediaUtils2 {
     }
 
     static Parcelable[] toMediaItem2ParcelableArray(List<MediaItem2> playlist) {
+        return toMediaItem2ParcelableArray(playlist, false);
+    }
+
+    /**
+     * Converts the playlist for sending from a session to its controllers. Bitmaps that can be
+     * loaded from a Uri are left out, as with {@link MediaItem2#toTransferBundle()}.
+     */
+    static Parcelable[] toMediaItem2TransferParcelableArray(List<MediaItem2> playlist) {
+        return toMediaItem2ParcelableArray(playlist, true);
+    }
+
+    private static Parcelable[] toMediaItem2ParcelableArray(List<MediaItem2> playlist,
+            boolean transfer) {
         if (playlist == null) {
             return null;
         }
@@ -296,7 +309,7 @@ class MediaUtils2 {
         for (int i = 0; i < playlist.size(); i++) {
             final MediaItem2 item = playlist.get(i);
             if (item != null) {
-                final Parcelable itemBundle = item.toBundle();
+                final Parcelable itemBundle = transfer ? item.toTransferBundle() : item.toBundle();
                 if (itemBundle != null) {
                     parcelableList.add(itemBundle);
                 }
@@ -31,6 +31,7 @@ import java.util.ArrayList;
 import java.util.Collections;
 import java.util.List;
 import java.util.Map;
+import java.util.Random;
 
 @TargetApi(Build.VERSION_CODES.KITKAT)
 class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
@@ -44,6 +45,7 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
     private final Object mLock = new Object();
     private final MediaSession2ImplBase mSession;
     private final MyPlayerEventCallback mPlayerCallback;
+    private final Random mRandom = new Random();
 
     @GuardedBy("mLock")
     private MediaPlayerBase mPlayer;
@@ -52,8 +54,10 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
     // TODO: Check if having the same item is okay (b/74090741)
     @GuardedBy("mLock")
     private ArrayList<MediaItem2> mPlaylist = new ArrayList<>();
+    // Indices of the items of mPlaylist in the order they're played when shuffled, or null when
+    // the order isn't shuffled. The first mPlaylist.size() entries are used.
     @GuardedBy("mLock")
-    private ArrayList<MediaItem2> mShuffledList = new ArrayList<>();
+    private int[] mShuffledIndices;
     @GuardedBy("mLock")
     private Map<MediaItem2, DataSourceDesc> mItemDsdMap = new ArrayMap<>();
     @GuardedBy("mLock")
@@ -94,7 +98,7 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
         PlayItem(int shuffledIdx, DataSourceDesc dsd) {
             this.shuffledIdx = shuffledIdx;
             if (shuffledIdx >= 0) {
-                this.mediaItem = mShuffledList.get(shuffledIdx);
+                this.mediaItem = getShuffledItemLocked(shuffledIdx);
                 if (dsd == null) {
                     synchronized (mLock) {
                         this.dsd = retrieveDataSourceDescLocked(this.mediaItem);
@@ -121,10 +125,10 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
                 return false;
             }
             synchronized (mLock) {
-                if (shuffledIdx >= mShuffledList.size()) {
+                if (shuffledIdx >= mPlaylist.size()) {
                     return false;
                 }
-                if (mediaItem != mShuffledList.get(shuffledIdx)) {
+                if (mediaItem != getShuffledItemLocked(shuffledIdx)) {
                     return false;
                 }
             }
@@ -233,14 +237,10 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
         }
         synchronized (mLock) {
             index = clamp(index, mPlaylist.size());
-            int shuffledIdx = index;
             mPlaylist.add(index, item);
-            if (mShuffleMode == MediaPlaylistAgent.SHUFFLE_MODE_NONE) {
-                mShuffledList.add(index, item);
-            } else {
-                // Add the item in random position of mShuffledList.
-                shuffledIdx = (int) (Math.random() * (mShuffledList.size() + 1));
-                mShuffledList.add(shuffledIdx, item);
+            if (mShuffledIndices != null) {
+                // Add the item in random position of the shuffled order.
+                insertShuffledIndexLocked(mRandom.nextInt(mPlaylist.size()), index);
             }
             if (!hasValidItem()) {
                 mCurrent = getNextValidPlayItemLocked(END_OF_PLAYLIST, 1);
@@ -258,10 +258,14 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
             throw new IllegalArgumentException("item shouldn't be null");
         }
         synchronized (mLock) {
-            if (!mPlaylist.remove(item)) {
+            int index = mPlaylist.indexOf(item);
+            if (index < 0) {
                 return;
             }
-            mShuffledList.remove(item);
+            mPlaylist.remove(index);
+            if (mShuffledIndices != null) {
+                removeShuffledIndexLocked(index);
+            }
             mItemDsdMap.remove(item);
             updateCurrentIfNeededLocked();
         }
@@ -278,10 +282,8 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
                 return;
             }
             index = clamp(index, mPlaylist.size() - 1);
-            int shuffledIdx = mShuffledList.indexOf(mPlaylist.get(index));
-            mItemDsdMap.remove(mShuffledList.get(shuffledIdx));
-            mShuffledList.set(shuffledIdx, item);
-            mPlaylist.set(index, item);
+            // The replaced item keeps its position in the shuffled order.
+            mItemDsdMap.remove(mPlaylist.set(index, item));
             if (!hasValidItem()) {
                 mCurrent = getNextValidPlayItemLocked(END_OF_PLAYLIST, 1);
                 updatePlayerDataSourceLocked();
@@ -301,7 +303,7 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
             if (!hasValidItem() || item.equals(mCurrent.mediaItem)) {
                 return;
             }
-            int shuffledIdx = mShuffledList.indexOf(item);
+            int shuffledIdx = shuffledIndexOfLocked(item);
             if (shuffledIdx < 0) {
                 return;
             }
@@ -459,7 +461,8 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
                     curShuffledIdx = curShuffledIdx < 0 ? mPlaylist.size() - 1 : 0;
                 }
             }
-            DataSourceDesc dsd = retrieveDataSourceDescLocked(mShuffledList.get(curShuffledIdx));
+            DataSourceDesc dsd = retrieveDataSourceDescLocked(
+                    getShuffledItemLocked(curShuffledIdx));
             if (dsd != null) {
                 return new PlayItem(curShuffledIdx, dsd);
             }
@@ -472,17 +475,17 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
         if (!hasValidItem() || mCurrent.isValid()) {
             return;
         }
-        int shuffledIdx = mShuffledList.indexOf(mCurrent.mediaItem);
+        int shuffledIdx = shuffledIndexOfLocked(mCurrent.mediaItem);
         if (shuffledIdx >= 0) {
             // Added an item.
             mCurrent.shuffledIdx = shuffledIdx;
             return;
         }
 
-        if (mCurrent.shuffledIdx >= mShuffledList.size()) {
-            mCurrent = getNextValidPlayItemLocked(mShuffledList.size() - 1, 1);
+        if (mCurrent.shuffledIdx >= mPlaylist.size()) {
+            mCurrent = getNextValidPlayItemLocked(mPlaylist.size() - 1, 1);
         } else {
-            mCurrent.mediaItem = mShuffledList.get(mCurrent.shuffledIdx);
+            mCurrent.mediaItem = getShuffledItemLocked(mCurrent.shuffledIdx);
             if (retrieveDataSourceDescLocked(mCurrent.mediaItem) == null) {
                 mCurrent = getNextValidPlayItemLocked(mCurrent.shuffledIdx, 1);
             }
@@ -505,11 +508,74 @@ class SessionPlaylistAgentImplBase extends MediaPlaylistAgent {
 
     @SuppressWarnings("GuardedBy")
     private void applyShuffleModeLocked() {
-        mShuffledList.clear();
-        mShuffledList.addAll(mPlaylist);
-        if (mShuffleMode == MediaPlaylistAgent.SHUFFLE_MODE_ALL
-                || mShuffleMode == MediaPlaylistAgent.SHUFFLE_MODE_GROUP) {
-            Collections.shuffle(mShuffledList);
+        if (mShuffleMode != MediaPlaylistAgent.SHUFFLE_MODE_ALL
+                && mShuffleMode != MediaPlaylistAgent.SHUFFLE_MODE_GROUP) {
+            mShuffledIndices = null;
+            return;
+        }
+        // Shuffle a permutation of the indices rather than a copy of the playlist.
+        final int size = mPlaylist.size();
+        mShuffledIndices = new int[size];
+        for (int i = 0; i < size; i++) {
+            final int j = mRandom.nextInt(i + 1);
+            mShuffledIndices[i] = mShuffledIndices[j];
+            mShuffledIndices[j] = i;
+        }
+    }
+
+    @SuppressWarnings("GuardedBy")
+    private MediaItem2 getShuffledItemLocked(int shuffledIdx) {
+        return mPlaylist.get(mShuffledIndices == null ? shuffledIdx
+                : mShuffledIndices[shuffledIdx]);
+    }
+
+    @SuppressWarnings("GuardedBy")
+    private int shuffledIndexOfLocked(MediaItem2 item) {
+        final int index = mPlaylist.indexOf(item);
+        if (index < 0 || mShuffledIndices == null) {
+            return index;
+        }
+        for (int i = 0; i < mPlaylist.size(); i++) {
+            if (mShuffledIndices[i] == index) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Inserts the index of an item added to mPlaylist at the given position of the shuffled order.
+    @SuppressWarnings("GuardedBy")
+    private void insertShuffledIndexLocked(int shuffledIdx, int index) {
+        final int size = mPlaylist.size();
+        if (mShuffledIndices.length < size) {
+            final int[] indices = new int[Math.max(size, mShuffledIndices.length * 2)];
+            System.arraycopy(mShuffledIndices, 0, indices, 0, size - 1);
+            mShuffledIndices = indices;
+        }
+        for (int i = 0; i < size - 1; i++) {
+            if (mShuffledIndices[i] >= index) {
+                mShuffledIndices[i]++;
+            }
+        }
+        System.arraycopy(mShuffledIndices, shuffledIdx, mShuffledIndices, shuffledIdx + 1,
+                size - 1 - shuffledIdx);
+        mShuffledIndices[shuffledIdx] = index;
+    }
+
+    // Removes the index of an item removed from mPlaylist from the shuffled order.
+    @SuppressWarnings("GuardedBy")
+    private void removeShuffledIndexLocked(int index) {
+        final int size = mPlaylist.size();
+        int shuffledIdx = 0;
+        while (mShuffledIndices[shuffledIdx] != index) {
+            shuffledIdx++;
+        }
+        System.arraycopy(mShuffledIndices, shuffledIdx + 1, mShuffledIndices, shuffledIdx,
+                size - shuffledIdx);
+        for (int i = 0; i < size; i++) {
+            if (mShuffledIndices[i] > index) {
+                mShuffledIndices[i]--;
+            }
         }
     }
 
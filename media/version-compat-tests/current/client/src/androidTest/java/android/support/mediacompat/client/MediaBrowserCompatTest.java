@@ -16,6 +16,7 @@
 
 package android.support.mediacompat.client;
 
+import static android.support.mediacompat.testlib.MediaBrowserConstants.CACHED_CHILDREN_COUNT;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.CUSTOM_ACTION;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.CUSTOM_ACTION_FOR_ERROR;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.CUSTOM_ACTION_SEND_ERROR;
@@ -24,6 +25,9 @@ import static android.support.mediacompat.testlib.MediaBrowserConstants
 import static android.support.mediacompat.testlib.MediaBrowserConstants.CUSTOM_ACTION_SEND_RESULT;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.EXTRAS_KEY;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.EXTRAS_VALUE;
+import static android.support.mediacompat.testlib.MediaBrowserConstants.MEDIA_ID_CACHED_CHILDREN;
+import static android.support.mediacompat.testlib.MediaBrowserConstants
+        .MEDIA_ID_CACHED_CHILDREN_DELAYED;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.MEDIA_ID_CHILDREN;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.MEDIA_ID_CHILDREN_DELAYED;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.MEDIA_ID_INCLUDE_METADATA;
@@ -36,6 +40,8 @@ import static android.support.mediacompat.testlib.MediaBrowserConstants.NOTIFY_C
 import static android.support.mediacompat.testlib.MediaBrowserConstants.SEARCH_QUERY;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.SEARCH_QUERY_FOR_ERROR;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.SEARCH_QUERY_FOR_NO_RESULT;
+import static android.support.mediacompat.testlib.MediaBrowserConstants
+        .SEND_DELAYED_CACHED_CHILDREN;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.SEND_DELAYED_ITEM_LOADED;
 import static android.support.mediacompat.testlib.MediaBrowserConstants
         .SEND_DELAYED_NOTIFY_CHILDREN_CHANGED;
@@ -58,6 +64,7 @@ import static android.support.test.InstrumentationRegistry.getInstrumentation;
 
 import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNotEquals;
 import static org.junit.Assert.assertNotNull;
 import static org.junit.Assert.assertNull;
 import static org.junit.Assert.assertSame;
@@ -593,6 +600,111 @@ public class MediaBrowserCompatTest {
         }
     }
 
+    @Test
+    @MediumTest
+    public void testSubscribeWithOptionsServedFromCache() throws Exception {
+        if (!VERSION_TOT.equals(mServiceVersion)) {
+            // Children are only cached by the current version of the service.
+            return;
+        }
+        connectMediaBrowserService();
+
+        int load = subscribePage(MEDIA_ID_CACHED_CHILDREN, 0);
+        // Later pages are taken from the children kept by the first load.
+        for (int page = 1; page < CACHED_CHILDREN_COUNT / 2; page++) {
+            assertEquals(load, subscribePage(MEDIA_ID_CACHED_CHILDREN, page));
+        }
+    }
+
+    @Test
+    @MediumTest
+    public void testNotifyChildrenChangedDropsCachedChildren() throws Exception {
+        if (!VERSION_TOT.equals(mServiceVersion)) {
+            return;
+        }
+        connectMediaBrowserService();
+        int load = subscribePage(MEDIA_ID_CACHED_CHILDREN, 0);
+
+        mSubscriptionCallback.reset(1);
+        callMediaBrowserServiceMethod(
+                NOTIFY_CHILDREN_CHANGED, MEDIA_ID_CACHED_CHILDREN, getContext());
+        assertTrue(mSubscriptionCallback.await(TIME_OUT_MS));
+        int reload = getLoad(mSubscriptionCallback.mLastChildMediaItems.get(0));
+        assertNotEquals(load, reload);
+
+        // Later pages are taken from the reloaded children.
+        assertEquals(reload, subscribePage(MEDIA_ID_CACHED_CHILDREN, 1));
+    }
+
+    @Test
+    @MediumTest
+    public void testUnsubscribeDropsCachedChildren() throws Exception {
+        if (!VERSION_TOT.equals(mServiceVersion)) {
+            return;
+        }
+        connectMediaBrowserService();
+        int load = subscribePage(MEDIA_ID_CACHED_CHILDREN, 0);
+
+        mMediaBrowser.unsubscribe(MEDIA_ID_CACHED_CHILDREN);
+        assertNotEquals(load, subscribePage(MEDIA_ID_CACHED_CHILDREN, 1));
+    }
+
+    @Test
+    @MediumTest
+    public void testDisconnectDropsCachedChildren() throws Exception {
+        if (!VERSION_TOT.equals(mServiceVersion)) {
+            return;
+        }
+        connectMediaBrowserService();
+        int load = subscribePage(MEDIA_ID_CACHED_CHILDREN, 0);
+
+        mMediaBrowser.disconnect();
+        // Use a new browser, which doesn't subscribe again when it connects.
+        getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mMediaBrowser = new MediaBrowserCompat(getInstrumentation().getTargetContext(),
+                        TEST_BROWSER_SERVICE, mConnectionCallback, mRootHints);
+            }
+        });
+        connectMediaBrowserService();
+        assertNotEquals(load, subscribePage(MEDIA_ID_CACHED_CHILDREN, 1));
+    }
+
+    @Test
+    @MediumTest
+    public void testChildrenLoadedBeforeInvalidationAreNotCached() throws Exception {
+        if (!VERSION_TOT.equals(mServiceVersion)) {
+            return;
+        }
+        connectMediaBrowserService();
+        Bundle options = new Bundle();
+        options.putInt(MediaBrowserCompat.EXTRA_PAGE, 0);
+        options.putInt(MediaBrowserCompat.EXTRA_PAGE_SIZE, 2);
+
+        // The first load is held by the service.
+        mSubscriptionCallback.reset(1);
+        mMediaBrowser.subscribe(MEDIA_ID_CACHED_CHILDREN_DELAYED, options, mSubscriptionCallback);
+        assertFalse(mSubscriptionCallback.await(WAIT_TIME_FOR_NO_RESPONSE_MS));
+
+        // Invalidating reloads the children while the first load is pending.
+        callMediaBrowserServiceMethod(
+                NOTIFY_CHILDREN_CHANGED, MEDIA_ID_CACHED_CHILDREN_DELAYED, getContext());
+        assertTrue(mSubscriptionCallback.await(TIME_OUT_MS));
+        int reload = getLoad(mSubscriptionCallback.mLastChildMediaItems.get(0));
+
+        // The first load completes after the invalidation.
+        mSubscriptionCallback.reset(1);
+        callMediaBrowserServiceMethod(
+                SEND_DELAYED_CACHED_CHILDREN, MEDIA_ID_CACHED_CHILDREN_DELAYED, getContext());
+        assertTrue(mSubscriptionCallback.await(TIME_OUT_MS));
+        int staleLoad = getLoad(mSubscriptionCallback.mLastChildMediaItems.get(0));
+        assertNotEquals(reload, staleLoad);
+
+        // Only the children loaded after the invalidation were kept.
+        assertEquals(reload, subscribePage(MEDIA_ID_CACHED_CHILDREN_DELAYED, 1));
+    }
+
     @Test
     @SmallTest
     public void testGetItem() throws Exception {
@@ -860,6 +972,37 @@ public class MediaBrowserCompatTest {
         }
     }
 
+    /**
+     * Subscribes to a page of two children of the given parent, and checks that the right
+     * children were sent.
+     *
+     * @return the number of the load that created the children.
+     */
+    private int subscribePage(String parentId, int page) {
+        Bundle options = new Bundle();
+        options.putInt(MediaBrowserCompat.EXTRA_PAGE, page);
+        options.putInt(MediaBrowserCompat.EXTRA_PAGE_SIZE, 2);
+        mSubscriptionCallback.reset(1);
+        mMediaBrowser.subscribe(parentId, options, mSubscriptionCallback);
+        assertTrue(mSubscriptionCallback.await(TIME_OUT_MS));
+        assertEquals(parentId, mSubscriptionCallback.mLastParentId);
+
+        List<MediaItem> children = mSubscriptionCallback.mLastChildMediaItems;
+        assertEquals(2, children.size());
+        int load = getLoad(children.get(0));
+        for (int i = 0; i < children.size(); i++) {
+            String[] id = children.get(i).getMediaId().split("/");
+            assertEquals(parentId, id[0]);
+            assertEquals(load, Integer.parseInt(id[1]));
+            assertEquals(page * 2 + i, Integer.parseInt(id[2]));
+        }
+        return load;
+    }
+
+    private static int getLoad(MediaItem cachedChild) {
+        return Integer.parseInt(cachedChild.getMediaId().split("/")[1]);
+    }
+
     private void assertRatingEquals(RatingCompat expected, RatingCompat observed) {
         if (expected == null || observed == null) {
             assertSame(expected, observed);
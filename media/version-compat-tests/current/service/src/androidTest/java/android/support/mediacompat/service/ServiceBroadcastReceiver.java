@@ -22,6 +22,8 @@ import static android.support.mediacompat.testlib.MediaBrowserConstants
         .CUSTOM_ACTION_SEND_PROGRESS_UPDATE;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.CUSTOM_ACTION_SEND_RESULT;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.NOTIFY_CHILDREN_CHANGED;
+import static android.support.mediacompat.testlib.MediaBrowserConstants
+        .SEND_DELAYED_CACHED_CHILDREN;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.SEND_DELAYED_ITEM_LOADED;
 import static android.support.mediacompat.testlib.MediaBrowserConstants
         .SEND_DELAYED_NOTIFY_CHILDREN_CHANGED;
@@ -92,6 +94,9 @@ public class ServiceBroadcastReceiver extends BroadcastReceiver {
                 case CUSTOM_ACTION_SEND_RESULT:
                     service.mCustomActionResult.sendResult(extras.getBundle(KEY_ARGUMENT));
                     break;
+                case SEND_DELAYED_CACHED_CHILDREN:
+                    service.sendDelayedCachedChildren();
+                    break;
                 case SET_SESSION_TOKEN:
                     StubMediaBrowserServiceCompatWithDelayedMediaSession.sInstance
                             .callSetSessionToken();
@@ -16,10 +16,14 @@
 
 package android.support.mediacompat.service;
 
+import static android.support.mediacompat.testlib.MediaBrowserConstants.CACHED_CHILDREN_COUNT;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.CUSTOM_ACTION;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.CUSTOM_ACTION_FOR_ERROR;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.EXTRAS_KEY;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.EXTRAS_VALUE;
+import static android.support.mediacompat.testlib.MediaBrowserConstants.MEDIA_ID_CACHED_CHILDREN;
+import static android.support.mediacompat.testlib.MediaBrowserConstants
+        .MEDIA_ID_CACHED_CHILDREN_DELAYED;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.MEDIA_ID_CHILDREN;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.MEDIA_ID_CHILDREN_DELAYED;
 import static android.support.mediacompat.testlib.MediaBrowserConstants.MEDIA_ID_INCLUDE_METADATA;
@@ -57,6 +61,11 @@ public class StubMediaBrowserServiceCompat extends MediaBrowserServiceCompat {
     private Result<List<MediaItem>> mPendingLoadChildrenResult;
     private Result<MediaItem> mPendingLoadItemResult;
     private Bundle mPendingRootHints;
+    // Number of times children of MEDIA_ID_CACHED_CHILDREN(_DELAYED) were loaded. Kept across
+    // service instances, so that a browser reconnecting to a new instance sees new loads.
+    private static int sCachedChildrenLoadCount;
+    private Result<List<MediaItem>> mPendingCachedChildrenResult;
+    private int mPendingCachedChildrenLoad;
 
     public Bundle mCustomActionExtras;
     public Result<Bundle> mCustomActionResult;
@@ -67,6 +76,7 @@ public class StubMediaBrowserServiceCompat extends MediaBrowserServiceCompat {
         sInstance = this;
         sSession = new MediaSessionCompat(this, "StubMediaBrowserServiceCompat");
         setSessionToken(sSession.getSessionToken());
+        setChildrenCacheEnabled(true);
     }
 
     @Override
@@ -99,6 +109,19 @@ public class StubMediaBrowserServiceCompat extends MediaBrowserServiceCompat {
             result.detach();
         } else if (MEDIA_ID_INVALID.equals(parentId)) {
             result.sendResult(null);
+        } else if (MEDIA_ID_CACHED_CHILDREN.equals(parentId)) {
+            result.sendResult(createCachedChildren(parentId, ++sCachedChildrenLoadCount));
+        } else if (MEDIA_ID_CACHED_CHILDREN_DELAYED.equals(parentId)) {
+            // Only the first load is delayed, so that the children can be reloaded while it
+            // is pending.
+            int load = ++sCachedChildrenLoadCount;
+            if (mPendingCachedChildrenResult == null) {
+                mPendingCachedChildrenResult = result;
+                mPendingCachedChildrenLoad = load;
+                result.detach();
+            } else {
+                result.sendResult(createCachedChildren(parentId, load));
+            }
         }
     }
 
@@ -191,6 +214,22 @@ public class StubMediaBrowserServiceCompat extends MediaBrowserServiceCompat {
         }
     }
 
+    public void sendDelayedCachedChildren() {
+        if (mPendingCachedChildrenResult != null) {
+            mPendingCachedChildrenResult.sendResult(createCachedChildren(
+                    MEDIA_ID_CACHED_CHILDREN_DELAYED, mPendingCachedChildrenLoad));
+            mPendingCachedChildrenResult = null;
+        }
+    }
+
+    private List<MediaItem> createCachedChildren(String parentId, int load) {
+        List<MediaItem> mediaItems = new ArrayList<>();
+        for (int i = 0; i < CACHED_CHILDREN_COUNT; i++) {
+            mediaItems.add(createMediaItem(parentId + "/" + load + "/" + i));
+        }
+        return mediaItems;
+    }
+
     private MediaItem createMediaItem(String id) {
         return new MediaItem(new MediaDescriptionCompat.Builder().setMediaId(id).build(),
                 MediaItem.FLAG_BROWSABLE);
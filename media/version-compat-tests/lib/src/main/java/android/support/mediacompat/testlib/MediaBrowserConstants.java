@@ -29,6 +29,7 @@ public class MediaBrowserConstants {
     public static final int CUSTOM_ACTION_SEND_ERROR = 5;
     public static final int CUSTOM_ACTION_SEND_RESULT = 6;
     public static final int SET_SESSION_TOKEN = 7;
+    public static final int SEND_DELAYED_CACHED_CHILDREN = 8;
 
     public static final String MEDIA_ID_ROOT = "test_media_id_root";
     public static final String MEDIA_ID_INVALID = "test_media_id_invalid";
@@ -36,6 +37,13 @@ public class MediaBrowserConstants {
     public static final String MEDIA_ID_ON_LOAD_ITEM_NOT_IMPLEMENTED =
             "test_media_id_on_load_item_not_implemented";
     public static final String MEDIA_ID_INCLUDE_METADATA = "test_media_id_include_metadata";
+    public static final String MEDIA_ID_CACHED_CHILDREN = "test_media_id_cached_children";
+    public static final String MEDIA_ID_CACHED_CHILDREN_DELAYED =
+            "test_media_id_cached_children_delayed";
+
+    // Number of children of MEDIA_ID_CACHED_CHILDREN. Their ids are
+    // "<parent id>/<number of the load that created them>/<index>".
+    public static final int CACHED_CHILDREN_COUNT = 6;
 
     public static final String EXTRAS_KEY = "test_extras_key";
     public static final String EXTRAS_VALUE = "test_extras_value";
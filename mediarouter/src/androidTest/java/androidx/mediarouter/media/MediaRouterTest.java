@@ -19,9 +19,11 @@ package androidx.mediarouter.media;
 import static android.support.test.InstrumentationRegistry.getContext;
 import static android.support.test.InstrumentationRegistry.getInstrumentation;
 
+import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertTrue;
 
 import android.content.Context;
+import android.os.SystemClock;
 import android.support.test.filters.SmallTest;
 import android.support.test.runner.AndroidJUnit4;
 import android.support.v4.media.session.MediaSessionCompat;
@@ -33,6 +35,13 @@ import org.junit.Before;
 import org.junit.Test;
 import org.junit.runner.RunWith;
 
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+
 /**
  * Test {@link MediaRouter}.
  */
@@ -95,6 +104,174 @@ public class MediaRouterTest {
        }
    }
 
+   /**
+    * This test checks whether repeated changes of a route are notified once, and whether changes
+    * aren't notified after the route is removed.
+    */
+   @Test
+   @SmallTest
+   public void testRouteChangesAreCoalesced() throws Exception {
+       final MediaRouteProvider provider = new MediaRouteProvider(mContext) {};
+       final RouteCallback callback = new RouteCallback(provider);
+       getInstrumentation().runOnMainSync(new Runnable() {
+           @Override
+           public void run() {
+               mRouter.addProvider(provider);
+               mRouter.addCallback(MediaRouteSelector.EMPTY, callback,
+                       MediaRouter.CALLBACK_FLAG_UNFILTERED_EVENTS);
+               MediaRouter.sGlobal.updateProviderDescriptor(provider, createDescriptor("name"));
+               for (int i = 0; i < 10; i++) {
+                   MediaRouter.sGlobal.updateProviderDescriptor(provider,
+                           createDescriptor("name" + i));
+               }
+           }
+       });
+       try {
+           assertTrue(callback.mChangedLatch.await(TIME_OUT_MS, TimeUnit.MILLISECONDS));
+           // Wait for changes that would be notified separately.
+           SystemClock.sleep(100);
+           assertEquals(1, callback.mChangedCount.get());
+           assertEquals("name9", callback.mRoute.getName());
+
+           getInstrumentation().runOnMainSync(new Runnable() {
+               @Override
+               public void run() {
+                   MediaRouter.sGlobal.updateProviderDescriptor(provider,
+                           createDescriptor("removed"));
+                   MediaRouter.sGlobal.updateProviderDescriptor(provider,
+                           new MediaRouteProviderDescriptor.Builder().build());
+               }
+           });
+           assertTrue(callback.mRemovedLatch.await(TIME_OUT_MS, TimeUnit.MILLISECONDS));
+           SystemClock.sleep(100);
+           assertEquals(1, callback.mChangedCount.get());
+       } finally {
+           getInstrumentation().runOnMainSync(new Runnable() {
+               @Override
+               public void run() {
+                   mRouter.removeCallback(callback);
+                   mRouter.removeProvider(provider);
+               }
+           });
+       }
+   }
+
+   /**
+    * This test checks whether coalesced changes are notified in the order of the events.
+    */
+   @Test
+   @SmallTest
+   public void testRouteChangesKeepCallbackOrder() throws Exception {
+       final MediaRouteProvider provider = new MediaRouteProvider(mContext) {};
+       final OrderCallback callback = new OrderCallback(provider);
+       getInstrumentation().runOnMainSync(new Runnable() {
+           @Override
+           public void run() {
+               mRouter.addProvider(provider);
+               mRouter.addCallback(MediaRouteSelector.EMPTY, callback,
+                       MediaRouter.CALLBACK_FLAG_UNFILTERED_EVENTS);
+               MediaRouter.sGlobal.updateProviderDescriptor(provider, createDescriptor("name"));
+               MediaRouter.sGlobal.updateProviderDescriptor(provider,
+                       createDescriptor("name1"));
+               MediaRouter.sGlobal.updateProviderDescriptor(provider,
+                       new MediaRouteProviderDescriptor.Builder()
+                               .addRoute(new MediaRouteDescriptor.Builder("route", "name1")
+                                       .build())
+                               .addRoute(new MediaRouteDescriptor.Builder("route2", "name2")
+                                       .build())
+                               .build());
+           }
+       });
+       try {
+           assertTrue(callback.mAddedLatch.await(TIME_OUT_MS, TimeUnit.MILLISECONDS));
+           // Wait for the last provider change.
+           SystemClock.sleep(100);
+           getInstrumentation().runOnMainSync(new Runnable() {
+               @Override
+               public void run() {
+                   assertEquals(Arrays.asList("added route", "provider changed",
+                           "changed route", "added route2", "provider changed"),
+                           callback.mEvents);
+               }
+           });
+       } finally {
+           getInstrumentation().runOnMainSync(new Runnable() {
+               @Override
+               public void run() {
+                   mRouter.removeCallback(callback);
+                   mRouter.removeProvider(provider);
+               }
+           });
+       }
+   }
+
+   private static MediaRouteProviderDescriptor createDescriptor(String routeName) {
+       return new MediaRouteProviderDescriptor.Builder()
+               .addRoute(new MediaRouteDescriptor.Builder("route", routeName).build())
+               .build();
+   }
+
+   private static class RouteCallback extends MediaRouter.Callback {
+       final MediaRouteProvider mProvider;
+       final AtomicInteger mChangedCount = new AtomicInteger();
+       final CountDownLatch mChangedLatch = new CountDownLatch(1);
+       final CountDownLatch mRemovedLatch = new CountDownLatch(1);
+       volatile MediaRouter.RouteInfo mRoute;
+
+       RouteCallback(MediaRouteProvider provider) {
+           mProvider = provider;
+       }
+
+       @Override
+       public void onRouteChanged(MediaRouter router, MediaRouter.RouteInfo route) {
+           if (route.getProviderInstance() == mProvider) {
+               mRoute = route;
+               mChangedCount.incrementAndGet();
+               mChangedLatch.countDown();
+           }
+       }
+
+       @Override
+       public void onRouteRemoved(MediaRouter router, MediaRouter.RouteInfo route) {
+           if (route.getProviderInstance() == mProvider) {
+               mRemovedLatch.countDown();
+           }
+       }
+   }
+
+   private static class OrderCallback extends MediaRouter.Callback {
+       final MediaRouteProvider mProvider;
+       final CountDownLatch mAddedLatch = new CountDownLatch(2);
+       // Accessed on the main thread.
+       final List<String> mEvents = new ArrayList<>();
+
+       OrderCallback(MediaRouteProvider provider) {
+           mProvider = provider;
+       }
+
+       @Override
+       public void onRouteAdded(MediaRouter router, MediaRouter.RouteInfo route) {
+           if (route.getProviderInstance() == mProvider) {
+               mEvents.add("added " + route.getDescriptorId());
+               mAddedLatch.countDown();
+           }
+       }
+
+       @Override
+       public void onRouteChanged(MediaRouter router, MediaRouter.RouteInfo route) {
+           if (route.getProviderInstance() == mProvider) {
+               mEvents.add("changed " + route.getDescriptorId());
+           }
+       }
+
+       @Override
+       public void onProviderChanged(MediaRouter router, MediaRouter.ProviderInfo provider) {
+           if (provider.getProviderInstance() == mProvider) {
+               mEvents.add("provider changed");
+           }
+       }
+   }
+
    private class MediaSessionCallback extends MediaSessionCompat.Callback {
        private boolean mOnPlayCalled;
        private boolean mOnPauseCalled;
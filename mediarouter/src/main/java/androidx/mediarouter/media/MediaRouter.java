@@ -2279,6 +2279,9 @@ public final class MediaRouter {
                 // the order of their descriptors.
                 int targetIndex = 0;
                 boolean selectedRouteDescriptorChanged = false;
+                // Counts of route changes, which are logged to follow the route churn.
+                int addedCount = 0;
+                int changedCount = 0;
                 if (providerDescriptor != null) {
                     if (providerDescriptor.isValid()) {
                         final List<MediaRouteDescriptor> routeDescriptors =
@@ -2311,6 +2314,7 @@ public final class MediaRouter {
                                         Log.d(TAG, "Route added: " + route);
                                     }
                                     mCallbackHandler.post(CallbackHandler.MSG_ROUTE_ADDED, route);
+                                    addedCount++;
                                 }
 
                             } else if (sourceIndex < targetIndex) {
@@ -2321,6 +2325,7 @@ public final class MediaRouter {
                                 // 1. Replace route if a group route becomes a normal route
                                 // or vice versa.
                                 if ((route instanceof RouteGroup) != isGroup) {
+                                    mCallbackHandler.removeRouteChanges(route);
                                     route = isGroup ? new RouteGroup(provider, id, route.getId()) :
                                             new RouteInfo(provider, id, route.getId());
                                     provider.mRoutes.set(sourceIndex, route);
@@ -2338,6 +2343,7 @@ public final class MediaRouter {
                                         if (route == mSelectedRoute) {
                                             selectedRouteDescriptorChanged = true;
                                         }
+                                        changedCount++;
                                     }
                                 }
                             }
@@ -2350,6 +2356,7 @@ public final class MediaRouter {
                                 Log.d(TAG, "Route added: " + route);
                             }
                             mCallbackHandler.post(CallbackHandler.MSG_ROUTE_ADDED, route);
+                            addedCount++;
                         }
                         for (Pair<RouteInfo, MediaRouteDescriptor> pair : updatedGroups) {
                             RouteInfo route = pair.first;
@@ -2357,6 +2364,7 @@ public final class MediaRouter {
                                 if (route == mSelectedRoute) {
                                     selectedRouteDescriptorChanged = true;
                                 }
+                                changedCount++;
                             }
                         }
                     } else {
@@ -2381,19 +2389,22 @@ public final class MediaRouter {
                 // that the framework media router observes the new route
                 // selection before the removal since removing the currently
                 // selected route may have side-effects.
+                final int removedCount = provider.mRoutes.size() - targetIndex;
                 for (int i = provider.mRoutes.size() - 1; i >= targetIndex; i--) {
                     RouteInfo route = provider.mRoutes.remove(i);
                     if (DEBUG) {
                         Log.d(TAG, "Route removed: " + route);
                     }
+                    mCallbackHandler.removeRouteChanges(route);
                     mCallbackHandler.post(CallbackHandler.MSG_ROUTE_REMOVED, route);
                 }
 
                 // Notify provider changed.
                 if (DEBUG) {
-                    Log.d(TAG, "Provider changed: " + provider);
+                    Log.d(TAG, "Provider changed: " + provider + ", routes added: " + addedCount
+                            + ", changed: " + changedCount + ", removed: " + removedCount);
                 }
-                mCallbackHandler.post(CallbackHandler.MSG_PROVIDER_CHANGED, provider);
+                mCallbackHandler.postChange(CallbackHandler.MSG_PROVIDER_CHANGED, provider);
             }
         }
 
@@ -2405,14 +2416,13 @@ public final class MediaRouter {
                     if (DEBUG) {
                         Log.d(TAG, "Route changed: " + route);
                     }
-                    mCallbackHandler.post(
-                            CallbackHandler.MSG_ROUTE_CHANGED, route);
+                    mCallbackHandler.postChange(CallbackHandler.MSG_ROUTE_CHANGED, route);
                 }
                 if ((changes & RouteInfo.CHANGE_VOLUME) != 0) {
                     if (DEBUG) {
                         Log.d(TAG, "Route volume changed: " + route);
                     }
-                    mCallbackHandler.post(
+                    mCallbackHandler.postChange(
                             CallbackHandler.MSG_ROUTE_VOLUME_CHANGED, route);
                 }
                 if ((changes & RouteInfo.CHANGE_PRESENTATION_DISPLAY) != 0) {
@@ -2420,7 +2430,7 @@ public final class MediaRouter {
                         Log.d(TAG, "Route presentation display changed: "
                                 + route);
                     }
-                    mCallbackHandler.post(CallbackHandler.
+                    mCallbackHandler.postChange(CallbackHandler.
                             MSG_ROUTE_PRESENTATION_DISPLAY_CHANGED, route);
                 }
             }
@@ -2891,25 +2901,89 @@ public final class MediaRouter {
             public static final int MSG_PROVIDER_REMOVED = MSG_TYPE_PROVIDER | 2;
             public static final int MSG_PROVIDER_CHANGED = MSG_TYPE_PROVIDER | 3;
 
+            // Dispatches the pending changes.
+            private static final int MSG_FLUSH_CHANGES = 1;
+
+            // Time within which changes are coalesced, which is about a frame.
+            private static final long CHANGE_DELAY_MS = 16;
+
+            // Changes waiting to be dispatched, in the order they were posted.
+            private final ArrayList<Message> mPendingChanges = new ArrayList<>();
+
             CallbackHandler() {
             }
 
             public void post(int msg, Object obj) {
+                flushChanges();
                 obtainMessage(msg, obj).sendToTarget();
             }
 
             public void post(int msg, Object obj, int arg) {
+                flushChanges();
                 Message message = obtainMessage(msg, obj);
                 message.arg1 = arg;
                 message.sendToTarget();
             }
 
+            /**
+             * Posts a change of a route or provider after {@link #CHANGE_DELAY_MS}, unless the
+             * same change is already pending. Callbacks read the latest state of the route or
+             * provider, so routes that keep changing, such as flapping cast devices, are
+             * notified at most once per frame. Pending changes are dispatched before any other
+             * message is posted, so that callbacks are invoked in the order of the events.
+             */
+            public void postChange(int msg, Object obj) {
+                for (int i = 0; i < mPendingChanges.size(); i++) {
+                    final Message pending = mPendingChanges.get(i);
+                    if (pending.what == msg && pending.obj == obj) {
+                        if (DEBUG) {
+                            Log.d(TAG, "Change coalesced: " + obj);
+                        }
+                        return;
+                    }
+                }
+                mPendingChanges.add(obtainMessage(msg, obj));
+                if (!hasMessages(MSG_FLUSH_CHANGES)) {
+                    sendEmptyMessageDelayed(MSG_FLUSH_CHANGES, CHANGE_DELAY_MS);
+                }
+            }
+
+            /**
+             * Removes the pending changes of a route, which must not be notified after the
+             * route is removed.
+             */
+            public void removeRouteChanges(RouteInfo route) {
+                for (int i = mPendingChanges.size() - 1; i >= 0; i--) {
+                    final Message pending = mPendingChanges.get(i);
+                    if (pending.obj == route) {
+                        mPendingChanges.remove(i);
+                        pending.recycle();
+                    }
+                }
+                removeMessages(MSG_ROUTE_CHANGED, route);
+                removeMessages(MSG_ROUTE_VOLUME_CHANGED, route);
+                removeMessages(MSG_ROUTE_PRESENTATION_DISPLAY_CHANGED, route);
+            }
+
+            private void flushChanges() {
+                removeMessages(MSG_FLUSH_CHANGES);
+                for (int i = 0; i < mPendingChanges.size(); i++) {
+                    mPendingChanges.get(i).sendToTarget();
+                }
+                mPendingChanges.clear();
+            }
+
             @Override
             public void handleMessage(Message msg) {
                 final int what = msg.what;
                 final Object obj = msg.obj;
                 final int arg = msg.arg1;
 
+                if (what == MSG_FLUSH_CHANGES) {
+                    flushChanges();
+                    return;
+                }
+
                 if (what == MSG_ROUTE_CHANGED
                         && getSelectedRoute().getId().equals(((RouteInfo) obj).getId())) {
                     updateSelectedRouteIfNeeded(true);
@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.navigation;
+
+import static org.hamcrest.CoreMatchers.is;
+import static org.hamcrest.CoreMatchers.not;
+import static org.hamcrest.CoreMatchers.nullValue;
+import static org.hamcrest.MatcherAssert.assertThat;
+
+import android.net.Uri;
+import android.os.Bundle;
+import android.os.SystemClock;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.LargeTest;
+import android.support.test.filters.SmallTest;
+import android.support.v4.util.Pair;
+import android.util.Log;
+
+import org.junit.Before;
+import org.junit.Test;
+
+public class NavDeepLinkIndexTest {
+    private static final String TAG = "NavDeepLinkIndexTest";
+
+    private NavGraphNavigator mNavGraphNavigator;
+    private int mNextId = 1;
+
+    @Before
+    public void setup() {
+        mNavGraphNavigator = new NavGraphNavigator(InstrumentationRegistry.getTargetContext());
+    }
+
+    private NavDestination createDestination(String... deepLinks) {
+        NavDestination destination = new NavDestination(mNavGraphNavigator);
+        destination.setId(mNextId++);
+        for (String deepLink : deepLinks) {
+            destination.addDeepLink(deepLink);
+        }
+        return destination;
+    }
+
+    private NavGraph createGraph() {
+        NavGraph graph = mNavGraphNavigator.createDestination();
+        graph.setId(mNextId++);
+        return graph;
+    }
+
+    @SmallTest
+    @Test
+    public void matchNestedDestination() {
+        NavGraph root = createGraph();
+        NavGraph nested = createGraph();
+        NavDestination users = createDestination("www.example.com/users/{id}");
+        NavDestination posts = createDestination("https://www.example.com/posts/{postId}");
+        nested.addDestinations(users, posts);
+        root.addDestination(nested);
+
+        Pair<NavDestination, Bundle> result =
+                root.matchDeepLink(Uri.parse("http://www.example.com/users/42"));
+        assertThat(result, not(nullValue()));
+        assertThat(result.first, is(users));
+        assertThat(result.second.getString("id"), is("42"));
+
+        result = root.matchDeepLink(Uri.parse("https://www.example.com/posts/7"));
+        assertThat(result, not(nullValue()));
+        assertThat(result.first, is(posts));
+        assertThat(result.second.getString("postId"), is("7"));
+
+        assertThat(root.matchDeepLink(Uri.parse("http://www.example.com/posts/7")),
+                nullValue());
+    }
+
+    @SmallTest
+    @Test
+    public void matchPreservesDestinationOrder() {
+        NavGraph root = createGraph();
+        NavDestination specific = createDestination("https://www.example.com/users/.*");
+        NavDestination generic = createDestination("https://www.example.com/.*");
+        root.addDestinations(specific, generic);
+        root.addDeepLink("https://www.example.com/users/{id}");
+
+        Uri uri = Uri.parse("https://www.example.com/users/42");
+        assertThat(root.matchDeepLink(uri).first, is((NavDestination) root));
+        assertThat(root.matchDeepLinkWithoutIndex(uri).first, is((NavDestination) root));
+
+        uri = Uri.parse("https://www.example.com/settings");
+        assertThat(root.matchDeepLink(uri).first, is(generic));
+    }
+
+    @SmallTest
+    @Test
+    public void matchAfterGraphChanges() {
+        NavGraph root = createGraph();
+        NavGraph nested = createGraph();
+        root.addDestination(nested);
+        Uri uri = Uri.parse("android-app://androidx.navigation.test/detail");
+        assertThat(root.matchDeepLink(uri), nullValue());
+
+        NavDestination detail = createDestination();
+        nested.addDestination(detail);
+        detail.addDeepLink("android-app://androidx.navigation.test/detail");
+        assertThat(root.matchDeepLink(uri).first, is(detail));
+
+        nested.remove(detail);
+        assertThat(root.matchDeepLink(uri), nullValue());
+    }
+
+    @LargeTest
+    @Test
+    public void benchmarkIndexAgainstRecursiveScan() {
+        NavGraph root = createGraph();
+        for (int graphIndex = 0; graphIndex < 30; graphIndex++) {
+            NavGraph nested = createGraph();
+            for (int destIndex = 0; destIndex < 30; destIndex++) {
+                nested.addDestination(createDestination("https://www.example.com/section"
+                        + graphIndex + "/item" + destIndex + "/{id}"));
+            }
+            root.addDestination(nested);
+        }
+        Uri[] uris = new Uri[100];
+        for (int i = 0; i < uris.length; i++) {
+            uris[i] = Uri.parse("https://www.example.com/section" + (i % 30)
+                    + "/item" + ((i * 7) % 30) + "/" + i);
+        }
+
+        long buildStart = SystemClock.elapsedRealtimeNanos();
+        root.matchDeepLink(uris[0]);
+        long buildTime = SystemClock.elapsedRealtimeNanos() - buildStart;
+
+        long indexStart = SystemClock.elapsedRealtimeNanos();
+        for (Uri uri : uris) {
+            Pair<NavDestination, Bundle> result = root.matchDeepLink(uri);
+            assertThat(result, not(nullValue()));
+        }
+        long indexTime = SystemClock.elapsedRealtimeNanos() - indexStart;
+
+        long scanStart = SystemClock.elapsedRealtimeNanos();
+        for (Uri uri : uris) {
+            Pair<NavDestination, Bundle> result = root.matchDeepLinkWithoutIndex(uri);
+            assertThat(result, not(nullValue()));
+        }
+        long scanTime = SystemClock.elapsedRealtimeNanos() - scanStart;
+
+        for (Uri uri : uris) {
+            assertThat(root.matchDeepLink(uri).first,
+                    is(root.matchDeepLinkWithoutIndex(uri).first));
+        }
+        Log.i(TAG, "900 deep links, " + uris.length + " lookups: index build "
+                + buildTime / 1000 + "us, indexed " + indexTime / 1000 + "us, recursive scan "
+                + scanTime / 1000 + "us");
+    }
+}
@@ -32,15 +32,19 @@ class NavDeepLink {
     private static final Pattern SCHEME_PATTERN = Pattern.compile("^(\\w+-)*\\w+:");
 
     private final ArrayList<String> mArguments = new ArrayList<>();
+    private final String mUriPattern;
+    private final boolean mHasScheme;
     private final Pattern mPattern;
 
     /**
      * NavDestinations should be created via {@link Navigator#createDestination}.
      */
     NavDeepLink(@NonNull String uri) {
+        mUriPattern = uri;
+        mHasScheme = SCHEME_PATTERN.matcher(uri).find();
         StringBuffer uriRegex = new StringBuffer("^");
 
-        if (!SCHEME_PATTERN.matcher(uri).find()) {
+        if (!mHasScheme) {
             uriRegex.append("http[s]?://");
         }
         Pattern fillInPattern = Pattern.compile("\\{(.+?)\\}");
@@ -55,6 +59,22 @@ class NavDeepLink {
         mPattern = Pattern.compile(uriRegex.toString());
     }
 
+    /**
+     * Returns the uri pattern this deep link was created from.
+     */
+    @NonNull
+    String getUriPattern() {
+        return mUriPattern;
+    }
+
+    /**
+     * Returns whether the uri pattern declares its own scheme. Patterns without a scheme match
+     * both http and https Uris.
+     */
+    boolean hasScheme() {
+        return mHasScheme;
+    }
+
     boolean matches(@NonNull Uri deepLink) {
         return mPattern.matcher(deepLink.toString()).matches();
     }
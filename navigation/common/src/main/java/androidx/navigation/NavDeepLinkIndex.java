@@ -0,0 +1,262 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.navigation;
+
+import android.net.Uri;
+import android.os.Bundle;
+import android.support.annotation.NonNull;
+import android.support.annotation.Nullable;
+import android.support.v4.util.Pair;
+import android.support.v4.util.SparseArrayCompat;
+
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.Comparator;
+import java.util.List;
+
+/**
+ * NavDeepLinkIndex is a routing index over every {@link NavDeepLink} of a {@link NavGraph} and
+ * its nested graphs.
+ *
+ * <p>Deep links are stored in a character trie keyed by the literal prefix of their uri pattern
+ * (usually the scheme, host and leading path segments). Resolving a Uri walks the trie once,
+ * which narrows the deep links down to the few whose prefix matches, and only those run their
+ * regular expression. Candidates are tried in the same order as the recursive scan done by
+ * {@link NavGraph#matchDeepLink(Uri)} before indexing, so the first matching deep link still
+ * wins.</p>
+ */
+class NavDeepLinkIndex {
+    private static final int ANY_CHAR = -1;
+    private static final String[] IMPLICIT_SCHEMES = new String[] {"http://", "https://"};
+
+    private static final Comparator<Entry> ORDER_COMPARATOR = new Comparator<Entry>() {
+        @Override
+        public int compare(Entry lhs, Entry rhs) {
+            return lhs.mOrder - rhs.mOrder;
+        }
+    };
+
+    private final Node mRoot = new Node();
+    private int mSize;
+
+    /**
+     * Builds an index of the deep links of the given graph and, recursively, of all of its
+     * child destinations.
+     */
+    NavDeepLinkIndex(@NonNull NavGraph graph) {
+        addDestination(graph);
+    }
+
+    private void addDestination(@NonNull NavDestination destination) {
+        if (destination instanceof NavGraph) {
+            // Lazily inflated graphs only know their own deep links once inflated
+            ((NavGraph) destination).ensureChildrenInflated();
+        }
+        List<NavDeepLink> deepLinks = destination.getDeepLinks();
+        if (deepLinks != null) {
+            for (NavDeepLink deepLink : deepLinks) {
+                addDeepLink(new Entry(mSize++, destination, deepLink));
+            }
+        }
+        if (destination instanceof NavGraph) {
+            for (NavDestination child : (NavGraph) destination) {
+                addDestination(child);
+            }
+        }
+    }
+
+    private void addDeepLink(@NonNull Entry entry) {
+        int[] prefix = getLiteralPrefix(entry.mDeepLink.getUriPattern());
+        if (entry.mDeepLink.hasScheme()) {
+            insert(mRoot, prefix, entry);
+        } else {
+            for (String scheme : IMPLICIT_SCHEMES) {
+                Node node = mRoot;
+                for (int i = 0; i < scheme.length(); i++) {
+                    node = node.getOrCreateChild(scheme.charAt(i));
+                }
+                insert(node, prefix, entry);
+            }
+        }
+    }
+
+    private static void insert(@NonNull Node node, @NonNull int[] prefix, @NonNull Entry entry) {
+        for (int token : prefix) {
+            node = node.getOrCreateChild(token);
+        }
+        if (node.mEntries == null) {
+            node.mEntries = new ArrayList<>();
+        }
+        node.mEntries.add(entry);
+    }
+
+    /**
+     * Returns the number of deep links in this index.
+     */
+    int size() {
+        return mSize;
+    }
+
+    /**
+     * Finds the first deep link matching the given Uri.
+     *
+     * @return The matching {@link NavDestination} and the {@link Bundle} of arguments
+     * extracted from the Uri, or null if no match was found.
+     */
+    @Nullable
+    Pair<NavDestination, Bundle> matchDeepLink(@NonNull Uri uri) {
+        String uriString = uri.toString();
+        ArrayList<Entry> candidates = new ArrayList<>();
+        ArrayList<Node> active = new ArrayList<>();
+        ArrayList<Node> next = new ArrayList<>();
+        active.add(mRoot);
+        int length = uriString.length();
+        for (int i = 0; !active.isEmpty(); i++) {
+            for (int n = 0; n < active.size(); n++) {
+                Node node = active.get(n);
+                if (node.mEntries != null) {
+                    candidates.addAll(node.mEntries);
+                }
+            }
+            if (i == length) {
+                break;
+            }
+            char c = uriString.charAt(i);
+            for (int n = 0; n < active.size(); n++) {
+                Node node = active.get(n);
+                if (node.mChildren == null) {
+                    continue;
+                }
+                Node child = node.mChildren.get(c);
+                if (child != null) {
+                    next.add(child);
+                }
+                Node anyChild = node.mChildren.get(ANY_CHAR);
+                if (anyChild != null) {
+                    next.add(anyChild);
+                }
+            }
+            ArrayList<Node> swap = active;
+            active = next;
+            next = swap;
+            next.clear();
+        }
+        if (candidates.size() > 1) {
+            Collections.sort(candidates, ORDER_COMPARATOR);
+        }
+        for (int i = 0; i < candidates.size(); i++) {
+            Entry entry = candidates.get(i);
+            Bundle matchingArguments = entry.mDeepLink.getMatchingArguments(uri);
+            if (matchingArguments != null) {
+                return Pair.create(entry.mDestination, matchingArguments);
+            }
+        }
+        return null;
+    }
+
+    /**
+     * Returns the leading part of a uri pattern that every matching Uri must start with. Each
+     * token is either a literal character or {@link #ANY_CHAR} for an unescaped {@code '.'}.
+     * The prefix stops at the first placeholder, quantified character or other regular
+     * expression construct, so it never excludes a Uri the full pattern would match.
+     */
+    @NonNull
+    static int[] getLiteralPrefix(@NonNull String uriPattern) {
+        if (uriPattern.indexOf('|') >= 0) {
+            // Alternations can change what the start of the pattern applies to.
+            return new int[0];
+        }
+        int length = uriPattern.length();
+        int[] prefix = new int[length];
+        int size = 0;
+        int i = 0;
+        while (i < length) {
+            char c = uriPattern.charAt(i);
+            int token;
+            int consumed = 1;
+            if (c == '\\') {
+                if (i + 1 >= length || Character.isLetterOrDigit(uriPattern.charAt(i + 1))) {
+                    // Character classes such as \d or \w
+                    break;
+                }
+                token = uriPattern.charAt(i + 1);
+                consumed = 2;
+            } else if (c == '.') {
+                token = ANY_CHAR;
+            } else if ("[](){}*+?^$".indexOf(c) >= 0) {
+                break;
+            } else {
+                token = c;
+            }
+            if (isQuantifier(uriPattern, i + consumed)) {
+                // The token is optional or repeated, so it is not part of every match.
+                break;
+            }
+            prefix[size++] = token;
+            i += consumed;
+        }
+        int[] result = new int[size];
+        System.arraycopy(prefix, 0, result, 0, size);
+        return result;
+    }
+
+    /**
+     * Returns whether a quantifier starts at the given index. A {@code '{'} only starts a
+     * quantifier such as {@code {2}} or {@code {1,3}} when a digit follows it; otherwise it
+     * opens a placeholder, which ends the prefix after the current token.
+     */
+    private static boolean isQuantifier(@NonNull String uriPattern, int index) {
+        if (index >= uriPattern.length()) {
+            return false;
+        }
+        char c = uriPattern.charAt(index);
+        if (c == '{') {
+            return index + 1 < uriPattern.length()
+                    && Character.isDigit(uriPattern.charAt(index + 1));
+        }
+        return c == '*' || c == '+' || c == '?';
+    }
+
+    private static class Node {
+        SparseArrayCompat<Node> mChildren;
+        ArrayList<Entry> mEntries;
+
+        Node getOrCreateChild(int token) {
+            if (mChildren == null) {
+                mChildren = new SparseArrayCompat<>();
+            }
+            Node child = mChildren.get(token);
+            if (child == null) {
+                child = new Node();
+                mChildren.put(token, child);
+            }
+            return child;
+        }
+    }
+
+    private static class Entry {
+        final int mOrder;
+        final NavDestination mDestination;
+        final NavDeepLink mDeepLink;
+
+        Entry(int order, NavDestination destination, NavDeepLink deepLink) {
+            mOrder = order;
+            mDestination = destination;
+            mDeepLink = deepLink;
+        }
+    }
+}
@@ -34,6 +34,7 @@ import androidx.navigation.common.R;
 
 import java.util.ArrayDeque;
 import java.util.ArrayList;
+import java.util.List;
 
 /**
  * NavDestination represents one node within an overall navigation graph.
@@ -223,6 +224,25 @@ public class NavDestination {
             mDeepLinks = new ArrayList<>();
         }
         mDeepLinks.add(new NavDeepLink(uriPattern));
+        invalidateDeepLinkIndex();
+    }
+
+    /**
+     * Returns the deep links added via {@link #addDeepLink(String)}, or null if there are none.
+     */
+    @Nullable
+    List<NavDeepLink> getDeepLinks() {
+        return mDeepLinks;
+    }
+
+    /**
+     * Called when the deep links reachable from this destination change, so that any
+     * {@link NavDeepLinkIndex} built by an enclosing {@link NavGraph} is rebuilt.
+     */
+    void invalidateDeepLinkIndex() {
+        if (mParent != null) {
+            mParent.invalidateDeepLinkIndex();
+        }
     }
 
     /**
@@ -41,8 +41,20 @@ import java.util.NoSuchElementException;
  * {@link #getStartDestination starting destination} to be added to the back stack.</p>
  */
 public class NavGraph extends NavDestination implements Iterable<NavDestination> {
+    /**
+     * Supplies the child destinations of a NavGraph whose contents are inflated on first use.
+     */
+    interface ChildInflater {
+        /**
+         * Adds all child destinations, deep links, actions and arguments of the given graph.
+         */
+        void inflateChildren(@NonNull NavGraph graph);
+    }
+
     private final SparseArrayCompat<NavDestination> mNodes = new SparseArrayCompat<>();
     private int mStartDestId;
+    private NavDeepLinkIndex mDeepLinkIndex;
+    private ChildInflater mChildInflater;
 
     /**
      * Construct a new NavGraph. This NavGraph is not valid until you
@@ -80,9 +92,28 @@ public class NavGraph extends NavDestination implements Iterable<NavDestination>
         a.recycle();
     }
 
+    /**
+     * Finds the first deep link matching the given Uri in this graph or any nested graph.
+     *
+     * <p>Matching uses a {@link NavDeepLinkIndex} that is built on first use and rebuilt
+     * whenever a destination or deep link is added to or removed from this graph hierarchy.</p>
+     */
     @Override
     @Nullable
     Pair<NavDestination, Bundle> matchDeepLink(@NonNull Uri uri) {
+        if (mDeepLinkIndex == null) {
+            mDeepLinkIndex = new NavDeepLinkIndex(this);
+        }
+        return mDeepLinkIndex.matchDeepLink(uri);
+    }
+
+    /**
+     * Finds the first deep link matching the given Uri by asking every destination in turn,
+     * without using the {@link NavDeepLinkIndex}.
+     */
+    @Nullable
+    Pair<NavDestination, Bundle> matchDeepLinkWithoutIndex(@NonNull Uri uri) {
+        ensureChildrenInflated();
         // First search through any deep links directly added to this NavGraph
         Pair<NavDestination, Bundle> result = super.matchDeepLink(uri);
         if (result != null) {
@@ -90,7 +121,9 @@ public class NavGraph extends NavDestination implements Iterable<NavDestination>
         }
         // Then search through all child destinations for a matching deep link
         for (NavDestination child : this) {
-            Pair<NavDestination, Bundle> childResult = child.matchDeepLink(uri);
+            Pair<NavDestination, Bundle> childResult = child instanceof NavGraph
+                    ? ((NavGraph) child).matchDeepLinkWithoutIndex(uri)
+                    : child.matchDeepLink(uri);
             if (childResult != null) {
                 return childResult;
             }
@@ -98,6 +131,69 @@ public class NavGraph extends NavDestination implements Iterable<NavDestination>
         return null;
     }
 
+    /**
+     * Defers the inflation of this graph's contents until they are first needed, which is when
+     * this graph is navigated to, searched or otherwise iterated, or its default arguments or
+     * actions are accessed.
+     */
+    void setChildInflater(@Nullable ChildInflater childInflater) {
+        mChildInflater = childInflater;
+    }
+
+    /**
+     * Returns whether the contents of this graph are still waiting to be inflated.
+     */
+    boolean hasPendingChildInflation() {
+        return mChildInflater != null;
+    }
+
+    void ensureChildrenInflated() {
+        if (mChildInflater != null) {
+            ChildInflater childInflater = mChildInflater;
+            mChildInflater = null;
+            childInflater.inflateChildren(this);
+        }
+    }
+
+    @NonNull
+    @Override
+    public Bundle getDefaultArguments() {
+        // Default arguments of a lazily inflated graph are read with its children
+        ensureChildrenInflated();
+        return super.getDefaultArguments();
+    }
+
+    @Override
+    public void setDefaultArguments(@Nullable Bundle args) {
+        ensureChildrenInflated();
+        super.setDefaultArguments(args);
+    }
+
+    @Nullable
+    @Override
+    public NavAction getAction(@IdRes int id) {
+        ensureChildrenInflated();
+        return super.getAction(id);
+    }
+
+    @Override
+    public void putAction(@IdRes int actionId, @NonNull NavAction action) {
+        ensureChildrenInflated();
+        super.putAction(actionId, action);
+    }
+
+    @Override
+    public void removeAction(@IdRes int actionId) {
+        ensureChildrenInflated();
+        super.removeAction(actionId);
+    }
+
+    @Override
+    void invalidateDeepLinkIndex() {
+        mDeepLinkIndex = null;
+        super.invalidateDeepLinkIndex();
+    }
+
     /**
      * Adds a destination to this NavGraph. The destination must have an
      * {@link NavDestination#getId()} id} set.
@@ -113,6 +209,7 @@ public class NavGraph extends NavDestination implements Iterable<NavDestination>
             throw new IllegalArgumentException("Destinations must have an id."
                     + " Call setId() or include an android:id in your navigation XML.");
         }
+        ensureChildrenInflated();
         NavDestination existingDestination = mNodes.get(node.getId());
         if (existingDestination == node) {
             return;
@@ -126,6 +223,7 @@ public class NavGraph extends NavDestination implements Iterable<NavDestination>
         }
         node.setParent(this);
         mNodes.put(node.getId(), node);
+        invalidateDeepLinkIndex();
     }
 
     /**
@@ -179,6 +277,7 @@ public class NavGraph extends NavDestination implements Iterable<NavDestination>
     }
 
     NavDestination findNode(@IdRes int resid, boolean searchParents) {
+        ensureChildrenInflated();
         NavDestination destination = mNodes.get(resid);
         // Search the parent for the NavDestination if it is not a child of this navigation graph
         // and searchParents is true
@@ -190,6 +289,7 @@ public class NavGraph extends NavDestination implements Iterable<NavDestination>
     @NonNull
     @Override
     public Iterator<NavDestination> iterator() {
+        ensureChildrenInflated();
         return new Iterator<NavDestination>() {
             private int mIndex = -1;
             private boolean mWentToNext = false;
@@ -216,6 +316,7 @@ public class NavGraph extends NavDestination implements Iterable<NavDestination>
                 }
                 mNodes.valueAt(mIndex).setParent(null);
                 mNodes.removeAt(mIndex);
+                invalidateDeepLinkIndex();
                 mIndex--;
                 mWentToNext = false;
             }
@@ -244,10 +345,12 @@ public class NavGraph extends NavDestination implements Iterable<NavDestination>
      * @param node the destination to remove.
      */
     public void remove(@NonNull NavDestination node) {
+        ensureChildrenInflated();
         int index = mNodes.indexOfKey(node.getId());
         if (index >= 0) {
             mNodes.valueAt(index).setParent(null);
             mNodes.removeAt(index);
+            invalidateDeepLinkIndex();
         }
     }
 
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.navigation;
+
+import static org.hamcrest.CoreMatchers.is;
+import static org.hamcrest.MatcherAssert.assertThat;
+
+import android.support.test.filters.SmallTest;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+import org.junit.runners.JUnit4;
+
+@RunWith(JUnit4.class)
+@SmallTest
+public class NavDeepLinkIndexPrefixTest {
+
+    private static String prefixOf(String uriPattern) {
+        StringBuilder builder = new StringBuilder();
+        for (int token : NavDeepLinkIndex.getLiteralPrefix(uriPattern)) {
+            builder.append(token < 0 ? '?' : (char) token);
+        }
+        return builder.toString();
+    }
+
+    @Test
+    public void literalPattern() {
+        assertThat(prefixOf("android-app://com/example"), is("android-app://com/example"));
+    }
+
+    @Test
+    public void dotMatchesAnyCharacter() {
+        assertThat(prefixOf("www.example.com"), is("www?example?com"));
+    }
+
+    @Test
+    public void stopsAtPlaceholder() {
+        assertThat(prefixOf("http://example/users/{id}/posts"), is("http://example/users/"));
+    }
+
+    @Test
+    public void stopsBeforeCountQuantifiedCharacter() {
+        assertThat(prefixOf("http://example/a{2}/b"), is("http://example/"));
+        assertThat(prefixOf("http://example/ab{1,3}/{id}"), is("http://example/a"));
+    }
+
+    @Test
+    public void stopsAtWildcard() {
+        assertThat(prefixOf("http://example/posts/.*/new"), is("http://example/posts/"));
+    }
+
+    @Test
+    public void stopsBeforeQuantifiedCharacter() {
+        assertThat(prefixOf("https?://example"), is("http"));
+    }
+
+    @Test
+    public void escapedCharacterIsLiteral() {
+        assertThat(prefixOf("http://example\\.com/a"), is("http://example.com/a"));
+        assertThat(prefixOf("http://example/\\d+"), is("http://example/"));
+    }
+
+    @Test
+    public void alternationDisablesPrefix() {
+        assertThat(prefixOf("http://a|http://b"), is(""));
+    }
+}
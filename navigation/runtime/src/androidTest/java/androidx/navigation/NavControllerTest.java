@@ -92,6 +92,27 @@ public class NavControllerTest {
         assertThat(navigator.mBackStack.size(), is(2));
     }
 
+    @Test
+    public void testNavigateToLazilyIncludedGraph() {
+        NavController navController = createNavController();
+        navController.getNavInflater().setLazyIncludesEnabled(true);
+        navController.setGraph(R.navigation.nav_include);
+        TestNavigator navigator = navController.getNavigatorProvider()
+                .getNavigator(TestNavigator.class);
+        assertThat(navController.getCurrentDestination().getId(), is(R.id.start_test));
+
+        navController.navigate(R.id.included);
+        assertThat(navController.getCurrentDestination().getId(), is(R.id.included_test));
+        assertThat(navigator.mBackStack.size(), is(2));
+        // The defaults of the included graph are passed on to its start destination
+        Bundle args = navigator.mBackStack.peekLast().second;
+        assertThat(args.getInt("test_included_default"), is(12));
+
+        navController.navigate(R.id.included_action);
+        assertThat(navController.getCurrentDestination().getId(), is(R.id.included_test));
+        assertThat(navigator.mBackStack.size(), is(3));
+    }
+
     @Test
     public void testSaveRestoreStateXml() {
         Context context = InstrumentationRegistry.getTargetContext();
@@ -70,6 +70,69 @@ public class NavInflaterTest {
         assertThat(result.first.getId(), is(R.id.second_test));
     }
 
+    @Test
+    public void testInflateInclude() {
+        Context context = InstrumentationRegistry.getTargetContext();
+        NavInflater navInflater = new NavInflater(context, new TestNavigatorProvider(context));
+        NavGraph graph = navInflater.inflate(R.navigation.nav_include);
+
+        NavDestination included = graph.findNode(R.id.included_graph);
+        assertThat(included, is(notNullValue(NavDestination.class)));
+        assertThat(((NavGraph) included).hasPendingChildInflation(), is(false));
+        assertThat(((NavGraph) included).getStartDestination(), is(R.id.included_test));
+    }
+
+    @Test
+    public void testInflateIncludeLazily() {
+        Context context = InstrumentationRegistry.getTargetContext();
+        NavInflater navInflater = new NavInflater(context, new TestNavigatorProvider(context));
+        navInflater.setLazyIncludesEnabled(true);
+        NavGraph graph = navInflater.inflate(R.navigation.nav_include);
+
+        NavGraph included = (NavGraph) graph.findNode(R.id.included_graph);
+        assertThat(included, is(notNullValue(NavGraph.class)));
+        assertThat(included.hasPendingChildInflation(), is(true));
+        assertThat(included.getStartDestination(), is(R.id.included_test));
+
+        NavDestination includedTest = included.findNode(R.id.included_test);
+        assertThat(included.hasPendingChildInflation(), is(false));
+        assertThat(includedTest, is(notNullValue(NavDestination.class)));
+        assertThat(includedTest.getParent(), is(included));
+    }
+
+    @Test
+    public void testInflateIncludeLazilyArgumentsAndActions() {
+        Context context = InstrumentationRegistry.getTargetContext();
+        NavInflater navInflater = new NavInflater(context, new TestNavigatorProvider(context));
+        navInflater.setLazyIncludesEnabled(true);
+        NavGraph graph = navInflater.inflate(R.navigation.nav_include);
+
+        NavGraph included = (NavGraph) graph.findNode(R.id.included_graph);
+        assertThat(included.getDefaultArguments().getInt("test_included_default"), is(12));
+        assertThat(included.hasPendingChildInflation(), is(false));
+
+        graph = navInflater.inflate(R.navigation.nav_include);
+        included = (NavGraph) graph.findNode(R.id.included_graph);
+        NavAction action = included.getAction(R.id.included_action);
+        assertThat(included.hasPendingChildInflation(), is(false));
+        assertThat(action, is(notNullValue(NavAction.class)));
+        assertThat(action.getDestinationId(), is(R.id.included_test));
+    }
+
+    @Test
+    public void testInflateIncludeLazilyDeepLink() {
+        Context context = InstrumentationRegistry.getTargetContext();
+        NavInflater navInflater = new NavInflater(context, new TestNavigatorProvider(context));
+        navInflater.setLazyIncludesEnabled(true);
+        NavGraph graph = navInflater.inflate(R.navigation.nav_include);
+
+        Pair<NavDestination, Bundle> result = graph.matchDeepLink(
+                Uri.parse("android-app://androidx.navigation.test/included"));
+        assertThat(result, is(notNullValue()));
+        assert result != null;
+        assertThat(result.first.getId(), is(R.id.included_test));
+    }
+
     @Test
     public void testDefaultArgumentsInteger() {
         Bundle defaultArguments = inflateDefaultArgumentsFromGraph();
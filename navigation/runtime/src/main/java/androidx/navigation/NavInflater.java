@@ -67,12 +67,39 @@ public class NavInflater {
 
     private Context mContext;
     private NavigatorProvider mNavigatorProvider;
+    private boolean mLazyIncludes;
 
     public NavInflater(@NonNull Context context, @NonNull NavigatorProvider navigatorProvider) {
         mContext = context;
         mNavigatorProvider = navigatorProvider;
     }
 
+    /**
+     * Sets whether graphs referenced through {@code <include>} elements are inflated lazily.
+     *
+     * <p>When enabled, only the root element of an included graph is read while its parent is
+     * inflated, which provides its id, label and start destination. Its destinations, actions,
+     * arguments and deep links are read the first time the included graph is navigated to,
+     * searched or iterated. This reduces the cost of {@link NavController#setGraph(int)} for
+     * large graphs split across many navigation files, at the cost of reporting errors in an
+     * included file only once it is first used.</p>
+     *
+     * @param lazyIncludes true to defer inflation of included graphs, false to inflate them
+     *                     together with their parent (the default)
+     */
+    public void setLazyIncludesEnabled(boolean lazyIncludes) {
+        mLazyIncludes = lazyIncludes;
+    }
+
+    /**
+     * Returns whether graphs referenced through {@code <include>} elements are inflated lazily.
+     *
+     * @see #setLazyIncludesEnabled(boolean)
+     */
+    public boolean isLazyIncludesEnabled() {
+        return mLazyIncludes;
+    }
+
     /**
      * Inflates {@link NavGraph navigation graph} as specified in the application manifest.
      *
@@ -105,25 +132,37 @@ public class NavInflater {
     @SuppressLint("ResourceType")
     @NonNull
     public NavGraph inflate(@NavigationRes int graphResId) {
+        return inflate(graphResId, false);
+    }
+
+    /**
+     * Inflate a NavGraph from the given XML resource id. If {@code rootOnly} is true, only the
+     * attributes of the root element are read and the rest of the file is read when the graph
+     * is first used.
+     */
+    @SuppressLint("ResourceType")
+    @NonNull
+    private NavGraph inflate(@NavigationRes final int graphResId, boolean rootOnly) {
         Resources res = mContext.getResources();
         XmlResourceParser parser = res.getXml(graphResId);
         final AttributeSet attrs = Xml.asAttributeSet(parser);
         try {
-            int type;
-            while ((type = parser.next()) != XmlPullParser.START_TAG
-                    && type != XmlPullParser.END_DOCUMENT) {
-                // Empty loop
-            }
-            if (type != XmlPullParser.START_TAG) {
-                throw new XmlPullParserException("No start tag found");
-            }
-
-            String rootElement = parser.getName();
-            NavDestination destination = inflate(res, parser, attrs);
+            String rootElement = moveToRootElement(parser);
+            NavDestination destination = rootOnly
+                    ? inflateRootElement(parser, attrs)
+                    : inflate(res, parser, attrs);
             if (!(destination instanceof NavGraph)) {
                 throw new IllegalArgumentException("Root element <" + rootElement + ">"
                         + " did not inflate into a NavGraph");
             }
+            if (rootOnly) {
+                ((NavGraph) destination).setChildInflater(new NavGraph.ChildInflater() {
+                    @Override
+                    public void inflateChildren(@NonNull NavGraph graph) {
+                        inflateIncludedChildren(graphResId, graph);
+                    }
+                });
+            }
             return (NavGraph) destination;
         } catch (Exception e) {
             throw new RuntimeException("Exception inflating "
@@ -134,14 +173,62 @@ public class NavInflater {
         }
     }
 
+    /**
+     * Reads the contents of an included graph whose root element was read by
+     * {@link #inflate(int, boolean)}.
+     */
+    @SuppressLint("ResourceType")
+    private void inflateIncludedChildren(@NavigationRes int graphResId, @NonNull NavGraph graph) {
+        Resources res = mContext.getResources();
+        XmlResourceParser parser = res.getXml(graphResId);
+        final AttributeSet attrs = Xml.asAttributeSet(parser);
+        try {
+            moveToRootElement(parser);
+            inflateChildren(res, parser, attrs, graph);
+        } catch (Exception e) {
+            throw new RuntimeException("Exception inflating "
+                    + res.getResourceName(graphResId) + " line "
+                    + parser.getLineNumber(), e);
+        } finally {
+            parser.close();
+        }
+    }
+
     @NonNull
-    private NavDestination inflate(@NonNull Resources res, @NonNull XmlResourceParser parser,
-            @NonNull AttributeSet attrs) throws XmlPullParserException, IOException {
+    private static String moveToRootElement(@NonNull XmlResourceParser parser)
+            throws XmlPullParserException, IOException {
+        int type;
+        while ((type = parser.next()) != XmlPullParser.START_TAG
+                && type != XmlPullParser.END_DOCUMENT) {
+            // Empty loop
+        }
+        if (type != XmlPullParser.START_TAG) {
+            throw new XmlPullParserException("No start tag found");
+        }
+        return parser.getName();
+    }
+
+    @NonNull
+    private NavDestination inflateRootElement(@NonNull XmlResourceParser parser,
+            @NonNull AttributeSet attrs) {
         Navigator navigator = mNavigatorProvider.getNavigator(parser.getName());
         final NavDestination dest = navigator.createDestination();
 
         dest.onInflate(mContext, attrs);
+        return dest;
+    }
+
+    @NonNull
+    private NavDestination inflate(@NonNull Resources res, @NonNull XmlResourceParser parser,
+            @NonNull AttributeSet attrs) throws XmlPullParserException, IOException {
+        final NavDestination dest = inflateRootElement(parser, attrs);
+        inflateChildren(res, parser, attrs, dest);
+        return dest;
+    }
 
+    private void inflateChildren(@NonNull Resources res, @NonNull XmlResourceParser parser,
+            @NonNull AttributeSet attrs, @NonNull NavDestination dest)
+            throws XmlPullParserException, IOException {
         final int innerDepth = parser.getDepth() + 1;
         int type;
         int depth;
@@ -166,14 +253,12 @@ public class NavInflater {
             } else if (TAG_INCLUDE.equals(name) && dest instanceof NavGraph) {
                 final TypedArray a = res.obtainAttributes(attrs, R.styleable.NavInclude);
                 final int id = a.getResourceId(R.styleable.NavInclude_graph, 0);
-                ((NavGraph) dest).addDestination(inflate(id));
+                ((NavGraph) dest).addDestination(inflate(id, mLazyIncludes));
                 a.recycle();
             } else if (dest instanceof NavGraph) {
                 ((NavGraph) dest).addDestination(inflate(res, parser, attrs));
             }
         }
-
-        return dest;
     }
 
     private void inflateArgument(@NonNull Resources res, @NonNull NavDestination dest,
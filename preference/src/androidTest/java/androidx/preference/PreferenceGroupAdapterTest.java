@@ -0,0 +1,204 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.preference;
+
+import static org.junit.Assert.assertEquals;
+import static org.mockito.Mockito.any;
+import static org.mockito.Mockito.anyLong;
+import static org.mockito.Mockito.doAnswer;
+import static org.mockito.Mockito.spy;
+
+import android.content.Context;
+import android.os.Handler;
+import android.os.Message;
+import android.os.SystemClock;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.annotation.UiThreadTest;
+import android.support.test.filters.LargeTest;
+import android.support.test.filters.SmallTest;
+import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
+
+import androidx.preference.test.R;
+import androidx.recyclerview.widget.RecyclerView;
+
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+import org.mockito.invocation.InvocationOnMock;
+import org.mockito.stubbing.Answer;
+
+/**
+ * Tests for the synchronization of {@link PreferenceGroupAdapter} with its preference hierarchy.
+ */
+@RunWith(AndroidJUnit4.class)
+@SmallTest
+public class PreferenceGroupAdapterTest {
+
+    private static final String TAG = "PreferenceGroupAdapterTest";
+
+    private Context mContext;
+    private PreferenceManager mPreferenceManager;
+    private PreferenceScreen mScreen;
+    private PreferenceCategory mCategory;
+    private Preference mFirst;
+    private Preference mSecond;
+    private Preference mLast;
+    private Handler mHandler;
+
+    @Before
+    @UiThreadTest
+    public void setup() {
+        mContext = InstrumentationRegistry.getTargetContext();
+        mPreferenceManager = new PreferenceManager(mContext);
+        mScreen = mPreferenceManager.createPreferenceScreen(mContext);
+
+        mCategory = new PreferenceCategory(mContext);
+        mScreen.addPreference(mCategory);
+        mFirst = createPreference("first");
+        mSecond = createPreference("second");
+        mCategory.addPreference(mFirst);
+        mCategory.addPreference(mSecond);
+        mLast = createPreference("last");
+        mScreen.addPreference(mLast);
+
+        // Execute the handler task immediately
+        mHandler = spy(new Handler());
+        doAnswer(new Answer<Void>() {
+            @Override
+            public Void answer(InvocationOnMock invocation) {
+                Object[] args = invocation.getArguments();
+                Message message = (Message) args[0];
+                mHandler.dispatchMessage(message);
+                return null;
+            }
+        }).when(mHandler).sendMessageDelayed(any(Message.class), anyLong());
+    }
+
+    @Test
+    @UiThreadTest
+    public void testSyncsPreferencesAddedToNestedGroup() {
+        PreferenceGroupAdapter adapter =
+                PreferenceGroupAdapter.createInstanceWithCustomHandler(mScreen, mHandler);
+        assertItems(adapter, mCategory, mFirst, mSecond, mLast);
+
+        Preference added = createPreference("added");
+        mCategory.addPreference(added);
+        assertItems(adapter, mCategory, mFirst, mSecond, added, mLast);
+
+        PreferenceCategory nested = new PreferenceCategory(mContext);
+        mCategory.addPreference(nested);
+        Preference nestedChild = createPreference("nested");
+        nested.addPreference(nestedChild);
+        assertItems(adapter, mCategory, mFirst, mSecond, added, nested, nestedChild, mLast);
+    }
+
+    @Test
+    @UiThreadTest
+    public void testSyncsPreferencesRemovedAndMovedBetweenGroups() {
+        PreferenceGroupAdapter adapter =
+                PreferenceGroupAdapter.createInstanceWithCustomHandler(mScreen, mHandler);
+
+        mCategory.removePreference(mFirst);
+        assertItems(adapter, mCategory, mSecond, mLast);
+
+        mCategory.removePreference(mSecond);
+        mSecond.setOrder(Preference.DEFAULT_ORDER);
+        mScreen.addPreference(mSecond);
+        assertItems(adapter, mCategory, mLast, mSecond);
+
+        mScreen.removePreference(mCategory);
+        assertItems(adapter, mLast, mSecond);
+    }
+
+    @Test
+    @UiThreadTest
+    public void testSyncsReorderedPreferences() {
+        PreferenceGroupAdapter adapter =
+                PreferenceGroupAdapter.createInstanceWithCustomHandler(mScreen, mHandler);
+
+        mFirst.setOrder(Integer.MAX_VALUE - 1);
+        assertItems(adapter, mCategory, mSecond, mFirst, mLast);
+    }
+
+    @Test
+    @UiThreadTest
+    public void testSyncRebindsPreferencesWithChangedLayout() {
+        PreferenceGroupAdapter adapter =
+                PreferenceGroupAdapter.createInstanceWithCustomHandler(mScreen, mHandler);
+        final int[] changed = new int[] {-1, 0};
+        adapter.registerAdapterDataObserver(new RecyclerView.AdapterDataObserver() {
+            @Override
+            public void onItemRangeChanged(int positionStart, int itemCount, Object payload) {
+                changed[0] = positionStart;
+                changed[1] += itemCount;
+            }
+        });
+
+        mSecond.setWidgetLayoutResource(
+                androidx.preference.R.layout.preference_widget_checkbox);
+        mCategory.addPreference(createPreference("added"));
+        assertEquals(2, changed[0]);
+        assertEquals(1, changed[1]);
+    }
+
+    /**
+     * Measures inflating a screen of 600 preferences, creating its adapter and syncing the adapter
+     * after a preference is added.
+     */
+    @Test
+    @LargeTest
+    @UiThreadTest
+    public void testLargeScreenBenchmark() {
+        PreferenceScreen screen = mPreferenceManager.createPreferenceScreen(mContext);
+
+        long start = SystemClock.elapsedRealtime();
+        for (int i = 0; i < 12; i++) {
+            screen = mPreferenceManager.inflateFromResource(mContext, R.layout.test_large_screen,
+                    screen);
+        }
+        final long inflateTime = SystemClock.elapsedRealtime() - start;
+
+        start = SystemClock.elapsedRealtime();
+        PreferenceGroupAdapter adapter =
+                PreferenceGroupAdapter.createInstanceWithCustomHandler(screen, mHandler);
+        final long adapterTime = SystemClock.elapsedRealtime() - start;
+        assertEquals(660, adapter.getItemCount());
+
+        PreferenceGroup category = (PreferenceGroup) screen.getPreference(0);
+        start = SystemClock.elapsedRealtime();
+        category.addPreference(createPreference("added"));
+        final long syncTime = SystemClock.elapsedRealtime() - start;
+        assertEquals(661, adapter.getItemCount());
+
+        Log.d(TAG, "Large screen: inflation " + inflateTime + "ms, adapter creation "
+                + adapterTime + "ms, sync after adding a preference " + syncTime + "ms");
+    }
+
+    private Preference createPreference(String title) {
+        Preference preference = new Preference(mContext);
+        preference.setTitle(title);
+        return preference;
+    }
+
+    private static void assertItems(PreferenceGroupAdapter adapter, Preference... expected) {
+        assertEquals(expected.length, adapter.getItemCount());
+        for (int i = 0; i < expected.length; i++) {
+            assertEquals(expected[i], adapter.getItem(i));
+        }
+    }
+}
@@ -34,7 +34,11 @@ import androidx.recyclerview.widget.DiffUtil;
 import androidx.recyclerview.widget.RecyclerView;
 
 import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.HashSet;
 import java.util.List;
+import java.util.Map;
+import java.util.Set;
 
 /**
  * An adapter that connects a RecyclerView to the {@link Preference} objects contained in the
@@ -59,6 +63,12 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
      */
     private List<Preference> mPreferenceList;
 
+    /**
+     * Layouts of the preferences in {@link #mPreferenceList} when it was built, to find the
+     * preferences whose layout changed since.
+     */
+    private List<PreferenceLayout> mPreferenceListLayouts;
+
     /**
      * Contains a sorted list of all preferences in this adapter regardless of visibility. This is
      * used to construct {@link #mPreferenceList}
@@ -70,6 +80,21 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
      */
     private List<PreferenceLayout> mPreferenceLayouts;
 
+    /**
+     * Maps each of {@link #mPreferenceLayouts} to its index, which is its view type.
+     */
+    private Map<PreferenceLayout, Integer> mPreferenceLayoutTypes;
+
+    /**
+     * Flattened subtrees of the groups in this adapter, as built by the last sync. Subtrees of
+     * groups that aren't in {@link #mDirtyGroups} are reused by the next sync as they are.
+     */
+    private final Map<PreferenceGroup, List<Preference>> mFlattenedGroups = new HashMap<>();
+
+    /**
+     * Groups whose children changed since the last sync, and their ancestors.
+     */
+    private final Set<PreferenceGroup> mDirtyGroups = new HashSet<>();
 
     private PreferenceLayout mTempPreferenceLayout = new PreferenceLayout();
 
@@ -131,8 +156,10 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
         mPreferenceGroup.setOnPreferenceChangeInternalListener(this);
 
         mPreferenceList = new ArrayList<>();
+        mPreferenceListLayouts = new ArrayList<>();
         mPreferenceListInternal = new ArrayList<>();
         mPreferenceLayouts = new ArrayList<>();
+        mPreferenceLayoutTypes = new HashMap<>();
 
         if (mPreferenceGroup instanceof PreferenceScreen) {
             setHasStableIds(((PreferenceScreen) mPreferenceGroup).shouldUseGeneratedIds());
@@ -150,19 +177,31 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
     }
 
     private void syncMyPreferences() {
-        for (final Preference preference : mPreferenceListInternal) {
-            // Clear out the listeners in anticipation of some items being removed. This listener
-            // will be (re-)added to the remaining prefs when we flatten.
-            preference.setOnPreferenceChangeInternalListener(null);
+        final List<Preference> removedCandidates = new ArrayList<>();
+        final List<Preference> fullPreferenceList =
+                flattenPreferenceGroup(mPreferenceGroup, removedCandidates);
+        mDirtyGroups.clear();
+        for (final Preference preference : removedCandidates) {
+            // Clear out the listeners of preferences that have been removed. Preferences that
+            // have moved within the hierarchy have had their listener set again when flattened.
+            if (!isFlattened(preference)) {
+                preference.setOnPreferenceChangeInternalListener(null);
+                mFlattenedGroups.remove(preference);
+            }
         }
-        final List<Preference> fullPreferenceList = new ArrayList<>(mPreferenceListInternal.size());
-        flattenPreferenceGroup(fullPreferenceList, mPreferenceGroup);
 
         final List<Preference> visiblePreferenceList =
                 mPreferenceGroupController.createVisiblePreferencesList(mPreferenceGroup);
 
         final List<Preference> oldVisibleList = mPreferenceList;
+        final List<PreferenceLayout> oldVisibleLayouts = mPreferenceListLayouts;
+        final List<PreferenceLayout> visibleLayouts =
+                new ArrayList<>(visiblePreferenceList.size());
+        for (final Preference preference : visiblePreferenceList) {
+            visibleLayouts.add(createPreferenceLayout(preference, null));
+        }
         mPreferenceList = visiblePreferenceList;
+        mPreferenceListLayouts = visibleLayouts;
         mPreferenceListInternal = fullPreferenceList;
 
         final PreferenceManager preferenceManager = mPreferenceGroup.getPreferenceManager();
@@ -197,6 +236,34 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
             });
 
             result.dispatchUpdatesTo(this);
+        } else if (!oldVisibleList.isEmpty()) {
+            // Without a comparison callback, match preferences by identity. Changes to the
+            // contents of a preference are notified through onPreferenceChange(), so only
+            // moves, insertions, removals and layout changes need to be dispatched here, and
+            // preferences that are still shown with the same layout aren't bound again.
+            DiffUtil.calculateDiff(new DiffUtil.Callback() {
+                @Override
+                public int getOldListSize() {
+                    return oldVisibleList.size();
+                }
+
+                @Override
+                public int getNewListSize() {
+                    return visiblePreferenceList.size();
+                }
+
+                @Override
+                public boolean areItemsTheSame(int oldItemPosition, int newItemPosition) {
+                    return oldVisibleList.get(oldItemPosition)
+                            == visiblePreferenceList.get(newItemPosition);
+                }
+
+                @Override
+                public boolean areContentsTheSame(int oldItemPosition, int newItemPosition) {
+                    return oldVisibleLayouts.get(oldItemPosition)
+                            .equals(visibleLayouts.get(newItemPosition));
+                }
+            }).dispatchUpdatesTo(this);
         } else {
             notifyDataSetChanged();
         }
@@ -206,10 +273,25 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
         }
     }
 
-    private void flattenPreferenceGroup(List<Preference> preferences, PreferenceGroup group) {
+    /**
+     * Returns the flattened subtree of {@code group}, reusing the list built by the last sync
+     * unless the group or one of its descendants has changed since.
+     *
+     * @param removedCandidates Receives the preferences that were in the previous subtree of a
+     *                          changed group, and may have been removed from the hierarchy.
+     */
+    private List<Preference> flattenPreferenceGroup(PreferenceGroup group,
+            List<Preference> removedCandidates) {
+        final List<Preference> previous = mFlattenedGroups.get(group);
+        if (previous != null && !mDirtyGroups.contains(group)) {
+            return previous;
+        }
+
         group.sortPreferences();
 
         final int groupSize = group.getPreferenceCount();
+        final List<Preference> preferences = new ArrayList<>(
+                previous != null ? previous.size() : groupSize);
         for (int i = 0; i < groupSize; i++) {
             final Preference preference = group.getPreference(i);
 
@@ -220,12 +302,46 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
             if (preference instanceof PreferenceGroup) {
                 final PreferenceGroup preferenceAsGroup = (PreferenceGroup) preference;
                 if (preferenceAsGroup.isOnSameScreenAsChildren()) {
-                    flattenPreferenceGroup(preferences, preferenceAsGroup);
+                    preferences.addAll(
+                            flattenPreferenceGroup(preferenceAsGroup, removedCandidates));
                 }
             }
 
             preference.setOnPreferenceChangeInternalListener(this);
         }
+
+        if (previous != null) {
+            removedCandidates.addAll(previous);
+        }
+        mFlattenedGroups.put(group, preferences);
+        return preferences;
+    }
+
+    /**
+     * @return true if {@code preference} is part of the flattened hierarchy of this adapter.
+     */
+    private boolean isFlattened(Preference preference) {
+        for (PreferenceGroup parent = preference.getParent(); parent != null;
+                parent = parent.getParent()) {
+            if (parent == mPreferenceGroup) {
+                return true;
+            }
+            if (!parent.isOnSameScreenAsChildren()) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Marks {@code group} and its ancestors to be flattened again by the next sync.
+     */
+    private void markGroupChanged(PreferenceGroup group) {
+        // Ancestors of a group that is already marked are marked as well.
+        PreferenceGroup changed = group;
+        while (changed != null && mDirtyGroups.add(changed)) {
+            changed = changed.getParent();
+        }
     }
 
     /**
@@ -242,10 +358,23 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
     }
 
     private void addPreferenceClassName(Preference preference) {
-        final PreferenceLayout pl = createPreferenceLayout(preference, null);
-        if (!mPreferenceLayouts.contains(pl)) {
-            mPreferenceLayouts.add(pl);
+        mTempPreferenceLayout = createPreferenceLayout(preference, mTempPreferenceLayout);
+        getViewType(mTempPreferenceLayout);
+    }
+
+    /**
+     * @return the view type of {@code layout}, adding a new view type for it if needed.
+     */
+    private int getViewType(PreferenceLayout layout) {
+        final Integer viewType = mPreferenceLayoutTypes.get(layout);
+        if (viewType != null) {
+            return viewType;
         }
+        final PreferenceLayout pl = new PreferenceLayout(layout);
+        final int newViewType = mPreferenceLayouts.size();
+        mPreferenceLayouts.add(pl);
+        mPreferenceLayoutTypes.put(pl, newViewType);
+        return newViewType;
     }
 
     @Override
@@ -278,6 +407,12 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
 
     @Override
     public void onPreferenceHierarchyChange(Preference preference) {
+        // A group notifies when its children change, and any preference when its order changes,
+        // which changes the order of its parent's children.
+        if (preference instanceof PreferenceGroup) {
+            markGroupChanged((PreferenceGroup) preference);
+        }
+        markGroupChanged(preference.getParent());
         mHandler.removeCallbacks(mSyncRunnable);
         mHandler.post(mSyncRunnable);
     }
@@ -327,15 +462,7 @@ public class PreferenceGroupAdapter extends RecyclerView.Adapter<PreferenceViewH
         final Preference preference = this.getItem(position);
 
         mTempPreferenceLayout = createPreferenceLayout(preference, mTempPreferenceLayout);
-
-        int viewType = mPreferenceLayouts.indexOf(mTempPreferenceLayout);
-        if (viewType != -1) {
-            return viewType;
-        } else {
-            viewType = mPreferenceLayouts.size();
-            mPreferenceLayouts.add(new PreferenceLayout(mTempPreferenceLayout));
-            return viewType;
-        }
+        return getViewType(mTempPreferenceLayout);
     }
 
     @Override
@@ -45,6 +45,89 @@ class PreferenceInflater {
 
     private static final HashMap<String, Constructor> CONSTRUCTOR_MAP = new HashMap<>();
 
+    /**
+     * Creates a preference of a particular class without reflection.
+     */
+    private interface Factory {
+        Preference create(Context context, AttributeSet attrs);
+    }
+
+    /**
+     * Factories for the preferences of this library, keyed by class name. Names are taken from
+     * the classes, so that they stay correct when the library is de-Jetified. Other classes are
+     * instantiated by reflection.
+     */
+    private static final HashMap<String, Factory> FACTORY_MAP = new HashMap<>();
+
+    static {
+        FACTORY_MAP.put(Preference.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new Preference(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(PreferenceCategory.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new PreferenceCategory(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(PreferenceScreen.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new PreferenceScreen(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(CheckBoxPreference.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new CheckBoxPreference(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(SwitchPreferenceCompat.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new SwitchPreferenceCompat(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(SwitchPreference.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new SwitchPreference(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(EditTextPreference.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new EditTextPreference(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(ListPreference.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new ListPreference(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(MultiSelectListPreference.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new MultiSelectListPreference(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(DropDownPreference.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new DropDownPreference(context, attrs);
+            }
+        });
+        FACTORY_MAP.put(SeekBarPreference.class.getName(), new Factory() {
+            @Override
+            public Preference create(Context context, AttributeSet attrs) {
+                return new SeekBarPreference(context, attrs);
+            }
+        });
+    }
+
     private final Context mContext;
 
     private final Object[] mConstructorArgs = new Object[2];
@@ -222,6 +305,14 @@ class PreferenceInflater {
         Constructor constructor = CONSTRUCTOR_MAP.get(name);
 
         try {
+            if (constructor == null) {
+                // Preferences of this library are created directly.
+                final Factory factory = findFactory(name, prefixes);
+                if (factory != null) {
+                    return factory.create(mContext, attrs);
+                }
+            }
+
             if (constructor == null) {
                 // Class not found in the cache, see if it's real,
                 // and try to add it
@@ -269,6 +360,33 @@ class PreferenceInflater {
         }
     }
 
+    /**
+     * @return the factory of the class with the given name, trying the given prefixes in order
+     * like {@link #createItem}, or null if the first class that resolves isn't one of this
+     * library's preferences.
+     */
+    private @Nullable Factory findFactory(@NonNull String name, @Nullable String[] prefixes) {
+        if (prefixes == null || prefixes.length == 0) {
+            return FACTORY_MAP.get(name);
+        }
+        final ClassLoader classLoader = mContext.getClassLoader();
+        for (final String prefix : prefixes) {
+            final Factory factory = FACTORY_MAP.get(prefix + name);
+            if (factory != null) {
+                return factory;
+            }
+            // A class with the same name in a package listed earlier takes precedence, as it
+            // does when classes are loaded by createItem().
+            try {
+                classLoader.loadClass(prefix + name);
+                return null;
+            } catch (final ClassNotFoundException e) {
+                // Try the next prefix
+            }
+        }
+        return null;
+    }
+
     /**
      * This routine is responsible for creating the correct subclass of item
      * given the xml element name. Override it to handle custom item objects. If
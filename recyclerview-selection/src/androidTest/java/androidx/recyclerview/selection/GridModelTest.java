@@ -24,8 +24,11 @@ import static org.junit.Assert.assertTrue;
 
 import android.graphics.Point;
 import android.graphics.Rect;
+import android.os.SystemClock;
+import android.support.test.filters.LargeTest;
 import android.support.test.filters.SmallTest;
 import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
 
 import androidx.recyclerview.selection.testing.TestAdapter;
 import androidx.recyclerview.selection.testing.TestItemKeyProvider;
@@ -45,6 +48,8 @@ import javax.annotation.Nullable;
 @SmallTest
 public class GridModelTest {
 
+    private static final String TAG = "GridModelTest";
+
     private static final int VIEW_PADDING_PX = 5;
     private static final int CHILD_VIEW_EDGE_PX = 100;
     private static final int VIEWPORT_HEIGHT = 500;
@@ -219,6 +224,69 @@ public class GridModelTest {
         assertEquals(0, mModel.getPositionNearestOrigin());
     }
 
+    @Test
+    public void testSelectionChangingRowsAndColumns() {
+        initData(40, 4);
+
+        startSelection(new Point(210, 210));
+        Point[] trace = new Point[] {
+                new Point(0, 0),
+                new Point(320, 0),
+                new Point(320, 420),
+                new Point(110, 420),
+                new Point(5, 110),
+                new Point(mViewWidth - 1, 5),
+                new Point(215, 214),
+        };
+        for (Point point : trace) {
+            resizeSelection(point);
+            verifySelection();
+        }
+
+        resizeSelection(new Point(5, VIEWPORT_HEIGHT - 1));
+        scroll(CHILD_VIEW_EDGE_PX);
+        verifySelection();
+
+        resizeSelection(new Point(mViewWidth - 1, VIEWPORT_HEIGHT - 1));
+        verifySelection();
+    }
+
+    /**
+     * Replays a band drag over a 2000 item grid, sweeping the pointer across the columns while
+     * scrolling down to the end of the grid and back up again.
+     */
+    @LargeTest
+    @Test
+    public void testBandDragBenchmark() {
+        initData(2000, 10);
+        final int step = CHILD_VIEW_EDGE_PX / 2;
+        final int maxOffset = mHost.getTotalHeight() - VIEWPORT_HEIGHT;
+
+        startSelection(new Point(0, 0));
+        int events = 0;
+        boolean scrollingDown = true;
+        long start = SystemClock.elapsedRealtime();
+        while (true) {
+            for (int x = 0; x < mViewWidth; x += step) {
+                resizeSelection(new Point(x, VIEWPORT_HEIGHT - 1));
+                events++;
+            }
+            if (scrollingDown && mHost.verticalOffset + step > maxOffset) {
+                scrollingDown = false;
+            }
+            int dy = scrollingDown ? step : -step;
+            if (mHost.verticalOffset + dy < 0) {
+                break;
+            }
+            scroll(dy);
+            events++;
+        }
+        long time = SystemClock.elapsedRealtime() - start;
+
+        Log.d(TAG, events + " band drag events over 2000 items: " + time + "ms");
+        verifySelection();
+    }
+
     private void initData(final int numChildren, int numColumns) {
         mHost = new TestHost(numChildren, numColumns);
         mAdapter = new TestAdapter() {
@@ -0,0 +1,206 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.recyclerview.selection;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertTrue;
+
+import android.support.test.filters.SmallTest;
+import android.support.test.runner.AndroidJUnit4;
+
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.ArrayList;
+import java.util.HashSet;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Random;
+import java.util.Set;
+
+@RunWith(AndroidJUnit4.class)
+@SmallTest
+public class LongRangeSetTest {
+
+    private LongRangeSet mSet;
+
+    @Before
+    public void setUp() {
+        mSet = new LongRangeSet();
+    }
+
+    @Test
+    public void testAdd_JoinsConsecutiveKeys() {
+        assertTrue(mSet.add(1L));
+        assertTrue(mSet.add(3L));
+        assertEquals(2, mSet.getRangeCount());
+
+        assertTrue(mSet.add(2L));
+        assertEquals(1, mSet.getRangeCount());
+        assertEquals(3, mSet.size());
+        assertFalse(mSet.add(2L));
+    }
+
+    @Test
+    public void testAddRange_JoinsOverlappingRanges() {
+        mSet.addRange(0, 9);
+        mSet.addRange(20, 29);
+        mSet.addRange(40, 49);
+
+        assertTrue(mSet.addRange(5, 42));
+        assertEquals(1, mSet.getRangeCount());
+        assertEquals(50, mSet.size());
+        assertFalse(mSet.addRange(10, 20));
+    }
+
+    @Test
+    public void testRemove_SplitsRange() {
+        mSet.addRange(0, 9);
+
+        assertTrue(mSet.remove(5L));
+        assertEquals(2, mSet.getRangeCount());
+        assertEquals(9, mSet.size());
+        assertFalse(mSet.contains(5L));
+        assertTrue(mSet.contains(4L));
+        assertTrue(mSet.contains(6L));
+        assertFalse(mSet.remove(5L));
+    }
+
+    @Test
+    public void testRemoveRange_TrimsRanges() {
+        mSet.addRange(0, 9);
+        mSet.addRange(20, 29);
+
+        assertTrue(mSet.removeRange(5, 24));
+        assertEquals(10, mSet.size());
+        assertFalse(mSet.contains(9L));
+        assertFalse(mSet.contains(20L));
+        assertTrue(mSet.contains(25L));
+    }
+
+    @Test
+    public void testContains_IgnoresOtherTypes() {
+        mSet.add(1L);
+        assertFalse(mSet.contains(1));
+        assertFalse(mSet.contains("1"));
+    }
+
+    @Test
+    public void testIterator_AscendingOrder() {
+        mSet.add(7L);
+        mSet.addRange(1, 3);
+
+        List<Long> values = new ArrayList<>(mSet);
+        assertEquals(4, values.size());
+        assertEquals(1L, (long) values.get(0));
+        assertEquals(3L, (long) values.get(2));
+        assertEquals(7L, (long) values.get(3));
+    }
+
+    @Test
+    public void testIterator_Remove() {
+        mSet.addRange(0, 9);
+
+        for (Iterator<Long> it = mSet.iterator(); it.hasNext(); ) {
+            if (it.next() % 2 == 0) {
+                it.remove();
+            }
+        }
+        assertEquals(5, mSet.size());
+        assertEquals(5, mSet.getRangeCount());
+        assertTrue(mSet.contains(9L));
+        assertFalse(mSet.contains(8L));
+    }
+
+    @Test
+    public void testMatchesHashSet() {
+        Random random = new Random(42);
+        Set<Long> expected = new HashSet<>();
+        LongRangeSet other = new LongRangeSet();
+        Set<Long> expectedOther = new HashSet<>();
+
+        for (int i = 0; i < 2000; i++) {
+            long key = random.nextInt(500);
+            switch (random.nextInt(3)) {
+                case 0:
+                    assertEquals(expected.add(key), mSet.add(key));
+                    break;
+                case 1:
+                    assertEquals(expected.remove(key), mSet.remove(key));
+                    break;
+                default:
+                    expectedOther.add(key);
+                    other.add(key);
+                    break;
+            }
+        }
+        assertEquals(expected, mSet);
+        assertEquals(mSet, expected);
+        assertEquals(expected.hashCode(), mSet.hashCode());
+
+        LongRangeSet union = new LongRangeSet(mSet);
+        Set<Long> expectedUnion = new HashSet<>(expected);
+        assertEquals(expectedUnion.addAll(expectedOther), union.addAll(other));
+        assertEquals(expectedUnion, union);
+
+        LongRangeSet difference = new LongRangeSet(mSet);
+        Set<Long> expectedDifference = new HashSet<>(expected);
+        assertEquals(expectedDifference.removeAll(expectedOther), difference.removeAll(other));
+        assertEquals(expectedDifference, difference);
+        assertEquals(expectedDifference.size(), difference.size());
+    }
+
+    @Test
+    public void testSparseKeysAddedInDescendingOrder() {
+        for (long key = 20; key > 0; key -= 2) {
+            assertTrue(mSet.add(key));
+        }
+        assertEquals(10, mSet.getRangeCount());
+
+        List<Long> keys = new ArrayList<>(mSet);
+        for (int i = 0; i < keys.size(); i++) {
+            assertEquals(Long.valueOf(2 * (i + 1)), keys.get(i));
+        }
+
+        // Joins 2 to 18, which touches 17, leaving 20 on its own.
+        assertTrue(mSet.addRange(3, 17));
+        assertEquals(2, mSet.getRangeCount());
+        assertEquals(18, mSet.size());
+    }
+
+    @Test
+    public void testRemoveAll_Self() {
+        mSet.addRange(1, 5);
+        assertTrue(mSet.removeAll(mSet));
+        assertTrue(mSet.isEmpty());
+        assertFalse(mSet.removeAll(mSet));
+    }
+
+    @Test
+    public void testExtremeValues() {
+        mSet.add(Long.MAX_VALUE);
+        mSet.add(Long.MIN_VALUE);
+        mSet.add(Long.MAX_VALUE - 1);
+
+        assertEquals(2, mSet.getRangeCount());
+        assertTrue(mSet.contains(Long.MIN_VALUE));
+        assertTrue(mSet.remove(Long.MAX_VALUE));
+        assertTrue(mSet.contains(Long.MAX_VALUE - 1));
+    }
+}
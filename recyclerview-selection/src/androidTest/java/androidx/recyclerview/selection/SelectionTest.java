@@ -20,21 +20,30 @@ import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
 import static org.junit.Assert.assertTrue;
 
+import android.os.SystemClock;
+import android.support.test.filters.LargeTest;
 import android.support.test.filters.SmallTest;
 import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
 
 import org.junit.Before;
 import org.junit.Test;
 import org.junit.runner.RunWith;
 
+import java.util.ArrayList;
 import java.util.Collections;
 import java.util.HashSet;
+import java.util.List;
+import java.util.Map;
+import java.util.Random;
 import java.util.Set;
 
 @RunWith(AndroidJUnit4.class)
 @SmallTest
 public class SelectionTest {
 
+    private static final String TAG = "SelectionTest";
+
     private final String[] mIds = new String[] {
             "foo",
             "43",
@@ -140,6 +149,105 @@ public class SelectionTest {
         assertFalse(mSelection.equals(other));
     }
 
+    @Test
+    public void testSetProvisionalSelection_RangesMatchHashSets() {
+        Selection<Long> hashed = new Selection<>();
+        Selection<Long> ranged = new Selection<>(new LongRangeSet(), new LongRangeSet());
+        for (long key = 0; key < 20; key += 3) {
+            hashed.add(key);
+            ranged.add(key);
+        }
+
+        long[][] bands = {{5, 15}, {10, 30}, {0, 4}};
+        for (long[] band : bands) {
+            Set<Long> hashedBand = new HashSet<>();
+            LongRangeSet rangedBand = new LongRangeSet();
+            for (long key = band[0]; key <= band[1]; key++) {
+                hashedBand.add(key);
+                rangedBand.add(key);
+            }
+            Map<Long, Boolean> delta = ranged.setProvisionalSelection(rangedBand);
+            assertEquals(hashed.setProvisionalSelection(hashedBand), delta);
+            assertEquals(hashed, ranged);
+        }
+
+        hashed.mergeProvisionalSelection();
+        ranged.mergeProvisionalSelection();
+        assertEquals(hashed, ranged);
+        assertEquals(hashed.hashCode(), ranged.hashCode());
+    }
+
+    /**
+     * Measures a band selection growing across 100k items with stable id keys, with keys
+     * stored in hash sets and in range sets.
+     */
+    @LargeTest
+    @Test
+    public void testBandSelectionBenchmark() {
+        Selection<Long> hashed = new Selection<>();
+        long hashedTime = runBandSelection(hashed, new HashSet<Long>());
+        Selection<Long> ranged = new Selection<>(new LongRangeSet(), new LongRangeSet());
+        long rangedTime = runBandSelection(ranged, new LongRangeSet());
+
+        Log.d(TAG, "Band selection of 100000 items: hash sets " + hashedTime
+                + "ms, range sets " + rangedTime + "ms");
+        assertEquals(100000, ranged.size());
+        assertEquals(hashed, ranged);
+    }
+
+    /**
+     * Measures selecting and then deselecting 100k items whose stable ids aren't consecutive,
+     * in random order, so that every key is a range of its own.
+     */
+    @LargeTest
+    @Test
+    public void testSparseKeysBenchmark() {
+        final int itemCount = 100000;
+        List<Long> keys = new ArrayList<>(itemCount);
+        for (long key = 0; key < itemCount; key++) {
+            keys.add(key * 2);
+        }
+        Collections.shuffle(keys, new Random(42));
+
+        Selection<Long> hashed = new Selection<>();
+        long hashedTime = runSelectAndDeselect(hashed, keys);
+        Selection<Long> ranged = new Selection<>(new LongRangeSet(), new LongRangeSet());
+        long rangedTime = runSelectAndDeselect(ranged, keys);
+
+        Log.d(TAG, "Sparse selection of " + itemCount + " items: hash sets " + hashedTime
+                + "ms, range sets " + rangedTime + "ms");
+        assertEquals(hashed, ranged);
+        assertEquals(itemCount / 2, ranged.size());
+    }
+
+    private static long runSelectAndDeselect(Selection<Long> selection, List<Long> keys) {
+        long start = SystemClock.elapsedRealtime();
+        for (Long key : keys) {
+            selection.add(key);
+        }
+        // Deselecting every other key leaves the remaining ones just as sparse.
+        for (int i = 0; i < keys.size(); i += 2) {
+            selection.remove(keys.get(i));
+        }
+        return SystemClock.elapsedRealtime() - start;
+    }
+
+    private static long runBandSelection(Selection<Long> selection, Set<Long> band) {
+        final int itemCount = 100000;
+        final int moves = 100;
+        long start = SystemClock.elapsedRealtime();
+        for (int move = 1; move <= moves; move++) {
+            // GridModel rebuilds the band selection with each pointer move.
+            band.clear();
+            for (long key = 0; key < itemCount * move / moves; key++) {
+                band.add(key);
+            }
+            selection.setProvisionalSelection(band);
+        }
+        selection.mergeProvisionalSelection();
+        return SystemClock.elapsedRealtime() - start;
+    }
+
     private void assertContains(String id) {
         String err = String.format("Selection %s does not contain %s", mSelection, id);
         assertTrue(err, mSelection.contains(id));
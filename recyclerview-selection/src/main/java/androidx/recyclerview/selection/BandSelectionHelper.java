@@ -128,12 +128,14 @@ class BandSelectionHelper<K> implements OnItemTouchListener {
             @NonNull ItemKeyProvider<K> keyProvider,
             @NonNull SelectionTracker<K> selectionTracker,
             @NonNull SelectionPredicate<K> selectionPredicate,
+            @NonNull StorageStrategy<K> storage,
             @NonNull BandPredicate bandPredicate,
             @NonNull FocusDelegate<K> focusDelegate,
             @NonNull OperationMonitor lock) {
 
         return new BandSelectionHelper<>(
-                new DefaultBandHost<>(recyclerView, bandOverlayId, keyProvider, selectionPredicate),
+                new DefaultBandHost<>(
+                        recyclerView, bandOverlayId, keyProvider, selectionPredicate, storage),
                 scroller,
                 keyProvider,
                 selectionTracker,
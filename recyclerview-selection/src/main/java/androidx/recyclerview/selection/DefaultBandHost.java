@@ -43,12 +43,14 @@ final class DefaultBandHost<K> extends GridModel.GridHost<K> {
     private final Drawable mBand;
     private final ItemKeyProvider<K> mKeyProvider;
     private final SelectionPredicate<K> mSelectionPredicate;
+    private final StorageStrategy<K> mStorage;
 
     DefaultBandHost(
             @NonNull RecyclerView recyclerView,
             @DrawableRes int bandOverlayId,
             @NonNull ItemKeyProvider<K> keyProvider,
-            @NonNull SelectionPredicate<K> selectionPredicate) {
+            @NonNull SelectionPredicate<K> selectionPredicate,
+            @NonNull StorageStrategy<K> storage) {
 
         checkArgument(recyclerView != null);
 
@@ -58,9 +60,11 @@ final class DefaultBandHost<K> extends GridModel.GridHost<K> {
         checkArgument(mBand != null);
         checkArgument(keyProvider != null);
         checkArgument(selectionPredicate != null);
+        checkArgument(storage != null);
 
         mKeyProvider = keyProvider;
         mSelectionPredicate = selectionPredicate;
+        mStorage = storage;
 
         mRecyclerView.addItemDecoration(
                 new ItemDecoration() {
@@ -76,7 +80,8 @@ final class DefaultBandHost<K> extends GridModel.GridHost<K> {
 
     @Override
     GridModel<K> createGridModel() {
-        return new GridModel<>(this, mKeyProvider, mSelectionPredicate);
+        return new GridModel<>(
+                this, mKeyProvider, mSelectionPredicate, mStorage.createKeySet());
     }
 
     @Override
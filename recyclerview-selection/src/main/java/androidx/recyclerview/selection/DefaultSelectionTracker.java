@@ -55,7 +55,7 @@ public class DefaultSelectionTracker<K> extends SelectionTracker<K> {
     private static final String TAG = "DefaultSelectionTracker";
     private static final String EXTRA_SELECTION_PREFIX = "androidx.recyclerview.selection";
 
-    private final Selection<K> mSelection = new Selection<>();
+    private final Selection<K> mSelection;
     private final List<SelectionObserver> mObservers = new ArrayList<>(1);
     private final ItemKeyProvider<K> mKeyProvider;
     private final SelectionPredicate<K> mSelectionPredicate;
@@ -92,6 +92,7 @@ public class DefaultSelectionTracker<K> extends SelectionTracker<K> {
         mKeyProvider = keyProvider;
         mSelectionPredicate = selectionPredicate;
         mStorage = storage;
+        mSelection = new Selection<>(storage.createKeySet(), storage.createKeySet());
 
         mRangeCallbacks = new RangeCallbacks();
 
@@ -184,7 +185,8 @@ public class DefaultSelectionTracker<K> extends SelectionTracker<K> {
     private Selection clearSelectionQuietly() {
         mRange = null;
 
-        MutableSelection prevSelection = new MutableSelection();
+        MutableSelection<K> prevSelection =
+                new MutableSelection<>(mStorage.createKeySet(), mStorage.createKeySet());
         if (hasSelection()) {
             copySelection(prevSelection);
             mSelection.clear();
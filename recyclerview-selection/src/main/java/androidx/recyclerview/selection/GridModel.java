@@ -59,17 +59,23 @@ final class GridModel<K> {
     private static final int LOWER_LEFT = LOWER | LEFT;
     private static final int LOWER_RIGHT = LOWER | RIGHT;
 
+    // Column range of a row which isn't covered by the band. See updateRow().
+    private static final int EMPTY_LEFT = Integer.MAX_VALUE;
+    private static final int EMPTY_RIGHT = Integer.MIN_VALUE;
+
     private final GridHost<K> mHost;
     private final ItemKeyProvider<K> mKeyProvider;
     private final SelectionPredicate<K> mSelectionPredicate;
 
     private final List<SelectionObserver> mOnSelectionChangedListeners = new ArrayList<>();
 
-    // Map from the x-value of the left side of a SparseBooleanArray of adapter positions, keyed
-    // by their y-offset. For example, if the first column of the view starts at an x-value of 5,
-    // mColumns.get(5) would return an array of positions in that column. Within that array, the
-    // value for key y is the adapter position for the item whose y-offset is y.
-    private final SparseArray<SparseIntArray> mColumns = new SparseArray<>();
+    // Map from the y-value of the top side of a row to a SparseIntArray of adapter positions,
+    // keyed by their x-offset. For example, if the first row of the view starts at a y-value of
+    // 5, mRows.get(5) would return an array of positions in that row. Within that array, the
+    // value for key x is the adapter position for the item whose x-offset is x. Rows are found
+    // by binary search of mRowBounds, and the items of a row covered by the band by binary
+    // search of its keys, so band queries don't scan items outside of the band.
+    private final SparseArray<SparseIntArray> mRows = new SparseArray<>();
 
     // List of limits along the x-axis (columns).
     // This list is sorted from furthest left to furthest right.
@@ -84,7 +90,16 @@ final class GridModel<K> {
 
     // Array passed to registered OnSelectionChangedListeners. One array is created and reused
     // throughout the lifetime of the object.
-    private final Set<K> mSelection = new HashSet<>();
+    private final Set<K> mSelection;
+
+    // Lower limits of the first and last columns and rows covered by mSelection, valid when
+    // mHasSelectionBounds is true. As the band moves, only items covered by either the previous
+    // or the new bounds, but not by both, are added to or removed from mSelection.
+    private boolean mHasSelectionBounds;
+    private int mSelectionLeft;
+    private int mSelectionRight;
+    private int mSelectionTop;
+    private int mSelectionBottom;
 
     // The current pointer (in absolute positioning from the top of the view).
     private Point mPointer;
@@ -105,14 +120,28 @@ final class GridModel<K> {
             GridHost host,
             ItemKeyProvider<K> keyProvider,
             SelectionPredicate<K> selectionPredicate) {
+        this(host, keyProvider, selectionPredicate, new HashSet<K>());
+    }
+
+    /**
+     * @param selection Empty set holding the band selection, as created by
+     *         {@link StorageStrategy#createKeySet()}.
+     */
+    GridModel(
+            GridHost host,
+            ItemKeyProvider<K> keyProvider,
+            SelectionPredicate<K> selectionPredicate,
+            Set<K> selection) {
 
         checkArgument(host != null);
         checkArgument(keyProvider != null);
         checkArgument(selectionPredicate != null);
+        checkArgument(selection != null);
 
         mHost = host;
         mKeyProvider = keyProvider;
         mSelectionPredicate = selectionPredicate;
+        mSelection = selection;
 
         mScrollListener = new OnScrollListener() {
             @Override
@@ -232,12 +261,25 @@ final class GridModel<K> {
 
         recordLimits(mRowBounds, new Limits(absoluteChildRect.top, absoluteChildRect.bottom));
 
-        SparseIntArray columnList = mColumns.get(absoluteChildRect.left);
-        if (columnList == null) {
-            columnList = new SparseIntArray();
-            mColumns.put(absoluteChildRect.left, columnList);
+        SparseIntArray rowList = mRows.get(absoluteChildRect.top);
+        if (rowList == null) {
+            rowList = new SparseIntArray();
+            mRows.put(absoluteChildRect.top, rowList);
+        }
+        rowList.put(absoluteChildRect.left, adapterPosition);
+
+        // Items recorded while scrolling may lie within the current band selection. Items
+        // outside of it are added once the band grows to cover them.
+        if (mHasSelectionBounds
+                && mSelectionTop <= absoluteChildRect.top
+                && absoluteChildRect.top <= mSelectionBottom
+                && mSelectionLeft <= absoluteChildRect.left
+                && absoluteChildRect.left <= mSelectionRight) {
+            K key = mKeyProvider.getKey(adapterPosition);
+            if (key != null && canSelect(key)) {
+                mSelection.add(key);
+            }
         }
-        columnList.put(absoluteChildRect.top, adapterPosition);
     }
 
     /**
@@ -274,6 +316,7 @@ final class GridModel<K> {
             updateSelection(computeBounds());
         } else {
             mSelection.clear();
+            mHasSelectionBounds = false;
             mPositionNearestOrigin = NOT_SET;
         }
     }
@@ -298,12 +341,8 @@ final class GridModel<K> {
 
         checkArgument(columnStart >= 0, "Rect doesn't intesect any known column.");
 
-        int columnEnd = columnStart;
-
-        for (int i = columnStart; i < mColumnBounds.size()
-                && mColumnBounds.get(i).lowerLimit <= rect.right; i++) {
-            columnEnd = i;
-        }
+        int columnEnd =
+                Math.max(columnStart, lastIndexStartingAtOrBefore(mColumnBounds, rect.right));
 
         int rowStart = Collections.binarySearch(mRowBounds, new Limits(rect.top, rect.top));
         if (rowStart < 0) {
@@ -311,11 +350,7 @@ final class GridModel<K> {
             return;
         }
 
-        int rowEnd = rowStart;
-        for (int i = rowStart; i < mRowBounds.size()
-                && mRowBounds.get(i).lowerLimit <= rect.bottom; i++) {
-            rowEnd = i;
-        }
+        int rowEnd = Math.max(rowStart, lastIndexStartingAtOrBefore(mRowBounds, rect.bottom));
 
         updateSelection(columnStart, columnEnd, rowStart, rowEnd);
     }
@@ -333,31 +368,107 @@ final class GridModel<K> {
                     columnStartIndex, columnEndIndex, rowStartIndex, rowEndIndex));
         }
 
-        mSelection.clear();
-        for (int column = columnStartIndex; column <= columnEndIndex; column++) {
-            SparseIntArray items = mColumns.get(mColumnBounds.get(column).lowerLimit);
+        int left = mColumnBounds.get(columnStartIndex).lowerLimit;
+        int right = mColumnBounds.get(columnEndIndex).lowerLimit;
+        int top = mRowBounds.get(rowStartIndex).lowerLimit;
+        int bottom = mRowBounds.get(rowEndIndex).lowerLimit;
+
+        if (!mHasSelectionBounds) {
+            mSelection.clear();
+            // Visit items row by row, which is adapter order for vertical lists and grids, so
+            // range backed key sets only ever extend their last range.
             for (int row = rowStartIndex; row <= rowEndIndex; row++) {
-                // The default return value for SparseIntArray.get is 0, which is a valid
-                // position. Use a sentry value to prevent erroneously selecting item 0.
-                final int rowKey = mRowBounds.get(row).lowerLimit;
-                int position = items.get(rowKey, NOT_SET);
-                if (position != NOT_SET) {
-                    K key = mKeyProvider.getKey(position);
-                    if (key != null) {
-                        // The adapter inserts items for UI layout purposes that aren't
-                        // associated with files. Those will have a null model ID.
-                        // Don't select them.
-                        if (canSelect(key)) {
-                            mSelection.add(key);
-                        }
-                    }
-                    if (isPossiblePositionNearestOrigin(column, columnStartIndex, columnEndIndex,
-                            row, rowStartIndex, rowEndIndex)) {
-                        // If this is the position nearest the origin, record it now so that it
-                        // can be returned by endSelection() later.
-                        mPositionNearestOrigin = position;
-                    }
+                updateRow(row, EMPTY_LEFT, EMPTY_RIGHT, left, right);
+            }
+        } else if (left != mSelectionLeft || right != mSelectionRight
+                || top != mSelectionTop || bottom != mSelectionBottom) {
+            int oldRowStartIndex = Collections.binarySearch(
+                    mRowBounds, new Limits(mSelectionTop, mSelectionTop));
+            int oldRowEndIndex = Collections.binarySearch(
+                    mRowBounds, new Limits(mSelectionBottom, mSelectionBottom));
+            boolean sameColumns = left == mSelectionLeft && right == mSelectionRight;
+
+            int lastRow = Math.max(oldRowEndIndex, rowEndIndex);
+            for (int row = Math.min(oldRowStartIndex, rowStartIndex); row <= lastRow; row++) {
+                boolean wasCovered = oldRowStartIndex <= row && row <= oldRowEndIndex;
+                boolean isCovered = rowStartIndex <= row && row <= rowEndIndex;
+                if (wasCovered && isCovered && sameColumns) {
+                    // Skip the rows covered by both bands.
+                    row = Math.min(oldRowEndIndex, rowEndIndex);
+                    continue;
                 }
+                updateRow(row,
+                        wasCovered ? mSelectionLeft : EMPTY_LEFT,
+                        wasCovered ? mSelectionRight : EMPTY_RIGHT,
+                        isCovered ? left : EMPTY_LEFT,
+                        isCovered ? right : EMPTY_RIGHT);
+            }
+        }
+
+        mHasSelectionBounds = true;
+        mSelectionLeft = left;
+        mSelectionRight = right;
+        mSelectionTop = top;
+        mSelectionBottom = bottom;
+
+        updatePositionNearestOrigin(left, right, rowStartIndex, rowEndIndex);
+    }
+
+    /**
+     * Adds items of a row to or removes them from the selection, as the columns of the row
+     * covered by the band change from {@code [oldLeft, oldRight]} to {@code [newLeft, newRight]}.
+     * Ranges of columns are given as the lower limits of their first and last columns. Pass
+     * EMPTY_LEFT and EMPTY_RIGHT when the band doesn't cover the row.
+     */
+    private void updateRow(int rowIndex, int oldLeft, int oldRight, int newLeft, int newRight) {
+        SparseIntArray items = mRows.get(mRowBounds.get(rowIndex).lowerLimit);
+        int last = Math.max(oldRight, newRight);
+        for (int i = firstIndexAtOrAfter(items, Math.min(oldLeft, newLeft));
+                i < items.size() && items.keyAt(i) <= last; i++) {
+            int itemLeft = items.keyAt(i);
+            boolean wasSelected = oldLeft <= itemLeft && itemLeft <= oldRight;
+            boolean isSelected = newLeft <= itemLeft && itemLeft <= newRight;
+            if (wasSelected == isSelected) {
+                continue;
+            }
+            K key = mKeyProvider.getKey(items.valueAt(i));
+            if (key == null) {
+                // The adapter inserts items for UI layout purposes that aren't
+                // associated with files. Those will have a null model ID.
+                // Don't select them.
+                continue;
+            }
+            if (!isSelected) {
+                mSelection.remove(key);
+            } else if (canSelect(key)) {
+                mSelection.add(key);
+            }
+        }
+    }
+
+    /**
+     * Records the position of the item in the corner of the band nearest the origin, so that it
+     * can be returned by endSelection() later.
+     */
+    private void updatePositionNearestOrigin(
+            int left, int right, int rowStartIndex, int rowEndIndex) {
+        int corner = computeCornerNearestOrigin();
+        int rowIndex = (corner & LOWER) == LOWER ? rowEndIndex : rowStartIndex;
+        SparseIntArray items = mRows.get(mRowBounds.get(rowIndex).lowerLimit);
+
+        if (corner == LOWER_RIGHT) {
+            // Note that in some cases, the last row will not have as many items as there
+            // are columns (e.g., if there are 4 items and 3 columns, the second row will
+            // only have one item in the first column). So use the right-most item of the
+            // bottom row within the band.
+            int index = firstIndexAtOrAfter(items, right + 1) - 1;
+            if (index >= 0 && items.keyAt(index) >= left) {
+                mPositionNearestOrigin = items.valueAt(index);
+            }
+        } else {
+            int position = items.get((corner & RIGHT) == RIGHT ? right : left, NOT_SET);
+            if (position != NOT_SET) {
+                mPositionNearestOrigin = position;
             }
         }
     }
@@ -367,30 +478,30 @@ final class GridModel<K> {
     }
 
     /**
-     * @return Returns true if the position is the nearest to the origin, or, in the case of the
-     * lower-right corner, whether it is possible that the position is the nearest to the
-     * origin. See comment below for reasoning for this special case.
+     * @return index of the last limits in the sorted list whose lower limit is at most
+     * {@code value}, or -1 if there is none.
      */
-    private boolean isPossiblePositionNearestOrigin(int columnIndex, int columnStartIndex,
-            int columnEndIndex, int rowIndex, int rowStartIndex, int rowEndIndex) {
-        int corner = computeCornerNearestOrigin();
-        switch (corner) {
-            case UPPER_LEFT:
-                return columnIndex == columnStartIndex && rowIndex == rowStartIndex;
-            case UPPER_RIGHT:
-                return columnIndex == columnEndIndex && rowIndex == rowStartIndex;
-            case LOWER_LEFT:
-                return columnIndex == columnStartIndex && rowIndex == rowEndIndex;
-            case LOWER_RIGHT:
-                // Note that in some cases, the last row will not have as many items as there
-                // are columns (e.g., if there are 4 items and 3 columns, the second row will
-                // only have one item in the first column). This function is invoked for each
-                // position from left to right, so return true for any position in the bottom
-                // row and only the right-most position in the bottom row will be recorded.
-                return rowIndex == rowEndIndex;
-            default:
-                throw new RuntimeException("Invalid corner type.");
+    private static int lastIndexStartingAtOrBefore(List<Limits> limitsList, int value) {
+        int index = Collections.binarySearch(limitsList, new Limits(value, value));
+        return index >= 0 ? index : ~index - 1;
+    }
+
+    /**
+     * @return index of the first key of {@code items} which is at least {@code key}, or the
+     * size of {@code items} if there is none.
+     */
+    private static int firstIndexAtOrAfter(SparseIntArray items, int key) {
+        int lo = 0;
+        int hi = items.size();
+        while (lo < hi) {
+            int mid = (lo + hi) >>> 1;
+            if (items.keyAt(mid) < key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
         }
+        return lo;
     }
 
     /**
@@ -0,0 +1,333 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.recyclerview.selection;
+
+import static androidx.core.util.Preconditions.checkArgument;
+
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
+
+import java.util.AbstractSet;
+import java.util.Collection;
+import java.util.ConcurrentModificationException;
+import java.util.Iterator;
+import java.util.Map;
+import java.util.NoSuchElementException;
+import java.util.TreeMap;
+
+/**
+ * A {@link java.util.Set} of {@link Long} keys stored as sorted, disjoint ranges of
+ * consecutive values. Stable ids of adjacent items are usually consecutive, so selecting
+ * every item of a huge list (by select-all or by band) takes a handful of ranges rather than
+ * one boxed entry per item.
+ *
+ * <p>Ranges are kept in a {@link TreeMap} from their first to their last value, so lookups,
+ * and adding or removing a key, take logarithmic time in the number of ranges even when the
+ * keys are sparse and every key is a range of its own. Union and difference with another
+ * {@link LongRangeSet} add or remove the other set range by range, so merging provisional
+ * selections doesn't depend on the number of keys.
+ */
+final class LongRangeSet extends AbstractSet<Long> {
+
+    // First value of each range mapped to its last value, both inclusive. Ranges never
+    // overlap or touch.
+    private final TreeMap<Long, Long> mRanges;
+    // Number of values in all ranges, which may exceed the range of an int.
+    private long mSize;
+    private int mModCount;
+
+    LongRangeSet() {
+        mRanges = new TreeMap<>();
+    }
+
+    LongRangeSet(@NonNull LongRangeSet other) {
+        mRanges = new TreeMap<>(other.mRanges);
+        mSize = other.mSize;
+    }
+
+    @Override
+    public int size() {
+        return (int) Math.min(mSize, Integer.MAX_VALUE);
+    }
+
+    @Override
+    public boolean isEmpty() {
+        return mRanges.isEmpty();
+    }
+
+    /**
+     * @return the number of ranges needed to store the keys of this set.
+     */
+    int getRangeCount() {
+        return mRanges.size();
+    }
+
+    @Override
+    public boolean contains(@Nullable Object o) {
+        return (o instanceof Long) && contains((long) (Long) o);
+    }
+
+    boolean contains(long value) {
+        Map.Entry<Long, Long> range = mRanges.floorEntry(value);
+        return range != null && range.getValue() >= value;
+    }
+
+    @Override
+    public boolean add(@NonNull Long value) {
+        return addRange(value, value);
+    }
+
+    @Override
+    public boolean remove(@Nullable Object o) {
+        if (!(o instanceof Long)) {
+            return false;
+        }
+        long value = (Long) o;
+        return removeRange(value, value);
+    }
+
+    @Override
+    public void clear() {
+        mRanges.clear();
+        mSize = 0;
+        mModCount++;
+    }
+
+    /**
+     * Adds all values from {@code first} to {@code last}, inclusive.
+     *
+     * @return true if the set was modified.
+     */
+    boolean addRange(long first, long last) {
+        checkArgument(first <= last);
+
+        // Ranges never touch, so the added values are either all in one range or the set
+        // is modified.
+        Map.Entry<Long, Long> before = mRanges.floorEntry(first);
+        if (before != null && before.getValue() >= last) {
+            return false;
+        }
+
+        long start = first;
+        long end = last;
+        if (before != null && !endsBefore(before.getValue(), first)) {
+            start = before.getKey();
+        }
+        // Ranges from start up to the one touching last are joined with the added range.
+        Iterator<Map.Entry<Long, Long>> it = mRanges.tailMap(start, true).entrySet().iterator();
+        while (it.hasNext()) {
+            Map.Entry<Long, Long> range = it.next();
+            if (startsAfter(range.getKey(), last)) {
+                break;
+            }
+            end = Math.max(end, range.getValue());
+            mSize -= range.getValue() - range.getKey() + 1;
+            it.remove();
+        }
+        mRanges.put(start, end);
+        mSize += end - start + 1;
+        mModCount++;
+        return true;
+    }
+
+    /**
+     * Removes all values from {@code first} to {@code last}, inclusive.
+     *
+     * @return true if the set was modified.
+     */
+    boolean removeRange(long first, long last) {
+        checkArgument(first <= last);
+
+        Map.Entry<Long, Long> before = mRanges.floorEntry(first);
+        long from = before != null && before.getValue() >= first ? before.getKey() : first;
+
+        boolean modified = false;
+        boolean keepHead = false;
+        boolean keepTail = false;
+        long headStart = 0;
+        long tailEnd = 0;
+        // Ranges from the one holding first up to the one holding last overlap the
+        // removed range.
+        Iterator<Map.Entry<Long, Long>> it = mRanges.tailMap(from, true).entrySet().iterator();
+        while (it.hasNext()) {
+            Map.Entry<Long, Long> range = it.next();
+            long start = range.getKey();
+            long end = range.getValue();
+            if (start > last) {
+                break;
+            }
+            if (start < first) {
+                keepHead = true;
+                headStart = start;
+            }
+            if (end > last) {
+                keepTail = true;
+                tailEnd = end;
+            }
+            mSize -= Math.min(last, end) - Math.max(first, start) + 1;
+            it.remove();
+            modified = true;
+        }
+        if (!modified) {
+            return false;
+        }
+
+        if (keepHead) {
+            mRanges.put(headStart, first - 1);
+        }
+        if (keepTail) {
+            mRanges.put(last + 1, tailEnd);
+        }
+        mModCount++;
+        return true;
+    }
+
+    @Override
+    public boolean addAll(@NonNull Collection<? extends Long> c) {
+        if (!(c instanceof LongRangeSet)) {
+            return super.addAll(c);
+        }
+
+        LongRangeSet other = (LongRangeSet) c;
+        if (other == this) {
+            return false;
+        }
+        boolean modified = false;
+        for (Map.Entry<Long, Long> range : other.mRanges.entrySet()) {
+            modified |= addRange(range.getKey(), range.getValue());
+        }
+        return modified;
+    }
+
+    @Override
+    public boolean removeAll(@NonNull Collection<?> c) {
+        if (!(c instanceof LongRangeSet)) {
+            boolean modified = false;
+            for (Object o : c) {
+                modified |= remove(o);
+            }
+            return modified;
+        }
+
+        LongRangeSet other = (LongRangeSet) c;
+        if (other == this) {
+            boolean modified = !isEmpty();
+            clear();
+            return modified;
+        }
+        boolean modified = false;
+        for (Map.Entry<Long, Long> range : other.mRanges.entrySet()) {
+            if (isEmpty()) {
+                break;
+            }
+            modified |= removeRange(range.getKey(), range.getValue());
+        }
+        return modified;
+    }
+
+    @Override
+    public boolean equals(@Nullable Object o) {
+        if (!(o instanceof LongRangeSet)) {
+            return super.equals(o);
+        }
+        return mRanges.equals(((LongRangeSet) o).mRanges);
+    }
+
+    @Override
+    public int hashCode() {
+        // Must match the hash code of other sets holding the same values.
+        return super.hashCode();
+    }
+
+    @Override
+    public @NonNull Iterator<Long> iterator() {
+        return new RangeIterator();
+    }
+
+    /**
+     * @return true if a range ending at {@code end} can't be joined with {@code value}.
+     */
+    private static boolean endsBefore(long end, long value) {
+        return value != Long.MIN_VALUE && end < value - 1;
+    }
+
+    /**
+     * @return true if a range starting at {@code start} can't be joined with {@code value}.
+     */
+    private static boolean startsAfter(long start, long value) {
+        return value != Long.MAX_VALUE && start > value + 1;
+    }
+
+    private final class RangeIterator implements Iterator<Long> {
+        private boolean mHasNext;
+        private long mNext;
+        private long mRangeEnd;
+        private boolean mCanRemove;
+        private long mLast;
+        private int mExpectedModCount = mModCount;
+
+        RangeIterator() {
+            moveTo(mRanges.firstEntry());
+        }
+
+        @Override
+        public boolean hasNext() {
+            return mHasNext;
+        }
+
+        @Override
+        public Long next() {
+            if (mExpectedModCount != mModCount) {
+                throw new ConcurrentModificationException();
+            }
+            if (!hasNext()) {
+                throw new NoSuchElementException();
+            }
+            mLast = mNext;
+            mCanRemove = true;
+            if (mLast == mRangeEnd) {
+                moveTo(mRanges.higherEntry(mLast));
+            } else {
+                mNext = mLast + 1;
+            }
+            return mLast;
+        }
+
+        @Override
+        public void remove() {
+            if (!mCanRemove) {
+                throw new IllegalStateException();
+            }
+            if (mExpectedModCount != mModCount) {
+                throw new ConcurrentModificationException();
+            }
+            mCanRemove = false;
+            // Removing the last value only splits off the values before mNext, so the end of
+            // the range holding mNext doesn't change.
+            removeRange(mLast, mLast);
+            mExpectedModCount = mModCount;
+        }
+
+        private void moveTo(@Nullable Map.Entry<Long, Long> range) {
+            mHasNext = range != null;
+            if (mHasNext) {
+                mNext = range.getKey();
+                mRangeEnd = range.getValue();
+            }
+        }
+    }
+}
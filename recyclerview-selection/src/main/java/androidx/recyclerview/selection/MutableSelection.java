@@ -18,6 +18,8 @@ package androidx.recyclerview.selection;
 
 import androidx.annotation.NonNull;
 
+import java.util.Set;
+
 /**
  * Subclass of {@link Selection} exposing public support for mutating the underlying
  * selection data. This is useful for clients of {@link SelectionTracker} that wish to
@@ -54,6 +56,14 @@ import androidx.annotation.NonNull;
  */
 public final class MutableSelection<K> extends Selection<K> {
 
+    public MutableSelection() {
+        super();
+    }
+
+    MutableSelection(@NonNull Set<K> selection, @NonNull Set<K> provisionalSelection) {
+        super(selection, provisionalSelection);
+    }
+
     @Override
     public boolean add(@NonNull K key) {
         return super.add(key);
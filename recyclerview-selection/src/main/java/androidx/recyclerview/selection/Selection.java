@@ -77,6 +77,15 @@ public class Selection<K> implements Iterable<K> {
         mProvisionalSelection = new HashSet<>();
     }
 
+    /**
+     * Used by {@link DefaultSelectionTracker} to store keys in sets created by its
+     * {@link StorageStrategy}.
+     */
+    Selection(@NonNull Set<K> selection, @NonNull Set<K> provisionalSelection) {
+        mSelection = selection;
+        mProvisionalSelection = provisionalSelection;
+    }
+
     /**
      * @param key
      * @return true if the position is currently selected.
@@ -117,6 +126,12 @@ public class Selection<K> implements Iterable<K> {
      * @return Map of ids added or removed. Added ids have a value of true, removed are false.
      */
     Map<K, Boolean> setProvisionalSelection(@NonNull Set<K> newSelection) {
+        if (newSelection instanceof LongRangeSet
+                && mSelection instanceof LongRangeSet
+                && mProvisionalSelection instanceof LongRangeSet) {
+            return setProvisionalRanges(newSelection);
+        }
+
         Map<K, Boolean> delta = new HashMap<>();
 
         for (K key: mProvisionalSelection) {
@@ -158,6 +173,46 @@ public class Selection<K> implements Iterable<K> {
         return delta;
     }
 
+    /**
+     * Same as {@link #setProvisionalSelection(Set)} for keys stored in {@link LongRangeSet}s.
+     * Computes the changes as differences of ranges, so only keys that actually change state
+     * are visited, however many keys the selections hold.
+     */
+    @SuppressWarnings("unchecked")
+    private Map<K, Boolean> setProvisionalRanges(@NonNull Set<K> newSelection) {
+        LongRangeSet selection = (LongRangeSet) mSelection;
+        LongRangeSet provisional = (LongRangeSet) mProvisionalSelection;
+        LongRangeSet next = (LongRangeSet) newSelection;
+
+        LongRangeSet removedProvisional = new LongRangeSet(provisional);
+        removedProvisional.removeAll(next);
+        removedProvisional.removeAll(selection);
+
+        LongRangeSet removedPrimary = new LongRangeSet(selection);
+        removedPrimary.removeAll(next);
+
+        LongRangeSet added = new LongRangeSet(next);
+        added.removeAll(selection);
+        added.removeAll(provisional);
+
+        Map<K, Boolean> delta = new HashMap<>();
+        for (Long key : removedProvisional) {
+            delta.put((K) key, false);
+        }
+        for (Long key : removedPrimary) {
+            delta.put((K) key, false);
+        }
+        for (Long key : added) {
+            delta.put((K) key, true);
+        }
+
+        provisional.removeAll(removedProvisional);
+        provisional.removeAll(removedPrimary);
+        provisional.addAll(added);
+
+        return delta;
+    }
+
     /**
      * Saves the existing provisional selection. Once the provisional selection is saved,
      * subsequent provisional selections which are different from this existing one cannot
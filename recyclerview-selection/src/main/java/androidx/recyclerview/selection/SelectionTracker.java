@@ -795,6 +795,7 @@ public abstract class SelectionTracker<K> {
                         mKeyProvider,
                         tracker,
                         mSelectionPredicate,
+                        mStorage,
                         mBandPredicate,
                         mFocusDelegate,
                         mMonitor);
@@ -26,6 +26,8 @@ import androidx.annotation.Nullable;
 import androidx.annotation.VisibleForTesting;
 
 import java.util.ArrayList;
+import java.util.HashSet;
+import java.util.Set;
 
 /**
  * Strategy for storing keys in saved state. Extend this class when using custom
@@ -85,6 +87,13 @@ public abstract class StorageStrategy<K> {
         return mType.getCanonicalName();
     }
 
+    /**
+     * Creates an empty set suitable for holding selected keys of this strategy's type.
+     */
+    @NonNull Set<K> createKeySet() {
+        return new HashSet<>();
+    }
+
     /**
      * @return StorageStrategy suitable for use with {@link Parcelable} keys
      * (like {@link android.net.Uri}).
@@ -164,13 +173,22 @@ public abstract class StorageStrategy<K> {
                 return null;
             }
 
-            Selection<Long> selection = new Selection<>();
+            // Keys saved from a range backed selection are in ascending order, so each one
+            // extends the last range.
+            Selection<Long> selection = new Selection<>(createKeySet(), createKeySet());
             for (long key : stored) {
                 selection.mSelection.add(key);
             }
             return selection;
         }
 
+        @Override
+        @NonNull Set<Long> createKeySet() {
+            // Long keys are usually stable ids, which are consecutive for adjacent items and
+            // are stored as ranges rather than individually.
+            return new LongRangeSet();
+        }
+
         @Override
         public @NonNull Bundle asBundle(@NonNull Selection<Long> selection) {
 
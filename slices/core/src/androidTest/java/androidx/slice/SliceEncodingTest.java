@@ -0,0 +1,200 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.slice;
+
+import static android.app.slice.Slice.HINT_LIST;
+import static android.app.slice.Slice.HINT_LIST_ITEM;
+import static android.app.slice.Slice.HINT_TITLE;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertSame;
+import static org.junit.Assert.assertTrue;
+
+import android.app.PendingIntent;
+import android.content.Context;
+import android.content.Intent;
+import android.net.Uri;
+import android.os.Bundle;
+import android.os.Parcel;
+import android.os.Parcelable;
+import android.os.SystemClock;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.LargeTest;
+import android.support.test.filters.SmallTest;
+import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
+
+import androidx.core.graphics.drawable.IconCompat;
+import androidx.slice.compat.SliceProviderCompat;
+import androidx.slice.core.test.R;
+
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+@RunWith(AndroidJUnit4.class)
+public class SliceEncodingTest {
+    private static final String TAG = "SliceEncodingTest";
+    private static final Uri BASE_URI = Uri.parse("content://androidx.slice.core.test/");
+
+    private final Context mContext = InstrumentationRegistry.getContext();
+
+    private Slice createListSlice(int rowCount) {
+        PendingIntent pi = PendingIntent.getBroadcast(mContext, 0,
+                new Intent(mContext.getPackageName() + ".action"), 0);
+        IconCompat icon = IconCompat.createWithResource(mContext, R.drawable.size_48x48);
+        Slice.Builder builder = new Slice.Builder(BASE_URI)
+                .setSpec(new SliceSpec("androidx.slice.LIST", 1))
+                .addHints(HINT_LIST);
+        for (int i = 0; i < rowCount; i++) {
+            Slice.Builder row = new Slice.Builder(builder).addHints(HINT_LIST_ITEM);
+            row.addText("Title " + i, null, HINT_TITLE);
+            row.addText("Subtitle " + i, "subtitle");
+            row.addIcon(icon, null);
+            row.addInt(i, "color");
+            row.addTimestamp(i * 1000L, null);
+            row.addAction(pi, new Slice.Builder(row).addHints(HINT_TITLE).build(), "action");
+            builder.addSubSlice(row.build());
+        }
+        return builder.build();
+    }
+
+    private static Bundle parcelAndRead(Bundle bundle) {
+        Parcel parcel = Parcel.obtain();
+        try {
+            parcel.writeBundle(bundle);
+            parcel.setDataPosition(0);
+            // The receiving app can't load classes of this library from the Bundle.
+            return parcel.readBundle(null);
+        } finally {
+            parcel.recycle();
+        }
+    }
+
+    private static Slice parcelAndRead(Slice slice) {
+        return SliceEncoding.decode(
+                parcelAndRead(SliceEncoding.encode(slice, SliceEncoding.VERSION)));
+    }
+
+    @SmallTest
+    @Test
+    public void testRoundTrip() {
+        Slice slice = createListSlice(3);
+        Slice read = parcelAndRead(slice);
+
+        assertEquals(slice.toString(), read.toString());
+        assertEquals(slice.getUri(), read.getUri());
+        assertEquals(slice.getSpec(), read.getSpec());
+        assertEquals(slice.getHints(), read.getHints());
+        SliceItem action = read.getItems().get(0).getSlice().getItems().get(5);
+        assertEquals(android.app.slice.SliceItem.FORMAT_ACTION, action.getFormat());
+        assertEquals(slice.getItems().get(0).getSlice().getItems().get(5).getAction(),
+                action.getAction());
+        assertEquals(R.drawable.size_48x48,
+                read.getItems().get(1).getSlice().getItems().get(2).getIcon().getResId());
+
+        // Hints are read from the string table, so equal hints are the same instance
+        assertSame(read.getItems().get(0).getSlice().getItems().get(0).getHints().get(0),
+                read.getItems().get(1).getSlice().getItems().get(0).getHints().get(0));
+    }
+
+    @SmallTest
+    @Test
+    public void testWriteSlice_UsesVersionSupportedByBothSides() {
+        Slice slice = createListSlice(1);
+        Bundle extras = new Bundle();
+        Bundle bundle = SliceProviderCompat.writeSlice(slice, extras);
+        assertFalse(SliceEncoding.isEncoded(bundle));
+        assertEquals(slice.toString(), new Slice(bundle).toString());
+
+        // Callers that support a newer encoding get the newest one known here.
+        extras.putInt(SliceProviderCompat.EXTRA_SLICE_ENCODING, SliceEncoding.VERSION + 1);
+        bundle = SliceProviderCompat.writeSlice(slice, extras);
+        assertTrue(SliceEncoding.isEncoded(bundle));
+        assertEquals(slice.toString(), SliceEncoding.decode(parcelAndRead(bundle)).toString());
+    }
+
+    @SmallTest
+    @Test(expected = IllegalArgumentException.class)
+    public void testDecode_RejectsNewerVersion() {
+        Bundle bundle = SliceEncoding.encode(createListSlice(1), SliceEncoding.VERSION);
+        bundle.putInt("androidx.slice.encoding.VERSION", SliceEncoding.VERSION + 1);
+        SliceEncoding.decode(bundle);
+    }
+
+    @SmallTest
+    @Test(expected = IllegalArgumentException.class)
+    public void testDecode_RejectsInvalidCount() {
+        Bundle bundle = SliceEncoding.encode(createListSlice(1), SliceEncoding.VERSION);
+        Parcel parcel = Parcel.obtain();
+        try {
+            // A string table larger than the data.
+            parcel.writeInt(Integer.MAX_VALUE);
+            bundle.putByteArray("androidx.slice.encoding.DATA", parcel.marshall());
+        } finally {
+            parcel.recycle();
+        }
+        SliceEncoding.decode(bundle);
+    }
+
+    @SmallTest
+    @Test(expected = IllegalArgumentException.class)
+    public void testDecode_RejectsInvalidIndex() {
+        Bundle bundle = SliceEncoding.encode(createListSlice(1), SliceEncoding.VERSION);
+        // No objects are sent, so the index of the icon is out of bounds.
+        bundle.putParcelableArray("androidx.slice.encoding.OBJECTS", new Parcelable[0]);
+        SliceEncoding.decode(bundle);
+    }
+
+    /**
+     * Compares the time and size of marshalling a large list slice with
+     * {@link Slice#toBundle()} and with {@link SliceEncoding}.
+     */
+    @LargeTest
+    @Test
+    public void testMarshallingBenchmark() {
+        final int iterations = 20;
+        Slice slice = createListSlice(300);
+        long bundleTime = 0;
+        long binaryTime = 0;
+        int bundleSize = 0;
+        int binarySize = 0;
+        for (int i = 0; i < iterations; i++) {
+            Parcel parcel = Parcel.obtain();
+            long start = SystemClock.elapsedRealtime();
+            parcel.writeBundle(slice.toBundle());
+            bundleSize = parcel.dataSize();
+            parcel.setDataPosition(0);
+            Bundle bundle = parcel.readBundle(getClass().getClassLoader());
+            new Slice(bundle);
+            bundleTime += SystemClock.elapsedRealtime() - start;
+            parcel.recycle();
+
+            parcel = Parcel.obtain();
+            start = SystemClock.elapsedRealtime();
+            parcel.writeBundle(SliceEncoding.encode(slice, SliceEncoding.VERSION));
+            binarySize = parcel.dataSize();
+            parcel.setDataPosition(0);
+            SliceEncoding.decode(parcel.readBundle(null));
+            binaryTime += SystemClock.elapsedRealtime() - start;
+            parcel.recycle();
+        }
+        Log.d(TAG, "Bundle: " + (bundleTime / iterations) + "ms, " + bundleSize + " bytes");
+        Log.d(TAG, "Binary: " + (binaryTime / iterations) + "ms, " + binarySize + " bytes");
+        assertTrue(binarySize < bundleSize);
+    }
+}
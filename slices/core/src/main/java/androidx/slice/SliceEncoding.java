@@ -0,0 +1,358 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.slice;
+
+import static android.app.slice.SliceItem.FORMAT_ACTION;
+import static android.app.slice.SliceItem.FORMAT_IMAGE;
+import static android.app.slice.SliceItem.FORMAT_INT;
+import static android.app.slice.SliceItem.FORMAT_LONG;
+import static android.app.slice.SliceItem.FORMAT_REMOTE_INPUT;
+import static android.app.slice.SliceItem.FORMAT_SLICE;
+import static android.app.slice.SliceItem.FORMAT_TEXT;
+import static android.app.slice.SliceItem.FORMAT_TIMESTAMP;
+
+import android.app.PendingIntent;
+import android.net.Uri;
+import android.os.Bundle;
+import android.os.Parcel;
+import android.os.Parcelable;
+import android.text.TextUtils;
+
+import androidx.annotation.NonNull;
+import androidx.annotation.RestrictTo;
+import androidx.annotation.RestrictTo.Scope;
+import androidx.collection.ArrayMap;
+import androidx.core.graphics.drawable.IconCompat;
+
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Compact binary form of a {@link Slice}, used instead of {@link Slice#toBundle()} when sending
+ * slices between processes.
+ * <p>
+ * The tree is marshalled into a byte array instead of being converted to nested Bundles first.
+ * Hints, formats, sub types and spec types are written once in a string table and referenced by
+ * index, and items are written depth first without any keys. Actions, remote inputs and icons
+ * may hold binders or file descriptors, which can't be marshalled, so they are sent next to the
+ * bytes in an array of framework parcelables and referenced by index.
+ * <p>
+ * The encoded Bundle only holds framework types, as the receiving app has its own copy of this
+ * library, which may be repackaged or obfuscated. The encoding is versioned: the sender encodes
+ * at the highest version that the receiver advertised, and the receiver reads any version up to
+ * {@link #VERSION}.
+ *
+ * @hide
+ */
+@RestrictTo(Scope.LIBRARY)
+public final class SliceEncoding {
+
+    /**
+     * Version of the encoding written by this class.
+     */
+    public static final int VERSION = 1;
+
+    private static final String KEY_VERSION = "androidx.slice.encoding.VERSION";
+    private static final String KEY_DATA = "androidx.slice.encoding.DATA";
+    private static final String KEY_OBJECTS = "androidx.slice.encoding.OBJECTS";
+
+    private static final int NO_INDEX = -1;
+    // Smallest number of bytes taken by an element of a list, which is an int.
+    private static final int MIN_ELEMENT_SIZE = 4;
+
+    private SliceEncoding() {
+    }
+
+    /**
+     * @return Whether the bundle was created by {@link #encode}, rather than
+     * {@link Slice#toBundle()}.
+     */
+    public static boolean isEncoded(@NonNull Bundle bundle) {
+        return bundle.containsKey(KEY_VERSION);
+    }
+
+    /**
+     * Encodes the slice at the given version, which must be at most {@link #VERSION}.
+     */
+    public static @NonNull Bundle encode(@NonNull Slice slice, int version) {
+        if (version < 1 || version > VERSION) {
+            throw new IllegalArgumentException("Unsupported slice encoding " + version);
+        }
+        ArrayMap<String, Integer> strings = new ArrayMap<>();
+        collectStrings(slice, strings);
+        ArrayMap<Object, Integer> objectIndices = new ArrayMap<>();
+        ArrayList<Parcelable> objects = new ArrayList<>();
+        Parcel parcel = Parcel.obtain();
+        try {
+            // ArrayMap is ordered by hash, so write the table in the order of the indices.
+            String[] table = new String[strings.size()];
+            for (int i = 0; i < table.length; i++) {
+                table[strings.valueAt(i)] = strings.keyAt(i);
+            }
+            parcel.writeInt(table.length);
+            for (int i = 0; i < table.length; i++) {
+                parcel.writeString(table[i]);
+            }
+            writeSlice(parcel, slice, strings, objectIndices, objects);
+
+            Bundle bundle = new Bundle();
+            bundle.putInt(KEY_VERSION, version);
+            bundle.putByteArray(KEY_DATA, parcel.marshall());
+            bundle.putParcelableArray(KEY_OBJECTS, objects.toArray(new Parcelable[0]));
+            return bundle;
+        } finally {
+            parcel.recycle();
+        }
+    }
+
+    /**
+     * Decodes a slice encoded at any version up to {@link #VERSION}.
+     *
+     * @throws IllegalArgumentException if the bundle isn't a valid encoding. Other runtime
+     * exceptions may be thrown by the framework types read from a corrupted encoding.
+     */
+    public static @NonNull Slice decode(@NonNull Bundle bundle) {
+        int version = bundle.getInt(KEY_VERSION);
+        if (version < 1 || version > VERSION) {
+            throw new IllegalArgumentException("Unsupported slice encoding " + version);
+        }
+        byte[] data = bundle.getByteArray(KEY_DATA);
+        Parcelable[] parcelables = bundle.getParcelableArray(KEY_OBJECTS);
+        if (data == null || parcelables == null) {
+            throw new IllegalArgumentException("Missing slice encoding data");
+        }
+        // Icons are sent as Bundles, and shared by all the items that reference them.
+        Object[] objects = new Object[parcelables.length];
+        for (int i = 0; i < objects.length; i++) {
+            objects[i] = parcelables[i] instanceof Bundle
+                    ? IconCompat.createFromBundle((Bundle) parcelables[i]) : parcelables[i];
+        }
+        Parcel parcel = Parcel.obtain();
+        try {
+            parcel.unmarshall(data, 0, data.length);
+            parcel.setDataPosition(0);
+            String[] strings = new String[readCount(parcel)];
+            for (int i = 0; i < strings.length; i++) {
+                strings[i] = parcel.readString();
+            }
+            return readSlice(parcel, strings, objects);
+        } finally {
+            parcel.recycle();
+        }
+    }
+
+    private static void collectStrings(Slice slice, ArrayMap<String, Integer> strings) {
+        if (slice.getSpec() != null) {
+            addString(slice.getSpec().getType(), strings);
+        }
+        addStrings(slice.getHints(), strings);
+        List<SliceItem> items = slice.getItems();
+        for (int i = 0; i < items.size(); i++) {
+            SliceItem item = items.get(i);
+            addString(item.getFormat(), strings);
+            addString(item.getSubType(), strings);
+            addStrings(item.getHints(), strings);
+            if (FORMAT_SLICE.equals(item.getFormat()) || FORMAT_ACTION.equals(item.getFormat())) {
+                collectStrings(item.getSlice(), strings);
+            }
+        }
+    }
+
+    private static void addStrings(List<String> values, ArrayMap<String, Integer> strings) {
+        for (int i = 0; i < values.size(); i++) {
+            addString(values.get(i), strings);
+        }
+    }
+
+    private static void addString(String value, ArrayMap<String, Integer> strings) {
+        if (value != null && !strings.containsKey(value)) {
+            strings.put(value, strings.size());
+        }
+    }
+
+    private static void writeString(Parcel dest, String value,
+            ArrayMap<String, Integer> strings) {
+        dest.writeInt(value != null ? strings.get(value) : NO_INDEX);
+    }
+
+    private static void writeHints(Parcel dest, List<String> hints,
+            ArrayMap<String, Integer> strings) {
+        dest.writeInt(hints.size());
+        for (int i = 0; i < hints.size(); i++) {
+            writeString(dest, hints.get(i), strings);
+        }
+    }
+
+    /**
+     * Writes the index of an object in the array sent next to the bytes, adding it to the array
+     * if it isn't there yet.
+     */
+    private static void writeObject(Parcel dest, Object value,
+            ArrayMap<Object, Integer> objectIndices, ArrayList<Parcelable> objects) {
+        if (value == null) {
+            dest.writeInt(NO_INDEX);
+            return;
+        }
+        Integer index = objectIndices.get(value);
+        if (index == null) {
+            index = objects.size();
+            objectIndices.put(value, index);
+            objects.add(value instanceof IconCompat
+                    ? ((IconCompat) value).toBundle() : (Parcelable) value);
+        }
+        dest.writeInt(index);
+    }
+
+    private static void writeSlice(Parcel dest, Slice slice, ArrayMap<String, Integer> strings,
+            ArrayMap<Object, Integer> objectIndices, ArrayList<Parcelable> objects) {
+        Uri.writeToParcel(dest, slice.getUri());
+        SliceSpec spec = slice.getSpec();
+        writeString(dest, spec != null ? spec.getType() : null, strings);
+        if (spec != null) {
+            dest.writeInt(spec.getRevision());
+        }
+        writeHints(dest, slice.getHints(), strings);
+        List<SliceItem> items = slice.getItems();
+        dest.writeInt(items.size());
+        for (int i = 0; i < items.size(); i++) {
+            writeItem(dest, items.get(i), strings, objectIndices, objects);
+        }
+    }
+
+    @SuppressWarnings("NewApi") // Remote input items only exist on API 20 and above.
+    private static void writeItem(Parcel dest, SliceItem item, ArrayMap<String, Integer> strings,
+            ArrayMap<Object, Integer> objectIndices, ArrayList<Parcelable> objects) {
+        final String format = item.getFormat();
+        writeString(dest, format, strings);
+        writeString(dest, item.getSubType(), strings);
+        writeHints(dest, item.getHints(), strings);
+        switch (format) {
+            case FORMAT_IMAGE:
+                writeObject(dest, item.getIcon(), objectIndices, objects);
+                break;
+            case FORMAT_REMOTE_INPUT:
+                writeObject(dest, item.getRemoteInput(), objectIndices, objects);
+                break;
+            case FORMAT_SLICE:
+                writeSlice(dest, item.getSlice(), strings, objectIndices, objects);
+                break;
+            case FORMAT_ACTION:
+                writeObject(dest, item.getAction(), objectIndices, objects);
+                writeSlice(dest, item.getSlice(), strings, objectIndices, objects);
+                break;
+            case FORMAT_TEXT:
+                TextUtils.writeToParcel(item.getText(), dest, 0);
+                break;
+            case FORMAT_INT:
+                dest.writeInt(item.getInt());
+                break;
+            case FORMAT_TIMESTAMP:
+            case FORMAT_LONG:
+                dest.writeLong(item.getLong());
+                break;
+            default:
+                throw new IllegalArgumentException("Unsupported type " + format);
+        }
+    }
+
+    /**
+     * Reads the size of a list, which can't be larger than the number of elements that the
+     * rest of the data can hold.
+     */
+    private static int readCount(Parcel in) {
+        int count = in.readInt();
+        if (count < 0 || count > in.dataAvail() / MIN_ELEMENT_SIZE) {
+            throw new IllegalArgumentException("Invalid count " + count);
+        }
+        return count;
+    }
+
+    private static String[] readHints(Parcel in, String[] strings) {
+        String[] hints = new String[readCount(in)];
+        for (int i = 0; i < hints.length; i++) {
+            hints[i] = readString(in, strings);
+        }
+        return hints;
+    }
+
+    private static String readString(Parcel in, String[] strings) {
+        int index = readIndex(in, strings.length);
+        return index != NO_INDEX ? strings[index] : null;
+    }
+
+    private static Object readObject(Parcel in, Object[] objects) {
+        int index = readIndex(in, objects.length);
+        return index != NO_INDEX ? objects[index] : null;
+    }
+
+    private static int readIndex(Parcel in, int length) {
+        int index = in.readInt();
+        if (index < NO_INDEX || index >= length) {
+            throw new IllegalArgumentException("Invalid index " + index);
+        }
+        return index;
+    }
+
+    private static Slice readSlice(Parcel in, String[] strings, Object[] objects) {
+        Uri uri = Uri.CREATOR.createFromParcel(in);
+        String specType = readString(in, strings);
+        SliceSpec spec = specType != null ? new SliceSpec(specType, in.readInt()) : null;
+        String[] hints = readHints(in, strings);
+        int count = readCount(in);
+        ArrayList<SliceItem> items = new ArrayList<>(count);
+        for (int i = 0; i < count; i++) {
+            items.add(readItem(in, strings, objects));
+        }
+        return new Slice(items, hints, uri, spec);
+    }
+
+    private static SliceItem readItem(Parcel in, String[] strings, Object[] objects) {
+        String format = readString(in, strings);
+        String subType = readString(in, strings);
+        String[] hints = readHints(in, strings);
+        if (format == null) {
+            throw new IllegalArgumentException("Missing item format");
+        }
+        final Object obj;
+        switch (format) {
+            case FORMAT_IMAGE:
+            case FORMAT_REMOTE_INPUT:
+                obj = readObject(in, objects);
+                break;
+            case FORMAT_SLICE:
+                obj = readSlice(in, strings, objects);
+                break;
+            case FORMAT_ACTION:
+                PendingIntent action = (PendingIntent) readObject(in, objects);
+                return new SliceItem(action, readSlice(in, strings, objects), format, subType,
+                        hints);
+            case FORMAT_TEXT:
+                obj = TextUtils.CHAR_SEQUENCE_CREATOR.createFromParcel(in);
+                break;
+            case FORMAT_INT:
+                obj = in.readInt();
+                break;
+            case FORMAT_TIMESTAMP:
+            case FORMAT_LONG:
+                obj = in.readLong();
+                break;
+            default:
+                throw new IllegalArgumentException("Unsupported type " + format);
+        }
+        return new SliceItem(obj, format, subType, hints);
+    }
+}
@@ -34,6 +34,7 @@ import static androidx.slice.compat.SliceProviderCompat.METHOD_SLICE;
 import static androidx.slice.compat.SliceProviderCompat.METHOD_UNPIN;
 import static androidx.slice.compat.SliceProviderCompat.addSpecs;
 import static androidx.slice.compat.SliceProviderCompat.getSpecs;
+import static androidx.slice.compat.SliceProviderCompat.writeSlice;
 import static androidx.slice.core.SliceHints.HINT_PERMISSION_REQUEST;
 
 import android.app.PendingIntent;
@@ -179,7 +180,7 @@ public abstract class SliceProvider extends ContentProvider implements
 
             Slice s = handleBindSlice(uri, specs, getCallingPackage());
             Bundle b = new Bundle();
-            b.putParcelable(EXTRA_SLICE, s.toBundle());
+            b.putParcelable(EXTRA_SLICE, writeSlice(s, extras));
             return b;
         } else if (method.equals(METHOD_MAP_INTENT)) {
             Intent intent = extras.getParcelable(EXTRA_INTENT);
@@ -188,7 +189,7 @@ public abstract class SliceProvider extends ContentProvider implements
             if (uri != null) {
                 Set<SliceSpec> specs = getSpecs(extras);
                 Slice s = handleBindSlice(uri, specs, getCallingPackage());
-                b.putParcelable(EXTRA_SLICE, s.toBundle());
+                b.putParcelable(EXTRA_SLICE, writeSlice(s, extras));
             } else {
                 b.putParcelable(EXTRA_SLICE, null);
             }
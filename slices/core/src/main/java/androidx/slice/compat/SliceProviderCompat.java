@@ -36,6 +36,7 @@ import androidx.annotation.RestrictTo.Scope;
 import androidx.collection.ArraySet;
 import androidx.core.util.Preconditions;
 import androidx.slice.Slice;
+import androidx.slice.SliceEncoding;
 import androidx.slice.SliceSpec;
 import androidx.slice.core.SliceHints;
 
@@ -68,6 +69,7 @@ public class SliceProviderCompat {
     public static final String EXTRA_PKG = "pkg";
     public static final String EXTRA_PROVIDER_PKG = "provider_pkg";
     public static final String EXTRA_SLICE_DESCENDANTS = "slice_descendants";
+    public static final String EXTRA_SLICE_ENCODING = "slice_encoding";
 
     /**
      * Compat version of {@link Slice#bindSlice}.
@@ -83,15 +85,9 @@ public class SliceProviderCompat {
             Bundle extras = new Bundle();
             extras.putParcelable(EXTRA_BIND_URI, uri);
             addSpecs(extras, supportedSpecs);
+            extras.putInt(EXTRA_SLICE_ENCODING, SliceEncoding.VERSION);
             final Bundle res = provider.call(METHOD_SLICE, null, extras);
-            if (res == null) {
-                return null;
-            }
-            Parcelable bundle = res.getParcelable(EXTRA_SLICE);
-            if (!(bundle instanceof Bundle)) {
-                return null;
-            }
-            return new Slice((Bundle) bundle);
+            return readSlice(res);
         } catch (RemoteException e) {
             // Arbitrary and not worth documenting, as Activity
             // Manager will kill this process shortly anyway.
@@ -105,6 +101,41 @@ public class SliceProviderCompat {
         }
     }
 
+    private static Slice readSlice(Bundle res) {
+        if (res == null) {
+            return null;
+        }
+        Parcelable bundle = res.getParcelable(EXTRA_SLICE);
+        if (!(bundle instanceof Bundle)) {
+            return null;
+        }
+        try {
+            if (SliceEncoding.isEncoded((Bundle) bundle)) {
+                return SliceEncoding.decode((Bundle) bundle);
+            }
+            // Providers using an older version of the library only send Slice#toBundle().
+            return new Slice((Bundle) bundle);
+        } catch (RuntimeException e) {
+            // The provider sent a slice that can't be read, which is handled like a failed bind.
+            Log.w(TAG, "Unable to read slice", e);
+            return null;
+        }
+    }
+
+    /**
+     * Returns the form in which a slice should be sent to the caller that made the given
+     * request: encoded with {@link SliceEncoding} at the highest version that both sides
+     * support, or {@link Slice#toBundle()} if the caller doesn't support any.
+     */
+    public static Bundle writeSlice(Slice slice, Bundle extras) {
+        final int version = Math.min(extras.getInt(EXTRA_SLICE_ENCODING, 0),
+                SliceEncoding.VERSION);
+        if (version > 0) {
+            return SliceEncoding.encode(slice, version);
+        }
+        return slice.toBundle();
+    }
+
     /**
      * Compat way to push specs through the call.
      */
@@ -161,15 +192,9 @@ public class SliceProviderCompat {
             Bundle extras = new Bundle();
             extras.putParcelable(EXTRA_INTENT, intent);
             addSpecs(extras, supportedSpecs);
+            extras.putInt(EXTRA_SLICE_ENCODING, SliceEncoding.VERSION);
             final Bundle res = provider.call(METHOD_MAP_INTENT, null, extras);
-            if (res == null) {
-                return null;
-            }
-            Parcelable bundle = res.getParcelable(EXTRA_SLICE);
-            if (!(bundle instanceof Bundle)) {
-                return null;
-            }
-            return new Slice((Bundle) bundle);
+            return readSlice(res);
         } catch (RemoteException e) {
             // Arbitrary and not worth documenting, as Activity
             // Manager will kill this process shortly anyway.
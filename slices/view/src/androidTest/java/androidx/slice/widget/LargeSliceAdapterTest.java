@@ -0,0 +1,189 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.slice.widget;
+
+import static android.app.slice.Slice.HINT_LIST_ITEM;
+import static android.app.slice.Slice.HINT_TITLE;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNotEquals;
+
+import android.content.Context;
+import android.net.Uri;
+import android.os.SystemClock;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.LargeTest;
+import android.support.test.filters.SmallTest;
+import android.support.test.runner.AndroidJUnit4;
+import android.util.Log;
+
+import androidx.recyclerview.widget.RecyclerView;
+import androidx.slice.Slice;
+import androidx.slice.SliceItem;
+
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.List;
+
+@RunWith(AndroidJUnit4.class)
+public class LargeSliceAdapterTest {
+    private static final String TAG = "LargeSliceAdapterTest";
+    private static final Uri BASE_URI = Uri.parse("content://androidx.slice.view.test/");
+
+    private final Context mContext = InstrumentationRegistry.getContext();
+    private LargeSliceAdapter mAdapter;
+    private final Changes mChanges = new Changes();
+
+    static class Changes extends RecyclerView.AdapterDataObserver {
+        int mDataSetChanged;
+        int mItemsChanged;
+        int mItemsInserted;
+        int mItemsRemoved;
+
+        void reset() {
+            mDataSetChanged = 0;
+            mItemsChanged = 0;
+            mItemsInserted = 0;
+            mItemsRemoved = 0;
+        }
+
+        @Override
+        public void onChanged() {
+            mDataSetChanged++;
+        }
+
+        @Override
+        public void onItemRangeChanged(int positionStart, int itemCount) {
+            mItemsChanged += itemCount;
+        }
+
+        @Override
+        public void onItemRangeChanged(int positionStart, int itemCount, Object payload) {
+            mItemsChanged += itemCount;
+        }
+
+        @Override
+        public void onItemRangeInserted(int positionStart, int itemCount) {
+            mItemsInserted += itemCount;
+        }
+
+        @Override
+        public void onItemRangeRemoved(int positionStart, int itemCount) {
+            mItemsRemoved += itemCount;
+        }
+    }
+
+    @Before
+    public void setUp() {
+        mAdapter = new LargeSliceAdapter(mContext);
+        mAdapter.registerAdapterDataObserver(mChanges);
+    }
+
+    /**
+     * Creates the rows of a list slice, where row {@code changedRow} has a different subtitle
+     * for each {@code version}.
+     */
+    private List<SliceItem> createRows(int rowCount, int changedRow, int version) {
+        Slice.Builder builder = new Slice.Builder(BASE_URI);
+        builder.addSubSlice(new Slice.Builder(builder)
+                .addText("Header", null, HINT_TITLE).build());
+        for (int i = 1; i < rowCount; i++) {
+            Slice.Builder row = new Slice.Builder(builder).addHints(HINT_LIST_ITEM);
+            row.addText("Title " + i, null, HINT_TITLE);
+            row.addText("Subtitle " + i + (i == changedRow ? " v" + version : ""), null);
+            row.addInt(i, null);
+            builder.addSubSlice(row.build());
+        }
+        return builder.build().getItems();
+    }
+
+    @SmallTest
+    @Test
+    public void testUnchangedUpdateDoesNotRebind() {
+        mAdapter.setSliceItems(createRows(10, -1, 0), 0);
+        assertEquals(1, mChanges.mDataSetChanged);
+        long id = mAdapter.getItemId(3);
+
+        mChanges.reset();
+        mAdapter.setSliceItems(createRows(10, -1, 0), 0);
+        assertEquals(0, mChanges.mDataSetChanged);
+        assertEquals(0, mChanges.mItemsChanged);
+        assertEquals(id, mAdapter.getItemId(3));
+    }
+
+    @SmallTest
+    @Test
+    public void testSingleRowUpdate() {
+        mAdapter.setSliceItems(createRows(10, 4, 0), 0);
+        long id = mAdapter.getItemId(4);
+
+        mChanges.reset();
+        mAdapter.setSliceItems(createRows(10, 4, 1), 0);
+        assertEquals(0, mChanges.mDataSetChanged);
+        assertEquals(1, mChanges.mItemsChanged);
+        assertEquals(id, mAdapter.getItemId(4));
+    }
+
+    @SmallTest
+    @Test
+    public void testInsertedRow() {
+        mAdapter.setSliceItems(createRows(10, -1, 0), 0);
+        long id = mAdapter.getItemId(9);
+        mChanges.reset();
+        mAdapter.setSliceItems(createRows(11, -1, 0), 0);
+        assertEquals(0, mChanges.mDataSetChanged);
+        assertEquals(1, mChanges.mItemsInserted);
+        assertEquals(id, mAdapter.getItemId(9));
+        assertNotEquals(mAdapter.getItemId(9), mAdapter.getItemId(10));
+    }
+
+    @SmallTest
+    @Test
+    public void testColorChangeRebindsAll() {
+        mAdapter.setSliceItems(createRows(10, -1, 0), 0);
+        mChanges.reset();
+        mAdapter.setSliceItems(createRows(10, -1, 0), 1);
+        assertEquals(1, mChanges.mDataSetChanged);
+    }
+
+    /**
+     * Measures the cost of updating a 200 row slice where one row changes with each update, as
+     * a slice refreshing one row per second would.
+     */
+    @LargeTest
+    @Test
+    public void testSingleRowUpdateBenchmark() {
+        final int rowCount = 200;
+        final int updates = 60;
+        mAdapter.setSliceItems(createRows(rowCount, 1, 0), 0);
+        mChanges.reset();
+        long totalTime = 0;
+        for (int i = 1; i <= updates; i++) {
+            List<SliceItem> rows = createRows(rowCount, 1 + i % (rowCount - 1), i);
+            long start = SystemClock.elapsedRealtime();
+            mAdapter.setSliceItems(rows, 0);
+            totalTime += SystemClock.elapsedRealtime() - start;
+        }
+        Log.d(TAG, updates + " updates of " + rowCount + " rows: " + (totalTime / updates)
+                + "ms per update, " + mChanges.mItemsChanged + " rows rebound");
+        assertEquals(0, mChanges.mDataSetChanged);
+        // Each update changes the row it updates and restores the previous one.
+        assertEquals(2 * updates, mChanges.mItemsChanged);
+    }
+}
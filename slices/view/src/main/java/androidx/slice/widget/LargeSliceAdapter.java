@@ -19,13 +19,21 @@ package androidx.slice.widget;
 import static android.app.slice.Slice.HINT_HORIZONTAL;
 import static android.app.slice.Slice.SUBTYPE_MESSAGE;
 import static android.app.slice.Slice.SUBTYPE_SOURCE;
+import static android.app.slice.SliceItem.FORMAT_ACTION;
+import static android.app.slice.SliceItem.FORMAT_IMAGE;
 import static android.app.slice.SliceItem.FORMAT_INT;
+import static android.app.slice.SliceItem.FORMAT_LONG;
+import static android.app.slice.SliceItem.FORMAT_SLICE;
 import static android.app.slice.SliceItem.FORMAT_TEXT;
+import static android.app.slice.SliceItem.FORMAT_TIMESTAMP;
 
 import static androidx.slice.widget.SliceView.MODE_LARGE;
 
 import android.app.slice.Slice;
 import android.content.Context;
+import android.net.Uri;
+import android.text.Spanned;
+import android.text.TextUtils;
 import android.util.AttributeSet;
 import android.view.LayoutInflater;
 import android.view.MotionEvent;
@@ -34,14 +42,16 @@ import android.view.ViewGroup;
 import android.view.ViewGroup.LayoutParams;
 
 import androidx.annotation.RestrictTo;
-import androidx.collection.ArrayMap;
+import androidx.core.graphics.drawable.IconCompat;
+import androidx.core.util.ObjectsCompat;
+import androidx.recyclerview.widget.DiffUtil;
+import androidx.recyclerview.widget.ListUpdateCallback;
 import androidx.recyclerview.widget.RecyclerView;
 import androidx.slice.SliceItem;
 import androidx.slice.core.SliceQuery;
 import androidx.slice.view.R;
 
 import java.util.ArrayList;
-import java.util.Iterator;
 import java.util.List;
 
 /**
@@ -58,8 +68,8 @@ public class LargeSliceAdapter extends RecyclerView.Adapter<LargeSliceAdapter.Sl
 
     static final int HEADER_INDEX = 0;
 
-    private final IdGenerator mIdGen = new IdGenerator();
     private final Context mContext;
+    private long mNextId;
     private List<SliceWrapper> mSlices = new ArrayList<>();
     private SliceView.OnSliceActionListener mSliceObserver;
     private int mColor;
@@ -106,15 +116,60 @@ public class LargeSliceAdapter extends RecyclerView.Adapter<LargeSliceAdapter.Sl
     public void setSliceItems(List<SliceItem> slices, int color) {
         if (slices == null) {
             mSlices.clear();
-        } else {
-            mIdGen.resetUsage();
-            mSlices = new ArrayList<>(slices.size());
-            for (SliceItem s : slices) {
-                mSlices.add(new SliceWrapper(s, mIdGen));
+            mColor = color;
+            notifyDataSetChanged();
+            return;
+        }
+        final List<SliceWrapper> oldSlices = mSlices;
+        final List<SliceWrapper> newSlices = new ArrayList<>(slices.size());
+        for (SliceItem s : slices) {
+            newSlices.add(new SliceWrapper(s));
+        }
+        DiffUtil.DiffResult result = DiffUtil.calculateDiff(
+                new SliceDiffCallback(oldSlices, newSlices), false);
+        // Rows matched by the diff keep their ids, so that their views are kept. Replaying the
+        // updates on the old ids gives the id of each new row, or NO_ID for inserted rows.
+        final List<Long> ids = new ArrayList<>(oldSlices.size());
+        for (int i = 0; i < oldSlices.size(); i++) {
+            ids.add(oldSlices.get(i).mId);
+        }
+        result.dispatchUpdatesTo(new ListUpdateCallback() {
+            @Override
+            public void onInserted(int position, int count) {
+                for (int i = 0; i < count; i++) {
+                    ids.add(position, SliceWrapper.NO_ID);
+                }
+            }
+
+            @Override
+            public void onRemoved(int position, int count) {
+                ids.subList(position, position + count).clear();
             }
+
+            @Override
+            public void onMoved(int fromPosition, int toPosition) {
+                ids.add(toPosition, ids.remove(fromPosition));
+            }
+
+            @Override
+            public void onChanged(int position, int count, Object payload) {
+            }
+        });
+        for (int i = 0; i < newSlices.size(); i++) {
+            final long id = ids.get(i);
+            newSlices.get(i).mId = id != SliceWrapper.NO_ID ? id : mNextId++;
+        }
+        mSlices = newSlices;
+        if (oldSlices.isEmpty() || color != mColor) {
+            mColor = color;
+            notifyDataSetChanged();
+            return;
+        }
+        result.dispatchUpdatesTo(this);
+        if ((oldSlices.size() == 1) != (newSlices.size() == 1)) {
+            // The header is displayed differently when it is the only row.
+            notifyHeaderChanged();
         }
-        mColor = color;
-        notifyDataSetChanged();
     }
 
     /**
@@ -197,14 +252,18 @@ public class LargeSliceAdapter extends RecyclerView.Adapter<LargeSliceAdapter.Sl
     }
 
     protected static class SliceWrapper {
+        static final long NO_ID = -1;
+
         private final SliceItem mItem;
         private final int mType;
-        private final long mId;
+        private final Uri mUri;
+        long mId = NO_ID;
 
-        public SliceWrapper(SliceItem item, IdGenerator idGen) {
+        public SliceWrapper(SliceItem item) {
             mItem = item;
             mType = getFormat(item);
-            mId = idGen.getId(item);
+            mUri = FORMAT_SLICE.equals(item.getFormat()) || FORMAT_ACTION.equals(item.getFormat())
+                    ? item.getSlice().getUri() : null;
         }
 
         public static int getFormat(SliceItem item) {
@@ -280,44 +339,101 @@ public class LargeSliceAdapter extends RecyclerView.Adapter<LargeSliceAdapter.Sl
         }
     }
 
-    private static class IdGenerator {
-        private long mNextLong = 0;
-        private final ArrayMap<String, Long> mCurrentIds = new ArrayMap<>();
-        private final ArrayMap<String, Integer> mUsedIds = new ArrayMap<>();
+    /**
+     * Compares the rows of two consecutive versions of a slice. Rows are matched by the Uri of
+     * their slice, or by position for rows without one, and a matched row is only rebound if its
+     * content or its position changed, since the position is part of what a row displays and
+     * reports in its events.
+     */
+    private static class SliceDiffCallback extends DiffUtil.Callback {
+        private final List<SliceWrapper> mOldSlices;
+        private final List<SliceWrapper> mNewSlices;
+
+        SliceDiffCallback(List<SliceWrapper> oldSlices, List<SliceWrapper> newSlices) {
+            mOldSlices = oldSlices;
+            mNewSlices = newSlices;
+        }
 
-        public long getId(SliceItem item) {
-            String str = genString(item);
-            if (!mCurrentIds.containsKey(str)) {
-                mCurrentIds.put(str, mNextLong++);
-            }
-            long id = mCurrentIds.get(str);
-            Integer usedIdIndex = mUsedIds.get(str);
-            int index = usedIdIndex != null ? usedIdIndex : 0;
-            mUsedIds.put(str, index + 1);
-            return id + index * 10000;
+        @Override
+        public int getOldListSize() {
+            return mOldSlices.size();
         }
 
-        private String genString(SliceItem item) {
-            final StringBuilder builder = new StringBuilder();
-            Iterator<SliceItem> items = SliceQuery.stream(item);
-            while (items.hasNext()) {
-                SliceItem i = items.next();
-                builder.append(i.getFormat());
-                builder.append(i.getHints());
-                switch (i.getFormat()) {
-                    case FORMAT_TEXT:
-                        builder.append(i.getText());
-                        break;
-                    case FORMAT_INT:
-                        builder.append(i.getInt());
-                        break;
-                }
+        @Override
+        public int getNewListSize() {
+            return mNewSlices.size();
+        }
+
+        @Override
+        public boolean areItemsTheSame(int oldItemPosition, int newItemPosition) {
+            SliceWrapper oldSlice = mOldSlices.get(oldItemPosition);
+            SliceWrapper newSlice = mNewSlices.get(newItemPosition);
+            if (oldSlice.mType != newSlice.mType) {
+                return false;
+            }
+            if (oldSlice.mUri != null || newSlice.mUri != null) {
+                return ObjectsCompat.equals(oldSlice.mUri, newSlice.mUri);
             }
-            return builder.toString();
+            return oldItemPosition == newItemPosition;
         }
 
-        public void resetUsage() {
-            mUsedIds.clear();
+        @Override
+        public boolean areContentsTheSame(int oldItemPosition, int newItemPosition) {
+            return oldItemPosition == newItemPosition && isSameContent(
+                    mOldSlices.get(oldItemPosition).mItem, mNewSlices.get(newItemPosition).mItem);
+        }
+    }
+
+    /**
+     * Returns whether two slice items display the same content. Content that cannot be
+     * compared, such as bitmaps or styled text, is considered different.
+     */
+    static boolean isSameContent(SliceItem a, SliceItem b) {
+        if (!a.getFormat().equals(b.getFormat())
+                || !TextUtils.equals(a.getSubType(), b.getSubType())
+                || !a.getHints().equals(b.getHints())) {
+            return false;
+        }
+        switch (a.getFormat()) {
+            case FORMAT_SLICE:
+                return isSameContent(a.getSlice(), b.getSlice());
+            case FORMAT_ACTION:
+                return ObjectsCompat.equals(a.getAction(), b.getAction())
+                        && isSameContent(a.getSlice(), b.getSlice());
+            case FORMAT_TEXT:
+                return !(a.getText() instanceof Spanned) && !(b.getText() instanceof Spanned)
+                        && TextUtils.equals(a.getText(), b.getText());
+            case FORMAT_IMAGE:
+                IconCompat iconA = a.getIcon();
+                IconCompat iconB = b.getIcon();
+                return iconA.getType() == IconCompat.TYPE_RESOURCE
+                        && iconB.getType() == IconCompat.TYPE_RESOURCE
+                        && iconA.getResId() == iconB.getResId()
+                        && TextUtils.equals(iconA.getResPackage(), iconB.getResPackage());
+            case FORMAT_INT:
+                return a.getInt() == b.getInt();
+            case FORMAT_TIMESTAMP:
+            case FORMAT_LONG:
+                return a.getLong() == b.getLong();
+            default:
+                return false;
+        }
+    }
+
+    private static boolean isSameContent(androidx.slice.Slice a, androidx.slice.Slice b) {
+        if (!ObjectsCompat.equals(a.getUri(), b.getUri()) || !a.getHints().equals(b.getHints())) {
+            return false;
+        }
+        List<SliceItem> itemsA = a.getItems();
+        List<SliceItem> itemsB = b.getItems();
+        if (itemsA.size() != itemsB.size()) {
+            return false;
+        }
+        for (int i = 0; i < itemsA.size(); i++) {
+            if (!isSameContent(itemsA.get(i), itemsB.get(i))) {
+                return false;
+            }
         }
+        return true;
     }
 }
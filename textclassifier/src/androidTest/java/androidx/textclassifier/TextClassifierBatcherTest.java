@@ -0,0 +1,292 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.textclassifier;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertSame;
+import static org.junit.Assert.assertTrue;
+
+import android.os.SystemClock;
+import android.support.test.InstrumentationRegistry;
+import android.support.test.filters.MediumTest;
+import android.support.test.runner.AndroidJUnit4;
+
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
+
+import org.junit.Before;
+import org.junit.Test;
+import org.junit.runner.RunWith;
+
+import java.util.Collections;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.Executors;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+
+/** Instrumentation unit tests for {@link TextClassifierBatcher}. */
+@MediumTest
+@RunWith(AndroidJUnit4.class)
+public final class TextClassifierBatcherTest {
+
+    private static class CountingClassifier implements TextClassifierBatcher.Classifier {
+        final AtomicInteger mLinksCalls = new AtomicInteger();
+        final AtomicInteger mClassificationCalls = new AtomicInteger();
+        @Nullable
+        volatile CountDownLatch mBlockLatch;
+        @Nullable
+        volatile String mFailingText;
+
+        @NonNull
+        @Override
+        public TextLinks generateLinks(@NonNull String text,
+                @Nullable TextLinks.Options options) {
+            mLinksCalls.incrementAndGet();
+            block();
+            if (text.equals(mFailingText)) {
+                throw new IllegalStateException("Failed to generate links");
+            }
+            return new TextLinks.Builder(text)
+                    .addLink(0, text.length(),
+                            Collections.singletonMap(TextClassifier.TYPE_URL, 1f))
+                    .build();
+        }
+
+        @NonNull
+        @Override
+        public TextClassification classifyText(@NonNull String text, int startIndex,
+                int endIndex, @Nullable TextClassification.Options options) {
+            mClassificationCalls.incrementAndGet();
+            block();
+            return new TextClassification.Builder()
+                    .setText(text.substring(startIndex, endIndex))
+                    .setEntityType(TextClassifier.TYPE_EMAIL, 1f)
+                    .build();
+        }
+
+        private void block() {
+            final CountDownLatch latch = mBlockLatch;
+            if (latch != null) {
+                try {
+                    latch.await(1, TimeUnit.SECONDS);
+                } catch (InterruptedException e) {
+                    Thread.currentThread().interrupt();
+                }
+            }
+        }
+    }
+
+    private static class ResultCallback<T> implements TextClassifierBatcher.Callback<T> {
+        final CountDownLatch mLatch;
+        T mResult;
+
+        ResultCallback(CountDownLatch latch) {
+            mLatch = latch;
+        }
+
+        @Override
+        public void onResult(@NonNull T result) {
+            mResult = result;
+            mLatch.countDown();
+        }
+    }
+
+    private static class LinksCallback extends ResultCallback<TextLinks> {
+        LinksCallback(CountDownLatch latch) {
+            super(latch);
+        }
+    }
+
+    private CountingClassifier mClassifier;
+    private TextClassifierBatcher mBatcher;
+
+    @Before
+    public void setup() {
+        mClassifier = new CountingClassifier();
+        mBatcher = new TextClassifierBatcher(mClassifier,
+                Executors.newSingleThreadExecutor(), 50, 10);
+    }
+
+    @Test
+    public void testDeduplicatesRequestsOfBatch() throws InterruptedException {
+        final CountDownLatch latch = new CountDownLatch(3);
+        final CountDownLatch metricsLatch = new CountDownLatch(1);
+        final int[] metrics = new int[2];
+        mBatcher.setOnBatchMetricsListener(new TextClassifierBatcher.OnBatchMetricsListener() {
+            @Override
+            public void onBatchProcessed(int requestCount, int classifierCallCount,
+                    long maxLatencyMs, long processingTimeMs) {
+                metrics[0] = requestCount;
+                metrics[1] = classifierCallCount;
+                metricsLatch.countDown();
+            }
+        });
+        LinksCallback first = new LinksCallback(latch);
+        LinksCallback second = new LinksCallback(latch);
+        LinksCallback other = new LinksCallback(latch);
+        mBatcher.generateLinks("www.android.com", null, first);
+        mBatcher.generateLinks("www.android.com", null, second);
+        mBatcher.generateLinks("source.android.com", null, other);
+
+        assertTrue(latch.await(1, TimeUnit.SECONDS));
+        assertTrue(metricsLatch.await(1, TimeUnit.SECONDS));
+        assertEquals(2, mClassifier.mLinksCalls.get());
+        assertSame(first.mResult, second.mResult);
+        assertEquals(1, other.mResult.getLinks().size());
+        assertEquals(3, metrics[0]);
+        assertEquals(2, metrics[1]);
+    }
+
+    @Test
+    public void testReusesCachedResults() throws InterruptedException {
+        CountDownLatch latch = new CountDownLatch(1);
+        LinksCallback first = new LinksCallback(latch);
+        mBatcher.generateLinks("www.android.com", null, first);
+        assertTrue(latch.await(1, TimeUnit.SECONDS));
+
+        latch = new CountDownLatch(1);
+        LinksCallback cached = new LinksCallback(latch);
+        mBatcher.generateLinks("www.android.com", null, cached);
+        assertTrue(latch.await(1, TimeUnit.SECONDS));
+        assertSame(first.mResult, cached.mResult);
+        assertEquals(1, mClassifier.mLinksCalls.get());
+
+        // Requests with other options don't share results.
+        latch = new CountDownLatch(1);
+        mBatcher.generateLinks("www.android.com", new TextLinks.Options(),
+                new LinksCallback(latch));
+        assertTrue(latch.await(1, TimeUnit.SECONDS));
+        assertEquals(2, mClassifier.mLinksCalls.get());
+    }
+
+    @Test
+    public void testCancelledRequestsAreNotDelivered() throws InterruptedException {
+        final CountDownLatch latch = new CountDownLatch(1);
+        final LinksCallback callback = new LinksCallback(latch);
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mBatcher.generateLinks("www.android.com", null, callback).cancel();
+            }
+        });
+
+        assertFalse(latch.await(200, TimeUnit.MILLISECONDS));
+        assertEquals(0, mClassifier.mLinksCalls.get());
+
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                mBatcher.generateLinks("www.android.com", null, callback);
+                mBatcher.cancelAll();
+            }
+        });
+        assertFalse(latch.await(200, TimeUnit.MILLISECONDS));
+    }
+
+    @Test
+    public void testClassifyText() throws InterruptedException {
+        final CountDownLatch latch = new CountDownLatch(3);
+        ResultCallback<TextClassification> first = new ResultCallback<>(latch);
+        ResultCallback<TextClassification> same = new ResultCallback<>(latch);
+        ResultCallback<TextClassification> other = new ResultCallback<>(latch);
+        String text = "Mail me at test@android.com";
+        mBatcher.classifyText(text, 11, 27, null, first);
+        mBatcher.classifyText(text, 11, 27, null, same);
+        mBatcher.classifyText(text, 0, 4, null, other);
+
+        assertTrue(latch.await(1, TimeUnit.SECONDS));
+        assertEquals(2, mClassifier.mClassificationCalls.get());
+        assertEquals(0, mClassifier.mLinksCalls.get());
+        assertSame(first.mResult, same.mResult);
+        assertEquals("test@android.com", first.mResult.getText());
+        assertEquals(TextClassifier.TYPE_EMAIL, first.mResult.getEntity(0));
+        assertEquals("Mail", other.mResult.getText());
+
+        // Links and classifications of the same text don't share results.
+        final CountDownLatch linksLatch = new CountDownLatch(1);
+        mBatcher.generateLinks(text, null, new LinksCallback(linksLatch));
+        assertTrue(linksLatch.await(1, TimeUnit.SECONDS));
+        assertEquals(1, mClassifier.mLinksCalls.get());
+    }
+
+    @Test
+    public void testCancelAllReachesParallelBatches() throws InterruptedException {
+        final CountDownLatch blockLatch = new CountDownLatch(1);
+        mClassifier.mBlockLatch = blockLatch;
+        final TextClassifierBatcher batcher = new TextClassifierBatcher(mClassifier,
+                Executors.newFixedThreadPool(2), 0, 10);
+        final CountDownLatch latch = new CountDownLatch(1);
+        final LinksCallback first = new LinksCallback(latch);
+        final LinksCallback second = new LinksCallback(latch);
+        // Two batches, each blocked in the classifier on its own thread.
+        batcher.generateLinks("www.android.com", null, first);
+        waitForCalls(1);
+        batcher.generateLinks("source.android.com", null, second);
+        waitForCalls(2);
+
+        InstrumentationRegistry.getInstrumentation().runOnMainSync(new Runnable() {
+            @Override
+            public void run() {
+                batcher.cancelAll();
+            }
+        });
+        blockLatch.countDown();
+        assertFalse(latch.await(200, TimeUnit.MILLISECONDS));
+    }
+
+    @Test
+    public void testClassifierFailureOnlySkipsFailingRequest() throws InterruptedException {
+        mClassifier.mFailingText = "fail.android.com";
+        final CountDownLatch latch = new CountDownLatch(2);
+        final CountDownLatch metricsLatch = new CountDownLatch(1);
+        mBatcher.setOnBatchMetricsListener(new TextClassifierBatcher.OnBatchMetricsListener() {
+            @Override
+            public void onBatchProcessed(int requestCount, int classifierCallCount,
+                    long maxLatencyMs, long processingTimeMs) {
+                metricsLatch.countDown();
+            }
+        });
+        LinksCallback failing = new LinksCallback(latch);
+        LinksCallback identical = new LinksCallback(latch);
+        LinksCallback other = new LinksCallback(latch);
+        mBatcher.generateLinks("fail.android.com", null, failing);
+        mBatcher.generateLinks("fail.android.com", null, identical);
+        mBatcher.generateLinks("www.android.com", null, other);
+
+        assertTrue(metricsLatch.await(1, TimeUnit.SECONDS));
+        assertFalse(latch.await(200, TimeUnit.MILLISECONDS));
+        assertEquals(1, latch.getCount());
+        assertEquals(1, other.mResult.getLinks().size());
+        assertEquals(2, mClassifier.mLinksCalls.get());
+
+        // Failures aren't cached, so the request can be made again.
+        mClassifier.mFailingText = null;
+        final CountDownLatch retryLatch = new CountDownLatch(1);
+        mBatcher.generateLinks("fail.android.com", null, new LinksCallback(retryLatch));
+        assertTrue(retryLatch.await(1, TimeUnit.SECONDS));
+        assertEquals(3, mClassifier.mLinksCalls.get());
+    }
+
+    private void waitForCalls(int count) throws InterruptedException {
+        final long end = SystemClock.uptimeMillis() + 1000;
+        while (mClassifier.mLinksCalls.get() < count && SystemClock.uptimeMillis() < end) {
+            Thread.sleep(10);
+        }
+        assertEquals(count, mClassifier.mLinksCalls.get());
+    }
+}
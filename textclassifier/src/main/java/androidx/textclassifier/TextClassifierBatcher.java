@@ -0,0 +1,442 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.textclassifier;
+
+import android.os.Handler;
+import android.os.Looper;
+import android.os.SystemClock;
+import android.util.Log;
+
+import androidx.annotation.GuardedBy;
+import androidx.annotation.MainThread;
+import androidx.annotation.NonNull;
+import androidx.annotation.Nullable;
+import androidx.annotation.WorkerThread;
+import androidx.collection.ArrayMap;
+import androidx.collection.ArraySet;
+import androidx.collection.LruCache;
+import androidx.core.util.Preconditions;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.Executor;
+
+/**
+ * Runs text classification requests in batches on a background thread.
+ *
+ * <p>Requests are passed to a {@link Classifier} supplied by the app. Requests made within a
+ * short window of each other, from any thread, are run together as a single batch. Identical
+ * requests in a batch are passed to the classifier once, and results are kept in a bounded
+ * cache, so that annotating a list in which the same texts recur, such as a chat conversation,
+ * only classifies each distinct text once. Results are delivered on the main thread.
+ *
+ * <p>Requests are identical when they are of the same kind, for equal text and indices, and
+ * with the same options instance.
+ */
+public final class TextClassifierBatcher {
+
+    private static final String TAG = "TextClassifierBatcher";
+    private static final long DEFAULT_BATCH_WINDOW_MS = 16;
+    private static final int DEFAULT_CACHE_SIZE = 100;
+
+    private final Classifier mClassifier;
+    private final Executor mExecutor;
+    private final long mBatchWindowMs;
+    private final Handler mMainHandler = new Handler(Looper.getMainLooper());
+
+    private final Object mLock = new Object();
+    @GuardedBy("mLock")
+    private final LruCache<Key, Object> mCache;
+    @GuardedBy("mLock")
+    private ArrayList<Request<?>> mPending = new ArrayList<>();
+    // Batches being classified, so that cancelAll() can reach their requests. Batches may run
+    // in parallel on an executor with several threads.
+    @GuardedBy("mLock")
+    private final ArrayList<List<Request<?>>> mRunning = new ArrayList<>();
+    @GuardedBy("mLock")
+    private boolean mBatchScheduled;
+
+    @Nullable
+    private volatile OnBatchMetricsListener mMetricsListener;
+
+    private final Runnable mScheduleBatch = new Runnable() {
+        @Override
+        public void run() {
+            final ArrayList<Request<?>> batch;
+            synchronized (mLock) {
+                batch = mPending;
+                mPending = new ArrayList<>();
+                mBatchScheduled = false;
+            }
+            if (batch.isEmpty()) {
+                return;
+            }
+            mExecutor.execute(new Runnable() {
+                @Override
+                public void run() {
+                    runBatch(batch);
+                }
+            });
+        }
+    };
+
+    /**
+     * Creates a batcher that runs requests in batches of the requests made within 16
+     * milliseconds, and caches the results of 100 requests.
+     *
+     * @param classifier the classifier requests are passed to, on the executor.
+     * @param executor the executor batches run on, typically a background thread shared by the
+     *      app. Requests of a batch run one after the other.
+     */
+    public TextClassifierBatcher(@NonNull Classifier classifier, @NonNull Executor executor) {
+        this(classifier, executor, DEFAULT_BATCH_WINDOW_MS, DEFAULT_CACHE_SIZE);
+    }
+
+    /**
+     * @param classifier the classifier requests are passed to, on the executor.
+     * @param executor the executor batches run on. Requests of a batch run one after the other.
+     * @param batchWindowMs how long to wait for more requests after a request is made, before
+     *      running a batch.
+     * @param cacheSize the number of results to keep.
+     */
+    public TextClassifierBatcher(@NonNull Classifier classifier, @NonNull Executor executor,
+            long batchWindowMs, int cacheSize) {
+        Preconditions.checkArgument(batchWindowMs >= 0);
+        Preconditions.checkArgument(cacheSize > 0);
+        mClassifier = Preconditions.checkNotNull(classifier);
+        mExecutor = Preconditions.checkNotNull(executor);
+        mBatchWindowMs = batchWindowMs;
+        mCache = new LruCache<>(cacheSize);
+    }
+
+    /**
+     * Requests the {@link TextLinks} of a text.
+     *
+     * @see Classifier#generateLinks(String, TextLinks.Options)
+     * @return a request that can be cancelled.
+     */
+    @NonNull
+    public Request<TextLinks> generateLinks(@NonNull CharSequence text,
+            @Nullable TextLinks.Options options, @NonNull Callback<TextLinks> callback) {
+        return enqueue(new Request<>(TextLinks.class,
+                new Key(Key.TYPE_LINKS, text.toString(), 0, 0, options), callback));
+    }
+
+    /**
+     * Requests the {@link TextClassification} of part of a text.
+     *
+     * @see Classifier#classifyText(String, int, int, TextClassification.Options)
+     * @return a request that can be cancelled.
+     */
+    @NonNull
+    public Request<TextClassification> classifyText(@NonNull CharSequence text, int startIndex,
+            int endIndex, @Nullable TextClassification.Options options,
+            @NonNull Callback<TextClassification> callback) {
+        return enqueue(new Request<>(TextClassification.class,
+                new Key(Key.TYPE_CLASSIFICATION, text.toString(), startIndex, endIndex, options),
+                callback));
+    }
+
+    /**
+     * Cancels all requests whose result wasn't delivered yet.
+     */
+    public void cancelAll() {
+        synchronized (mLock) {
+            for (int i = 0; i < mPending.size(); i++) {
+                mPending.get(i).cancel();
+            }
+            for (int i = 0; i < mRunning.size(); i++) {
+                final List<Request<?>> batch = mRunning.get(i);
+                for (int j = 0; j < batch.size(); j++) {
+                    batch.get(j).cancel();
+                }
+            }
+            mPending.clear();
+        }
+    }
+
+    /**
+     * Sets a listener that is informed on the main thread about each batch that ran.
+     */
+    public void setOnBatchMetricsListener(@Nullable OnBatchMetricsListener listener) {
+        mMetricsListener = listener;
+    }
+
+    private <T> Request<T> enqueue(Request<T> request) {
+        synchronized (mLock) {
+            final Object cached = mCache.get(request.mKey);
+            if (cached != null) {
+                // Cached results don't wait for a batch.
+                request.setResult(cached);
+                mMainHandler.post(request);
+                return request;
+            }
+            mPending.add(request);
+            if (!mBatchScheduled) {
+                mBatchScheduled = true;
+                mMainHandler.postDelayed(mScheduleBatch, mBatchWindowMs);
+            }
+        }
+        return request;
+    }
+
+    @WorkerThread
+    void runBatch(final ArrayList<Request<?>> batch) {
+        synchronized (mLock) {
+            mRunning.add(batch);
+        }
+        final long startTime = SystemClock.uptimeMillis();
+        // Results of this batch, so that identical requests are run once even if the cache
+        // can't hold all of them.
+        final ArrayMap<Key, Object> results = new ArrayMap<>();
+        // Requests the classifier failed on, which are skipped along with identical ones.
+        final ArraySet<Key> failed = new ArraySet<>();
+        int classifierCalls = 0;
+        long maxLatencyMs = 0;
+        try {
+            for (int i = 0; i < batch.size(); i++) {
+                final Request<?> request = batch.get(i);
+                if (request.isCancelled() || failed.contains(request.mKey)) {
+                    continue;
+                }
+                Object result = results.get(request.mKey);
+                if (result == null) {
+                    synchronized (mLock) {
+                        result = mCache.get(request.mKey);
+                    }
+                }
+                if (result == null) {
+                    classifierCalls++;
+                    try {
+                        result = request.mKey.classify(mClassifier);
+                    } catch (RuntimeException e) {
+                        Log.w(TAG, "Classifier failed, skipping request", e);
+                    }
+                    if (result == null) {
+                        failed.add(request.mKey);
+                        continue;
+                    }
+                    synchronized (mLock) {
+                        mCache.put(request.mKey, result);
+                    }
+                }
+                results.put(request.mKey, result);
+                request.setResult(result);
+                maxLatencyMs = Math.max(maxLatencyMs,
+                        SystemClock.uptimeMillis() - request.mRequestTime);
+            }
+        } finally {
+            synchronized (mLock) {
+                for (int i = mRunning.size() - 1; i >= 0; i--) {
+                    if (mRunning.get(i) == batch) {
+                        mRunning.remove(i);
+                        break;
+                    }
+                }
+            }
+            postResults(batch, classifierCalls, maxLatencyMs,
+                    SystemClock.uptimeMillis() - startTime);
+        }
+    }
+
+    private void postResults(final ArrayList<Request<?>> batch, final int classifierCalls,
+            final long maxLatencyMs, final long processingTimeMs) {
+        final int requestCount = batch.size();
+        mMainHandler.post(new Runnable() {
+            @Override
+            public void run() {
+                for (int i = 0; i < requestCount; i++) {
+                    batch.get(i).run();
+                }
+                final OnBatchMetricsListener listener = mMetricsListener;
+                if (listener != null) {
+                    listener.onBatchProcessed(requestCount, classifierCalls, maxLatencyMs,
+                            processingTimeMs);
+                }
+            }
+        });
+    }
+
+    /**
+     * Classifies the text of the requests made to a {@link TextClassifierBatcher}. Its methods
+     * are called on the executor of the batcher, and may block.
+     */
+    public interface Classifier {
+        /**
+         * Generates the {@link TextLinks} that annotate the given text with links.
+         *
+         * @param text the text to generate annotations for
+         * @param options configuration for link generation
+         */
+        @WorkerThread
+        @NonNull
+        TextLinks generateLinks(@NonNull String text, @Nullable TextLinks.Options options);
+
+        /**
+         * Classifies the part of the given text from {@code startIndex} to {@code endIndex}.
+         *
+         * @param text text providing context for the classified text
+         * @param startIndex start index of the text to classify
+         * @param endIndex end index of the text to classify
+         * @param options optional input parameters
+         */
+        @WorkerThread
+        @NonNull
+        TextClassification classifyText(@NonNull String text, int startIndex, int endIndex,
+                @Nullable TextClassification.Options options);
+    }
+
+    /**
+     * Receives the result of a request.
+     *
+     * @param <T> the type of the result.
+     */
+    public interface Callback<T> {
+        /**
+         * Called on the main thread with the result of a request that wasn't cancelled. Not
+         * called if the classifier threw an exception or returned null for the request.
+         */
+        @MainThread
+        void onResult(@NonNull T result);
+    }
+
+    /**
+     * Receives metrics about the batches run by a {@link TextClassifierBatcher}.
+     */
+    public interface OnBatchMetricsListener {
+        /**
+         * Called on the main thread after the results of a batch were delivered.
+         *
+         * @param requestCount the number of requests in the batch, including cancelled ones.
+         * @param classifierCallCount the number of requests passed to the classifier. The
+         *      others were cancelled, identical to another request or cached.
+         * @param maxLatencyMs the longest time between a request being made and its result
+         *      being ready.
+         * @param processingTimeMs the time spent running the batch.
+         */
+        void onBatchProcessed(int requestCount, int classifierCallCount, long maxLatencyMs,
+                long processingTimeMs);
+    }
+
+    /**
+     * A request made to a {@link TextClassifierBatcher}.
+     *
+     * @param <T> the type of the result.
+     */
+    public static final class Request<T> implements Runnable {
+        final Class<T> mKind;
+        final Key mKey;
+        final long mRequestTime = SystemClock.uptimeMillis();
+        private final Callback<T> mCallback;
+        private volatile boolean mCancelled;
+        @Nullable
+        private volatile T mResult;
+
+        Request(Class<T> kind, Key key, Callback<T> callback) {
+            mKind = kind;
+            mKey = key;
+            mCallback = Preconditions.checkNotNull(callback);
+        }
+
+        /**
+         * Cancels this request. When called on the main thread, the callback is guaranteed not
+         * to be called afterwards.
+         */
+        public void cancel() {
+            mCancelled = true;
+        }
+
+        /**
+         * @return whether this request was cancelled.
+         */
+        public boolean isCancelled() {
+            return mCancelled;
+        }
+
+        void setResult(Object result) {
+            mResult = mKind.cast(result);
+        }
+
+        // Delivers the result on the main thread.
+        @Override
+        public void run() {
+            final T result = mResult;
+            if (!mCancelled && result != null) {
+                mCallback.onResult(result);
+            }
+        }
+    }
+
+    /**
+     * Identifies the requests that share a result. Options are compared by identity, as they
+     * don't implement equals.
+     */
+    private static final class Key {
+        static final int TYPE_LINKS = 0;
+        static final int TYPE_CLASSIFICATION = 1;
+
+        final int mType;
+        final String mText;
+        final int mStartIndex;
+        final int mEndIndex;
+        @Nullable
+        final Object mOptions;
+
+        Key(int type, String text, int startIndex, int endIndex, @Nullable Object options) {
+            mType = type;
+            mText = text;
+            mStartIndex = startIndex;
+            mEndIndex = endIndex;
+            mOptions = options;
+        }
+
+        @WorkerThread
+        Object classify(Classifier classifier) {
+            if (mType == TYPE_LINKS) {
+                return classifier.generateLinks(mText, (TextLinks.Options) mOptions);
+            }
+            return classifier.classifyText(mText, mStartIndex, mEndIndex,
+                    (TextClassification.Options) mOptions);
+        }
+
+        @Override
+        public boolean equals(Object o) {
+            if (this == o) {
+                return true;
+            }
+            if (!(o instanceof Key)) {
+                return false;
+            }
+            Key other = (Key) o;
+            return mType == other.mType
+                    && mStartIndex == other.mStartIndex
+                    && mEndIndex == other.mEndIndex
+                    && mOptions == other.mOptions
+                    && mText.equals(other.mText);
+        }
+
+        @Override
+        public int hashCode() {
+            int result = mType;
+            result = 31 * result + mText.hashCode();
+            result = 31 * result + mStartIndex;
+            result = 31 * result + mEndIndex;
+            result = 31 * result + System.identityHashCode(mOptions);
+            return result;
+        }
+    }
+}
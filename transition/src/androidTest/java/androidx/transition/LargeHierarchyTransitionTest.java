@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package androidx.transition;
+
+import static org.hamcrest.CoreMatchers.is;
+import static org.hamcrest.MatcherAssert.assertThat;
+
+import android.os.Debug;
+import android.os.SystemClock;
+import android.support.test.filters.LargeTest;
+import android.util.Log;
+import android.view.View;
+import android.widget.FrameLayout;
+
+import org.junit.Test;
+
+/**
+ * Measures the time and allocations needed to capture and match values for a transition over
+ * a large view hierarchy.
+ */
+@LargeTest
+public class LargeHierarchyTransitionTest extends BaseTest {
+    private static final String TAG = "LargeHierarchyTransition";
+    private static final int VIEW_COUNT = 500;
+    private static final int ITERATIONS = 10;
+
+    @Test
+    public void benchmarkCaptureAndMatch() throws Throwable {
+        rule.runOnUiThread(new Runnable() {
+            @Override
+            public void run() {
+                FrameLayout sceneRoot = new FrameLayout(rule.getActivity());
+                rule.getActivity().getRoot().addView(sceneRoot);
+                View[] views = new View[VIEW_COUNT];
+                for (int i = 0; i < VIEW_COUNT; i++) {
+                    views[i] = new View(rule.getActivity());
+                    views[i].setId(i + 1);
+                    sceneRoot.addView(views[i], new FrameLayout.LayoutParams(10, 10));
+                    views[i].layout(0, i, 10, i + 10);
+                }
+
+                long totalTime = 0;
+                int totalAllocations = 0;
+                for (int iteration = 0; iteration < ITERATIONS; iteration++) {
+                    TransitionSet transition = new TransitionSet()
+                            .addTransition(new ChangeBounds())
+                            .addTransition(new Fade());
+                    Debug.startAllocCounting();
+                    int allocationsBefore = Debug.getThreadAllocCount();
+                    long start = SystemClock.elapsedRealtimeNanos();
+
+                    transition.captureValues(sceneRoot, true);
+                    for (int i = 0; i < VIEW_COUNT; i++) {
+                        views[i].layout(i, 0, i + 10, 10);
+                    }
+                    transition.captureValues(sceneRoot, false);
+                    transition.playTransition(sceneRoot);
+
+                    totalTime += SystemClock.elapsedRealtimeNanos() - start;
+                    totalAllocations += Debug.getThreadAllocCount() - allocationsBefore;
+                    Debug.stopAllocCounting();
+
+                    assertThat(transition.getTransitionValues(views[0], true).view,
+                            is(views[0]));
+                    transition.cancel();
+                    for (int i = 0; i < VIEW_COUNT; i++) {
+                        views[i].layout(0, i, 10, i + 10);
+                    }
+                }
+                Log.i(TAG, VIEW_COUNT + " views: " + totalTime / ITERATIONS / 1000
+                        + "us and " + totalAllocations / ITERATIONS
+                        + " allocations per capture and match");
+                rule.getActivity().getRoot().removeView(sceneRoot);
+            }
+        });
+    }
+}
@@ -536,15 +536,19 @@ public abstract class Transition implements Cloneable {
     /**
      * Match start/end values by View instance. Adds matched values to mStartValuesList
      * and mEndValuesList and removes them from unmatchedStart and unmatchedEnd.
+     *
+     * <p>Values are removed from the unmatched maps by clearing their entry rather than removing
+     * the key, so that matching many views does not repeatedly shift the maps' arrays. Cleared
+     * entries are skipped by the other match passes and by {@link #addUnmatched}.</p>
      */
     private void matchInstances(ArrayMap<View, TransitionValues> unmatchedStart,
             ArrayMap<View, TransitionValues> unmatchedEnd) {
         for (int i = unmatchedStart.size() - 1; i >= 0; i--) {
             View view = unmatchedStart.keyAt(i);
-            if (view != null && isValidTarget(view)) {
-                TransitionValues end = unmatchedEnd.remove(view);
+            if (view != null && unmatchedStart.valueAt(i) != null && isValidTarget(view)) {
+                TransitionValues end = removeUnmatched(unmatchedEnd, view);
                 if (end != null && end.view != null && isValidTarget(end.view)) {
-                    TransitionValues start = unmatchedStart.removeAt(i);
+                    TransitionValues start = unmatchedStart.setValueAt(i, null);
                     mStartValuesList.add(start);
                     mEndValuesList.add(end);
                 }
@@ -552,6 +556,17 @@ public abstract class Transition implements Cloneable {
         }
     }
 
+    /**
+     * Clears the entry of the given view in a map of unmatched values.
+     *
+     * @return the values that were stored for the view, or null if there were none.
+     */
+    private static TransitionValues removeUnmatched(ArrayMap<View, TransitionValues> unmatched,
+            View view) {
+        int index = unmatched.indexOfKey(view);
+        return index >= 0 ? unmatched.setValueAt(index, null) : null;
+    }
+
     /**
      * Match start/end values by Adapter item ID. Adds matched values to mStartValuesList
      * and mEndValuesList and removes them from unmatchedStart and unmatchedEnd, using
@@ -571,8 +586,8 @@ public abstract class Transition implements Cloneable {
                     if (startValues != null && endValues != null) {
                         mStartValuesList.add(startValues);
                         mEndValuesList.add(endValues);
-                        unmatchedStart.remove(startView);
-                        unmatchedEnd.remove(endView);
+                        removeUnmatched(unmatchedStart, startView);
+                        removeUnmatched(unmatchedEnd, endView);
                     }
                 }
             }
@@ -598,8 +613,8 @@ public abstract class Transition implements Cloneable {
                     if (startValues != null && endValues != null) {
                         mStartValuesList.add(startValues);
                         mEndValuesList.add(endValues);
-                        unmatchedStart.remove(startView);
-                        unmatchedEnd.remove(endView);
+                        removeUnmatched(unmatchedStart, startView);
+                        removeUnmatched(unmatchedEnd, endView);
                     }
                 }
             }
@@ -625,8 +640,8 @@ public abstract class Transition implements Cloneable {
                     if (startValues != null && endValues != null) {
                         mStartValuesList.add(startValues);
                         mEndValuesList.add(endValues);
-                        unmatchedStart.remove(startView);
-                        unmatchedEnd.remove(endView);
+                        removeUnmatched(unmatchedStart, startView);
+                        removeUnmatched(unmatchedEnd, endView);
                     }
                 }
             }
@@ -642,7 +657,7 @@ public abstract class Transition implements Cloneable {
         // Views that only exist in the start Scene
         for (int i = 0; i < unmatchedStart.size(); i++) {
             final TransitionValues start = unmatchedStart.valueAt(i);
-            if (isValidTarget(start.view)) {
+            if (start != null && isValidTarget(start.view)) {
                 mStartValuesList.add(start);
                 mEndValuesList.add(null);
             }
@@ -651,7 +666,7 @@ public abstract class Transition implements Cloneable {
         // Views that only exist in the end Scene
         for (int i = 0; i < unmatchedEnd.size(); i++) {
             final TransitionValues end = unmatchedEnd.valueAt(i);
-            if (isValidTarget(end.view)) {
+            if (end != null && isValidTarget(end.view)) {
                 mEndValuesList.add(end);
                 mStartValuesList.add(null);
             }
@@ -685,6 +700,26 @@ public abstract class Transition implements Cloneable {
         addUnmatched(unmatchedStart, unmatchedEnd);
     }
 
+    private static ArrayMap<View, ArrayList<AnimationInfo>> indexByView(
+            ArrayMap<Animator, AnimationInfo> runningAnimators) {
+        ArrayMap<View, ArrayList<AnimationInfo>> index = new ArrayMap<>();
+        int numRunningAnimators = runningAnimators.size();
+        for (int i = 0; i < numRunningAnimators; i++) {
+            addToIndex(index, runningAnimators.valueAt(i));
+        }
+        return index;
+    }
+
+    private static void addToIndex(ArrayMap<View, ArrayList<AnimationInfo>> index,
+            AnimationInfo info) {
+        ArrayList<AnimationInfo> infos = index.get(info.mView);
+        if (infos == null) {
+            infos = new ArrayList<>(1);
+            index.put(info.mView, infos);
+        }
+        infos.add(info);
+    }
+
     /**
      * This method, essentially a wrapper around all calls to createAnimator for all
      * possible target views, is called with the entire set of start/end
@@ -704,6 +739,9 @@ public abstract class Transition implements Cloneable {
             Log.d(LOG_TAG, "createAnimators() for " + this);
         }
         ArrayMap<Animator, AnimationInfo> runningAnimators = getRunningAnimators();
+        // Running animations indexed by view, built on first use so that checking each new
+        // animator against the running ones does not scan all of them.
+        ArrayMap<View, ArrayList<AnimationInfo>> runningInfosByView = null;
         long minStartDelay = Long.MAX_VALUE;
         SparseIntArray startDelays = new SparseIntArray();
         int startValuesListCount = startValuesList.size();
@@ -758,12 +796,15 @@ public abstract class Transition implements Cloneable {
                                             newValues.values.get(properties[j]));
                                 }
                             }
-                            int numExistingAnims = runningAnimators.size();
+                            if (runningInfosByView == null && !runningAnimators.isEmpty()) {
+                                runningInfosByView = indexByView(runningAnimators);
+                            }
+                            ArrayList<AnimationInfo> viewInfos = runningInfosByView == null
+                                    ? null : runningInfosByView.get(view);
+                            int numExistingAnims = viewInfos == null ? 0 : viewInfos.size();
                             for (int j = 0; j < numExistingAnims; ++j) {
-                                Animator anim = runningAnimators.keyAt(j);
-                                AnimationInfo info = runningAnimators.get(anim);
-                                if (info.mValues != null && info.mView == view
-                                        && info.mName.equals(getName())) {
+                                AnimationInfo info = viewInfos.get(j);
+                                if (info.mValues != null && info.mName.equals(getName())) {
                                     if (info.mValues.equals(infoValues)) {
                                         // Favor the old animator
                                         animator = null;
@@ -784,6 +825,9 @@ public abstract class Transition implements Cloneable {
                         AnimationInfo info = new AnimationInfo(view, getName(), this,
                                 ViewUtils.getWindowId(sceneRoot), infoValues);
                         runningAnimators.put(animator, info);
+                        if (runningInfosByView != null) {
+                            addToIndex(runningInfosByView, info);
+                        }
                         mAnimators.add(animator);
                     }
                 }